@@ -28,6 +28,59 @@ namespace psu {
 static const uint8_t ADC_REG2_VAL = 0B01100000; // Register 02h: External Vref, 50Hz rejection, PSW off, IDAC off
 static const uint8_t ADC_REG3_VAL = 0B00000000; // Register 03h: IDAC1 disabled, IDAC2 disabled, dedicated DRDY
 
+static const uint8_t ADC_REG1_CONTINUOUS_MODE = 0B00000100; // Register 01h: [2] CM = 1
+
+static const uint16_t DATA_RATE_TO_SPS[] = { 20, 45, 90, 175, 330, 600, 1000 };
+
+// Prevents compiler from reordering sample buffer writes and index update.
+#ifdef __GNUC__
+#define ADC_SAMPLE_BUFFER_BARRIER() __asm__ __volatile__("" ::: "memory")
+#else
+#define ADC_SAMPLE_BUFFER_BARRIER()
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+AdcSampleBuffer::AdcSampleBuffer() : head(0), tail(0) {
+}
+
+void AdcSampleBuffer::reset() {
+    head = 0;
+    tail = 0;
+}
+
+bool AdcSampleBuffer::push(uint8_t reg0, int16_t data, uint32_t tick_usec) {
+    uint8_t next = (head + 1) & (SIZE - 1);
+    if (next == tail) {
+        return false;
+    }
+
+    AdcSample &sample = samples[head];
+    sample.reg0 = reg0;
+    sample.data = data;
+    sample.tick_usec = tick_usec;
+
+    ADC_SAMPLE_BUFFER_BARRIER();
+    head = next;
+
+    return true;
+}
+
+bool AdcSampleBuffer::pop(AdcSample &sample) {
+    uint8_t current = tail;
+    if (current == head) {
+        return false;
+    }
+
+    ADC_SAMPLE_BUFFER_BARRIER();
+    sample = samples[current];
+
+    ADC_SAMPLE_BUFFER_BARRIER();
+    tail = (current + 1) & (SIZE - 1);
+
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 #if ADC_USE_INTERRUPTS
@@ -42,15 +95,40 @@ static void adc_interrupt_ch2() {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-AnalogDigitalConverter::AnalogDigitalConverter(Channel &channel_) : channel(channel_) {
+AnalogDigitalConverter::AnalogDigitalConverter(Channel &channel_)
+    : channel(channel_)
+    , continuous_mode(false)
+    , data_rate(ADC_SPS)
+    , conversion_running(false)
+{
     g_testResult = psu::TEST_SKIPPED;
 }
 
 uint8_t AnalogDigitalConverter::getReg1Val() {
-    return (ADC_SPS << 5) | 0B00000000;
+    return (data_rate << 5) | (continuous_mode ? ADC_REG1_CONTINUOUS_MODE : 0B00000000);
+}
+
+uint16_t AnalogDigitalConverter::getDataRateSps(uint8_t data_rate) {
+    return DATA_RATE_TO_SPS[data_rate];
+}
+
+uint8_t AnalogDigitalConverter::getDataRateFromSps(float sps) {
+    for (uint8_t i = ADC_DATA_RATE_MIN; i < ADC_DATA_RATE_MAX; ++i) {
+        if (sps <= DATA_RATE_TO_SPS[i]) {
+            return i;
+        }
+    }
+    return ADC_DATA_RATE_MAX;
+}
+
+uint32_t AnalogDigitalConverter::getConversionTimeUs() {
+    // 12.5% margin for the ADC internal oscillator tolerance and SPI overhead
+    return (1000000UL + 1000000UL / 8) / getDataRateSps(data_rate);
 }
 
 void AnalogDigitalConverter::init() {
+    sample_buffer.reset();
+
 #if ADC_USE_INTERRUPTS
     int intNum = digitalPinToInterrupt(channel.convend_pin);
     SPI_usingInterrupt(intNum);
@@ -68,6 +146,7 @@ void AnalogDigitalConverter::init() {
     // Send RESET command
     SPI.transfer(ADC_RESET);
     delayMicroseconds(100); // Guard time
+    conversion_running = false;
 
     SPI.transfer(ADC_WR3S1);
 
@@ -180,17 +259,19 @@ void AnalogDigitalConverter::tick(uint32_t tick_usec) {
 #else
     if (start_reg0) {
         if (!digitalRead(channel.convend_pin)) {
-            int16_t adc_data = read();
-            channel.eventAdcData(adc_data);
-#if CONF_DEBUG
-            debug::g_adcCounter.inc();
-#endif
+            onConversionEnd();
         }
     }
 #endif
 }
 
 void AnalogDigitalConverter::start(uint8_t reg0) {
+    if (continuous_mode && conversion_running && reg0 == start_reg0) {
+        // ADC already started next conversion of the same input
+        start_time = micros();
+        return;
+    }
+
     start_reg0 = reg0;
 
     if (start_reg0) {
@@ -206,17 +287,56 @@ void AnalogDigitalConverter::start(uint8_t reg0) {
         SPI.transfer(start_reg0);
 #endif
 
-        // Start conversion (single shot)
-        SPI.transfer(ADC_START);
+        // In continuous conversion mode, register write restarts conversion
+        // so START is required only once.
+        if (!conversion_running) {
+            // Start conversion
+            SPI.transfer(ADC_START);
+            conversion_running = continuous_mode;
+        }
 
         digitalWrite(channel.adc_pin, HIGH);
         digitalWrite(channel.isolator_pin, ISOLATOR_DISABLE);
         SPI_endTransaction();
 
         start_time = micros();
+    } else if (conversion_running) {
+        // Stop continuous conversion
+        SPI_beginTransaction(ADS1120_SPI);
+        digitalWrite(channel.isolator_pin, ISOLATOR_ENABLE);
+        digitalWrite(channel.adc_pin, LOW);
+
+        SPI.transfer(ADC_POWERDOWN);
+
+        digitalWrite(channel.adc_pin, HIGH);
+        digitalWrite(channel.isolator_pin, ISOLATOR_DISABLE);
+        SPI_endTransaction();
+
+        conversion_running = false;
     }
 }
 
+void AnalogDigitalConverter::setConversionMode(bool continuous, uint8_t data_rate_) {
+    continuous_mode = continuous;
+    data_rate = data_rate_;
+
+    start_reg0 = 0;
+    conversion_running = false;
+
+    SPI_beginTransaction(ADS1120_SPI);
+    digitalWrite(channel.isolator_pin, ISOLATOR_ENABLE);
+    digitalWrite(channel.adc_pin, LOW);
+
+    // Stop conversion in progress and update conversion mode and data rate
+    SPI.transfer(ADC_POWERDOWN);
+    SPI.transfer(ADC_WR1S1);
+    SPI.transfer(getReg1Val());
+
+    digitalWrite(channel.adc_pin, HIGH);
+    digitalWrite(channel.isolator_pin, ISOLATOR_DISABLE);
+    SPI_endTransaction();
+}
+
 int16_t AnalogDigitalConverter::read() {
     SPI_beginTransaction(ADS1120_SPI);
     digitalWrite(channel.isolator_pin, ISOLATOR_ENABLE);
@@ -234,17 +354,34 @@ int16_t AnalogDigitalConverter::read() {
     return (int16_t)((dmsb << 8) | dlsb);
 }
 
-#if ADC_USE_INTERRUPTS
-void AnalogDigitalConverter::onInterrupt() {
-    g_insideInterruptHandler = true;
-
+/// Keep this as short as possible: it can run inside interrupt handler, so
+/// only raw data is queued here and everything else is done by the main loop.
+void AnalogDigitalConverter::onConversionEnd() {
+    uint8_t reg0 = start_reg0;
     int16_t adc_data = read();
-    channel.eventAdcData(adc_data);
+    uint32_t tick_usec = micros();
+
+#if CONF_FAST_TRIP_PROTECTION
+    channel.fastTripCheck(reg0, adc_data, tick_usec);
+#endif
+
+    if (!sample_buffer.push(reg0, adc_data, tick_usec)) {
+#if CONF_DEBUG
+        debug::g_adcOverflowCounter.inc();
+#endif
+    }
+
+    start(channel.getAdcNextStartReg0(reg0));
 
 #if CONF_DEBUG
     debug::g_adcCounter.inc();
 #endif
+}
 
+#if ADC_USE_INTERRUPTS
+void AnalogDigitalConverter::onInterrupt() {
+    g_insideInterruptHandler = true;
+    onConversionEnd();
     g_insideInterruptHandler = false;
 }
 #endif
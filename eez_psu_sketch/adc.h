@@ -21,6 +21,41 @@
 namespace eez {
 namespace psu {
 
+/// Raw ADC conversion result, captured by the ADC conversion handler.
+struct AdcSample {
+    /// Value of ADC register 0 used for this conversion (selects U_MON, I_MON, U_SET or I_SET).
+    uint8_t reg0;
+    /// Raw ADC data.
+    int16_t data;
+    /// Time (micros) when conversion data was read.
+    uint32_t tick_usec;
+};
+
+/// Lock-free single producer/single consumer queue of raw ADC samples.
+/// Producer is ADC conversion handler (interrupt routine or DRDY polling),
+/// consumer is the main loop (see Channel::consumeAdcSamples).
+class AdcSampleBuffer {
+public:
+    /// Must be power of 2.
+    static const uint8_t SIZE = ADC_SAMPLE_BUFFER_SIZE;
+
+    AdcSampleBuffer();
+
+    /// Discard all samples. Call only when producer is not active.
+    void reset();
+
+    /// Called by the producer. Returns false, and drops the sample, if buffer is full.
+    bool push(uint8_t reg0, int16_t data, uint32_t tick_usec);
+
+    /// Called by the consumer. Returns false if buffer is empty.
+    bool pop(AdcSample &sample);
+
+private:
+    AdcSample samples[SIZE];
+    volatile uint8_t head;
+    volatile uint8_t tail;
+};
+
 /// Analog to digital converter HW used by the channel.
 class AnalogDigitalConverter {
 public:
@@ -30,10 +65,12 @@ public:
     static const uint8_t ADC_RESET = 0B00000110;
     static const uint8_t ADC_RDATA = 0B00010000;
     static const uint8_t ADC_START = 0B00001000;
+    static const uint8_t ADC_POWERDOWN = 0B00000010;
 
     static const uint8_t ADC_WR3S1 = 0B01000110;
     static const uint8_t ADC_RD3S1 = 0B00100110;
     static const uint8_t ADC_WR1S0 = 0B01000000;
+    static const uint8_t ADC_WR1S1 = 0B01000100;
     static const uint8_t ADC_WR4S0 = 0B01000011;
 
     static const uint8_t ADC_REG0_READ_U_MON = 0x91; // B10010001: [7:4] AINP = AIN1, AINN = AVSS, [3:1] Gain = 1, [0] PGA disabled and bypassed
@@ -42,9 +79,15 @@ public:
     static const uint8_t ADC_REG0_READ_U_SET = 0x81; // B10000001: [7:4] AINP = AIN0, AINN = AVSS, [3:1] Gain = 1, [0] PGA disabled and bypassed
     static const uint8_t ADC_REG0_READ_I_SET = 0xB1; // B10110001: [7:4] AINP = AIN3, AINN = AVSS, [3:1] Gain = 1, [0] PGA disabled and bypassed
 
+    static const uint8_t ADC_DATA_RATE_MIN = 0;
+    static const uint8_t ADC_DATA_RATE_MAX = 6;
+
     psu::TestResult g_testResult;
     uint8_t start_reg0;
 
+    /// Raw samples waiting to be processed by the main loop.
+    AdcSampleBuffer sample_buffer;
+
     AnalogDigitalConverter(Channel &channel);
 
     void init();
@@ -55,6 +98,20 @@ public:
     void start(uint8_t reg0);
     int16_t read();
 
+    /// Select single shot or continuous conversion mode and data rate (0: 20 SPS ... 6: 1000 SPS).
+    /// Conversion in progress is stopped, so caller should start it again.
+    void setConversionMode(bool continuous, uint8_t data_rate);
+    bool isContinuousConversionMode() { return continuous_mode; }
+    uint8_t getDataRate() { return data_rate; }
+
+    /// Returns number of samples per second for the given data rate code.
+    static uint16_t getDataRateSps(uint8_t data_rate);
+    /// Returns data rate code of the lowest data rate greater or equal to the given number of samples per second.
+    static uint8_t getDataRateFromSps(float sps);
+    /// Returns time in microseconds, with some margin, that a single conversion
+    /// takes at the currently selected data rate.
+    uint32_t getConversionTimeUs();
+
 #if ADC_USE_INTERRUPTS
     void onInterrupt();
 #endif
@@ -63,8 +120,14 @@ private:
     Channel &channel;
     uint32_t start_time;
     uint8_t adc_timeout_recovery_attempts_counter;
+    bool continuous_mode;
+    uint8_t data_rate;
+    /// Is continuous conversion started (with START command)?
+    bool conversion_running;
 
     uint8_t getReg1Val();
+
+    void onConversionEnd();
 };
 
 }
@@ -76,7 +76,7 @@ float Value::getDacValue() {
 }
 
 float Value::getAdcValue() {
-    return voltOrCurr ? g_channel->u.mon_last : g_channel->i.mon_last;
+    return voltOrCurr ? g_channel->u.getMonLast() : g_channel->i.getMonLast();
 }
 
 void Value::setLevel(int8_t value) { 
@@ -415,6 +415,8 @@ bool save() {
         }
     }
 
+    g_channel->updateAdcDataConversions();
+
     resetChannelToZero();
 
     return persist_conf::saveChannelCalibration(*g_channel);
@@ -41,6 +41,9 @@
 #include "list.h"
 #include "trigger.h"
 #include "io_pins.h"
+#if OPTION_SD_CARD
+#include "dlog.h"
+#endif
 
 namespace eez {
 namespace psu {
@@ -98,9 +101,9 @@ void Channel::Value::init(float set_, float step_, float limit_) {
 
 void Channel::Value::resetMonValues() {
     mon_adc = 0;
-    mon = 0;
-    mon_last = 0;
-    mon_dac = 0;
+    mon_micro = 0;
+    mon_last_micro = 0;
+    mon_dac_micro = 0;
 
     mon_index = -1;
     mon_dac_index = -1;
@@ -108,41 +111,45 @@ void Channel::Value::resetMonValues() {
     mon_measured = false;
 }
 
-void Channel::Value::addMonValue(float value) {
-    mon_last = value;
+void Channel::Value::addMonValue(int32_t value_micro) {
+    mon_last_micro = value_micro;
 
     if (mon_index == -1) {
         mon_index = 0;
         for (int i = 0; i < NUM_ADC_AVERAGING_VALUES; ++i) {
-            mon_arr[i] = value;
+            mon_arr[i] = value_micro;
         }
-        mon_total = NUM_ADC_AVERAGING_VALUES * value;
-        mon = value;
+        mon_total = NUM_ADC_AVERAGING_VALUES * value_micro;
+        mon_micro = value_micro;
     } else {
-        mon_total -= mon_arr[mon_index]; 
-        mon_total += value;
-        mon_arr[mon_index] = value;
-        mon_index = (mon_index + 1) % NUM_ADC_AVERAGING_VALUES;
-        mon = mon_total / NUM_ADC_AVERAGING_VALUES;
+        mon_total -= mon_arr[mon_index];
+        mon_total += value_micro;
+        mon_arr[mon_index] = value_micro;
+        if (++mon_index == NUM_ADC_AVERAGING_VALUES) {
+            mon_index = 0;
+        }
+        mon_micro = mon_total / NUM_ADC_AVERAGING_VALUES;
     }
 
     mon_measured = true;
 }
 
-void Channel::Value::addMonDacValue(float value) {
+void Channel::Value::addMonDacValue(int32_t value_micro) {
     if (mon_dac_index == -1) {
         mon_dac_index = 0;
         for (int i = 0; i < NUM_ADC_AVERAGING_VALUES; ++i) {
-            mon_dac_arr[i] = value;
+            mon_dac_arr[i] = value_micro;
         }
-        mon_dac_total = NUM_ADC_AVERAGING_VALUES * value;
-        mon_dac = value;
+        mon_dac_total = NUM_ADC_AVERAGING_VALUES * value_micro;
+        mon_dac_micro = value_micro;
     } else {
-        mon_dac_total -= mon_dac_arr[mon_dac_index]; 
-        mon_dac_total += value;
-        mon_dac_arr[mon_dac_index] = value;
-        mon_dac_index = (mon_dac_index + 1) % NUM_ADC_AVERAGING_VALUES;
-        mon_dac = mon_dac_total / NUM_ADC_AVERAGING_VALUES;
+        mon_dac_total -= mon_dac_arr[mon_dac_index];
+        mon_dac_total += value_micro;
+        mon_dac_arr[mon_dac_index] = value_micro;
+        if (++mon_dac_index == NUM_ADC_AVERAGING_VALUES) {
+            mon_dac_index = 0;
+        }
+        mon_dac_micro = mon_dac_total / NUM_ADC_AVERAGING_VALUES;
     }
 }
 
@@ -281,6 +288,15 @@ float Channel::Simulator::getVoltProgExt() {
     return voltProgExt;
 }
 
+float Channel::simulatorAdcDataToVoltage(int16_t adc_data) {
+    // GND offset is 0 in the simulator, uSetConversion[1] is built without it
+    return uSetConversion[1].toMicroUnits(adc_data) * 1E-6f;
+}
+
+float Channel::simulatorAdcDataToCurrent(int16_t adc_data) {
+    return iSetConversion[flags.currentCurrentRange].toMicroUnits(adc_data) * 1E-6f;
+}
+
 #endif
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -345,6 +361,22 @@ Channel::Channel(
     uBeforeBalancing = NAN;
     iBeforeBalancing = NAN;
 
+    // force protection thresholds calculation on the first check
+    ovp.level = NAN;
+    ocp.level = NAN;
+    opp.level = NAN;
+
+#if CONF_FAST_TRIP_PROTECTION
+    ovp.fast_trip_enabled = false;
+    ovp.fast_trip_pending = false;
+    ovp.fast_trip_count = 0;
+    ovp.fast_trip_conversion = 0;
+    ocp.fast_trip_enabled = false;
+    ocp.fast_trip_pending = false;
+    ocp.fast_trip_count = 0;
+    ocp.fast_trip_conversion = 0;
+#endif
+
     flags.currentCurrentRange = CURRENT_RANGE_HIGH;
     flags.currentRangeSelectionMode = CURRENT_RANGE_SELECTION_USE_BOTH;
     flags.autoSelectCurrentRange = 1;
@@ -355,14 +387,36 @@ Channel::Channel(
 
     autoRangeCheckLastTickCount = 0;
 
+    adcSetReadbackCounter = 0;
+
+    resetMeasurementBuffer();
+    historyStore.reset();
+
     flags.cvMode = 0;
     flags.ccMode = 0;
     updateCcAndCvSwitch();
 }
 
 void Channel::protectionEnter(ProtectionValue &cpv) {
+#if CONF_FAST_TRIP_PROTECTION
+    // cleared before the output is turned off, so executeOutputEnable doesn't enter it again
+    bool fastTripped = cpv.fast_trip_pending;
+    cpv.fast_trip_pending = false;
+#endif
+
     channel_dispatcher::outputEnable(*this, false);
 
+#if CONF_FAST_TRIP_PROTECTION
+    if (fastTripped) {
+        // output is already turned off and latency measured by the fast trip
+        cpv.flags.fast_tripped = 1;
+    } else
+#endif
+    {
+        cpv.trip_latency = micros() - adcSampleTick;
+        cpv.flags.fast_tripped = 0;
+    }
+
     cpv.flags.tripped = 1;
 
     int bit_mask = reg_get_ques_isum_bit_mask_for_channel_protection_value(this, cpv);
@@ -386,35 +440,101 @@ void Channel::protectionEnter(ProtectionValue &cpv) {
     onProtectionTripped();
 }
 
+
+/// Measured values are compared in micro units with the threshold which is
+/// calculated only when protection level is changed.
+void Channel::updateProtectionThreshold(ProtectionValue &cpv) {
+    const AdcDataConversion *conversion = 0;
+
+    if (IS_OVP_VALUE(this, cpv)) {
+        float level = channel_dispatcher::getUProtectionLevel(*this);
+        if (level != cpv.level) {
+            cpv.level = level;
+            cpv.threshold = util::greaterOrEqualThresholdMicro(level, getPrecision(VALUE_TYPE_FLOAT_VOLT));
+        }
+        conversion = &uMonConversion[isVoltageCalibrationEnabled() ? 1 : 0];
+    } else if (IS_OCP_VALUE(this, cpv)) {
+        float level = channel_dispatcher::getISet(*this);
+        if (level != cpv.level) {
+            cpv.level = level;
+            cpv.threshold = util::greaterOrEqualThresholdMicro(level, getPrecision(VALUE_TYPE_FLOAT_AMPER));
+        }
+        conversion = &iMonConversion[flags.currentCurrentRange][isCurrentCalibrationEnabled() ? 1 : 0];
+    } else {
+        float level = channel_dispatcher::getPowerProtectionLevel(*this);
+        if (level != cpv.level) {
+            cpv.level = level;
+            // power in uV * uA
+            cpv.threshold = (int64_t)floor(level * 1E12);
+        }
+    }
+
+#if CONF_FAST_TRIP_PROTECTION
+    if (conversion) {
+        int64_t threshold = cpv.threshold;
+        if (conversion != cpv.fast_trip_conversion || threshold != cpv.fast_trip_threshold) {
+            // new data is written at once, so fast trip, if enabled, is never
+            // checked against the threshold for the old protection level
+            int16_t data;
+            cpv.fast_trip_possible = conversion->findAdcData(threshold, data) &&
+                data <= 32767 - CONF_FAST_TRIP_HYSTERESIS;
+            if (cpv.fast_trip_possible) {
+                cpv.fast_trip_data = data + CONF_FAST_TRIP_HYSTERESIS;
+                cpv.fast_trip_count = 0;
+            } else {
+                cpv.fast_trip_enabled = false;
+            }
+            cpv.fast_trip_conversion = conversion;
+            cpv.fast_trip_threshold = threshold;
+        }
+    }
+#endif
+}
+
 void Channel::protectionCheck(ProtectionValue &cpv) {
     bool state;
     bool condition;
     float delay;
-    
+
+#if CONF_FAST_TRIP_PROTECTION
+    if (cpv.fast_trip_pending) {
+        protectionEnter(cpv);
+        return;
+    }
+#endif
+
+    updateProtectionThreshold(cpv);
+
     if (IS_OVP_VALUE(this, cpv)) {
         state = flags.rprogEnabled || prot_conf.flags.u_state;
-        //condition = flags.cv_mode && (!flags.cc_mode || fabs(i.mon_last - i.set) >= CHANNEL_VALUE_PRECISION) && (prot_conf.u_level <= u.set);
-        condition = util::greaterOrEqual(channel_dispatcher::getUMon(*this), channel_dispatcher::getUProtectionLevel(*this), getPrecision(VALUE_TYPE_FLOAT_VOLT))
-            || flags.rprogEnabled && util::greaterOrEqual(channel_dispatcher::getUMonDac(*this), channel_dispatcher::getUProtectionLevel(*this), getPrecision(VALUE_TYPE_FLOAT_VOLT));
+        //condition = flags.cv_mode && (!flags.cc_mode || fabs(i.getMonLast() - i.set) >= CHANNEL_VALUE_PRECISION) && (prot_conf.u_level <= u.set);
+        condition = channel_dispatcher::getUMonMicro(*this) >= cpv.threshold
+            || flags.rprogEnabled && channel_dispatcher::getUMonDacMicro(*this) >= cpv.threshold;
         delay = prot_conf.u_delay;
         delay -= PROT_DELAY_CORRECTION;
     }
     else if (IS_OCP_VALUE(this, cpv)) {
         state = prot_conf.flags.i_state;
-        //condition = flags.cc_mode && (!flags.cv_mode || fabs(u.mon_last - u.set) >= CHANNEL_VALUE_PRECISION);
-        condition = util::greaterOrEqual(
-            channel_dispatcher::getIMon(*this),
-            channel_dispatcher::getISet(*this),
-            getPrecision(VALUE_TYPE_FLOAT_AMPER));
+        //condition = flags.cc_mode && (!flags.cv_mode || fabs(u.getMonLast() - u.set) >= CHANNEL_VALUE_PRECISION);
+        condition = channel_dispatcher::getIMonMicro(*this) >= cpv.threshold;
         delay = prot_conf.i_delay;
         delay -= PROT_DELAY_CORRECTION;
     }
     else {
         state = prot_conf.flags.p_state;
-        condition = channel_dispatcher::getUMon(*this) * channel_dispatcher::getIMon(*this) > channel_dispatcher::getPowerProtectionLevel(*this);
+        condition = (int64_t)channel_dispatcher::getUMonMicro(*this) * channel_dispatcher::getIMonMicro(*this) > cpv.threshold;
         delay = prot_conf.p_delay;
     }
 
+#if CONF_FAST_TRIP_PROTECTION
+    if (!IS_OPP_VALUE(this, cpv)) {
+        cpv.fast_trip_enabled = state && delay <= 0 && cpv.fast_trip_possible && isOutputEnabled() && !channel_dispatcher::isCoupled();
+        if (!cpv.fast_trip_enabled) {
+            cpv.fast_trip_count = 0;
+        }
+    }
+#endif
+
     if (state && isOutputEnabled() && condition) {
         if (delay > 0) {
             if (cpv.flags.alarmed) {
@@ -422,10 +542,10 @@ void Channel::protectionCheck(ProtectionValue &cpv) {
                     cpv.flags.alarmed = 0;
 
                     //if (IS_OVP_VALUE(this, cpv)) {
-                    //    DebugTraceF("OVP condition: CV_MODE=%d, CC_MODE=%d, I DIFF=%d mA, I MON=%d mA", (int)flags.cvMode, (int)flags.ccMode, (int)(fabs(i.mon_last - i.set) * 1000), (int)(i.mon_last * 1000));
+                    //    DebugTraceF("OVP condition: CV_MODE=%d, CC_MODE=%d, I DIFF=%d mA, I MON=%d mA", (int)flags.cvMode, (int)flags.ccMode, (int)(fabs(i.getMonLast() - i.set) * 1000), (int)(i.getMonLast() * 1000));
                     //}
                     //else if (IS_OCP_VALUE(this, cpv)) {
-                    //    DebugTraceF("OCP condition: CC_MODE=%d, CV_MODE=%d, U DIFF=%d mV", (int)flags.ccMode, (int)flags.cvMode, (int)(fabs(u.mon_last - u.set) * 1000));
+                    //    DebugTraceF("OCP condition: CC_MODE=%d, CV_MODE=%d, U DIFF=%d mV", (int)flags.ccMode, (int)flags.cvMode, (int)(fabs(u.getMonLast() - u.set) * 1000));
                     //}
 
                     protectionEnter(cpv);
@@ -438,10 +558,10 @@ void Channel::protectionCheck(ProtectionValue &cpv) {
         }
         else {
             //if (IS_OVP_VALUE(this, cpv)) {
-            //    DebugTraceF("OVP condition: CV_MODE=%d, CC_MODE=%d, I DIFF=%d mA", (int)flags.cvMode, (int)flags.ccMode, (int)(fabs(i.mon_last - i.set) * 1000));
+            //    DebugTraceF("OVP condition: CV_MODE=%d, CC_MODE=%d, I DIFF=%d mA", (int)flags.cvMode, (int)flags.ccMode, (int)(fabs(i.getMonLast() - i.set) * 1000));
             //}
             //else if (IS_OCP_VALUE(this, cpv)) {
-            //    DebugTraceF("OCP condition: CC_MODE=%d, CV_MODE=%d, U DIFF=%d mV", (int)flags.ccMode, (int)flags.cvMode, (int)(fabs(u.mon_last - u.set) * 1000));
+            //    DebugTraceF("OCP condition: CC_MODE=%d, CV_MODE=%d, U DIFF=%d mV", (int)flags.ccMode, (int)flags.cvMode, (int)(fabs(u.getMonLast() - u.set) * 1000));
             //}
 
             protectionEnter(cpv);
@@ -503,6 +623,12 @@ void Channel::reset() {
     flags.currentRangeSelectionMode = CURRENT_RANGE_SELECTION_USE_BOTH;
     flags.autoSelectCurrentRange = 1;
 
+    // SENS:ACQ:MODE NORM
+    // SENS:ACQ:RATE DEF
+    if (adc.isContinuousConversionMode() || adc.getDataRate() != ADC_SPS) {
+        doSetAcquisition(ACQUISITION_MODE_NORMAL, ADC_SPS);
+    }
+
     // CAL:STAT ON if valid calibrating data for both voltage and current exists in the nonvolatile memory, otherwise OFF.
     doCalibrationEnable(isCalibrationExists());
 
@@ -565,6 +691,91 @@ void Channel::reset() {
 
 void Channel::resetHistory() {
     historyPosition = -1;
+    uHistoryAccumulator.reset();
+    iHistoryAccumulator.reset();
+}
+
+void Channel::addHistoryValue(int position) {
+    float uPrec = getPrecisionFromNumSignificantDecimalDigits(VOLTAGE_NUM_SIGNIFICANT_DECIMAL_DIGITS);
+    float iPrec = getPrecisionFromNumSignificantDecimalDigits(CURRENT_NUM_SIGNIFICANT_DECIMAL_DIGITS);
+
+    uHistory[position] = util::roundPrec(u.getMonLast(), uPrec);
+    iHistory[position] = util::roundPrec(i.getMonLast(), iPrec);
+
+    // last value is added so min/max are defined even if there were no samples (output is off)
+    uHistoryAccumulator.add(u.mon_last_micro);
+    iHistoryAccumulator.add(i.mon_last_micro);
+
+    uHistoryMin[position] = util::roundPrec(uHistoryAccumulator.min * 1E-6f, uPrec);
+    uHistoryMax[position] = util::roundPrec(uHistoryAccumulator.max * 1E-6f, uPrec);
+    iHistoryMin[position] = util::roundPrec(iHistoryAccumulator.min * 1E-6f, iPrec);
+    iHistoryMax[position] = util::roundPrec(iHistoryAccumulator.max * 1E-6f, iPrec);
+
+    uHistoryAccumulator.reset();
+    iHistoryAccumulator.reset();
+}
+
+float Channel::getUMonHistory(int position, history::ValueKind kind) const {
+    if (kind == history::VALUE_KIND_MIN) {
+        return uHistoryMin[position];
+    }
+    if (kind == history::VALUE_KIND_MAX) {
+        return uHistoryMax[position];
+    }
+    return uHistory[position];
+}
+
+float Channel::getIMonHistory(int position, history::ValueKind kind) const {
+    if (kind == history::VALUE_KIND_MIN) {
+        return iHistoryMin[position];
+    }
+    if (kind == history::VALUE_KIND_MAX) {
+        return iHistoryMax[position];
+    }
+    return iHistory[position];
+}
+
+void Channel::resetMeasurementBuffer() {
+    measurementBufferPosition = 0;
+    measurementBufferCount = 0;
+}
+
+void Channel::addMeasurementBufferValue(int32_t uMon, int32_t iMon) {
+    uMeasurementBuffer[measurementBufferPosition] = uMon;
+    iMeasurementBuffer[measurementBufferPosition] = iMon;
+
+    if (++measurementBufferPosition == CHANNEL_MEASUREMENT_BUFFER_SIZE) {
+        measurementBufferPosition = 0;
+    }
+
+    if (measurementBufferCount < CHANNEL_MEASUREMENT_BUFFER_SIZE) {
+        ++measurementBufferCount;
+    }
+}
+
+int Channel::getMeasurementBufferValues(float *uMon, float *iMon, int count) {
+    if (count > measurementBufferCount) {
+        count = measurementBufferCount;
+    }
+
+    int position = measurementBufferPosition - count;
+    if (position < 0) {
+        position += CHANNEL_MEASUREMENT_BUFFER_SIZE;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        if (uMon) {
+            uMon[i] = uMeasurementBuffer[position] * 1E-6f;
+        }
+        if (iMon) {
+            iMon[i] = iMeasurementBuffer[position] * 1E-6f;
+        }
+        if (++position == CHANNEL_MEASUREMENT_BUFFER_SIZE) {
+            position = 0;
+        }
+    }
+
+    return count;
 }
 
 void Channel::clearCalibrationConf() {
@@ -592,6 +803,105 @@ void Channel::clearCalibrationConf() {
 
     strcpy(cal_conf.calibration_date, "");
     strcpy(cal_conf.calibration_remark, CALIBRATION_REMARK_INIT);
+
+    updateAdcDataConversions();
+}
+
+/// ADC data is remapped from [ADC_MIN, ADC_MAX] to [minValue, maxValue] and GND offset is subtracted.
+/// If calValueConf is given, the result is then corrected by the line through the calibration points,
+/// one segment from min to mid and one from mid to max. If mid point is not between min and max
+/// only min and max points are used.
+void Channel::AdcDataConversion::build(float minValue, float maxValue, float gndOffset,
+    const CalibrationValueConfiguration *calValueConf)
+{
+    // uncalibrated value = p * adc_data + q
+    double p = ((double)maxValue - minValue) / (AnalogDigitalConverter::ADC_MAX - AnalogDigitalConverter::ADC_MIN);
+    double q = minValue - AnalogDigitalConverter::ADC_MIN * p - gndOffset;
+
+    const Channel::CalibrationValuePointConfiguration *points[3];
+    int numPoints = 0;
+    if (calValueConf) {
+        if (calValueConf->min.adc < calValueConf->mid.adc && calValueConf->mid.adc < calValueConf->max.adc) {
+            points[numPoints++] = &calValueConf->min;
+            points[numPoints++] = &calValueConf->mid;
+            points[numPoints++] = &calValueConf->max;
+        } else if (calValueConf->min.adc != calValueConf->max.adc) {
+            points[numPoints++] = &calValueConf->min;
+            points[numPoints++] = &calValueConf->max;
+        }
+    }
+
+    segmentStart = 0;
+    if (numPoints == 3) {
+        // ADC data of the mid point
+        segmentStart = (int16_t)util::clamp((float)floor((points[1]->adc - q) / p + 0.5), -32768.0f, 32767.0f);
+    }
+
+    for (int i = 0; i < 2; ++i) {
+        // calibrated value = s * uncalibrated value + t
+        double s = 1;
+        double t = 0;
+        if (numPoints > 0) {
+            const Channel::CalibrationValuePointConfiguration *p1 = points[numPoints == 3 ? i : 0];
+            const Channel::CalibrationValuePointConfiguration *p2 = points[numPoints == 3 ? i + 1 : 1];
+            s = ((double)p2->val - p1->val) / ((double)p2->adc - p1->adc);
+            t = p1->val - s * p1->adc;
+        }
+
+        slope[i] = (int32_t)floor(s * p * 1E6 * 65536 + 0.5);
+        offset[i] = (int32_t)floor((s * q + t) * 1E6 + 0.5);
+    }
+}
+
+bool Channel::AdcDataConversion::findAdcData(int64_t threshold, int16_t &adc_data) const {
+    if (slope[0] <= 0 || slope[1] <= 0) {
+        // not monotonic
+        return false;
+    }
+
+    if (toMicroUnits(32767) < threshold) {
+        return false;
+    }
+
+    int32_t low = -32768;
+    int32_t high = 32767;
+    while (low < high) {
+        int32_t mid = (low + high) >> 1;
+        if (toMicroUnits((int16_t)mid) >= threshold) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+
+    adc_data = (int16_t)low;
+    return true;
+}
+
+void Channel::updateAdcDataConversions() {
+#ifdef EEZ_PSU_SIMULATOR
+    float voltageGndOffset = 0;
+    float currentGndOffset = 0;
+#else
+    float voltageGndOffset = VOLTAGE_GND_OFFSET;
+    float currentGndOffset = CURRENT_GND_OFFSET;
+#endif
+
+    uMonConversion[0].build(U_MIN, U_MAX_CONF, voltageGndOffset, 0);
+    uMonConversion[1].build(U_MIN, U_MAX_CONF, voltageGndOffset, &cal_conf.u);
+
+    uSetConversion[0].build(U_MIN, U_MAX_CONF, voltageGndOffset, 0);
+    uSetConversion[1].build(U_MIN, U_MAX_CONF, 0, 0);
+
+    for (int range = 0; range < 2; ++range) {
+        float iMax = range == CURRENT_RANGE_LOW ? I_MAX / 10 : I_MAX;
+        float gndOffset = range == CURRENT_RANGE_LOW ? currentGndOffset / 10 : currentGndOffset;
+
+        iMonConversion[range][0].build(I_MIN, iMax, gndOffset, 0);
+        iMonConversion[range][1].build(I_MIN, iMax, gndOffset, &cal_conf.i[range]);
+
+        iSetConversion[range].build(I_MIN, iMax, gndOffset, 0);
+    }
 }
 
 void Channel::clearProtectionConf() {
@@ -655,19 +965,19 @@ bool Channel::isOk() {
 }
 
 void Channel::voltageBalancing() {
-    //DebugTraceF("Channel voltage balancing: CH1_Umon=%f, CH2_Umon=%f", Channel::get(0).u.mon_last, Channel::get(1).u.mon_last);
+    //DebugTraceF("Channel voltage balancing: CH1_Umon=%f, CH2_Umon=%f", Channel::get(0).u.getMonLast(), Channel::get(1).u.getMonLast());
     if (util::isNaN(uBeforeBalancing)) {
         uBeforeBalancing = u.set;
     }
-    doSetVoltage((Channel::get(0).u.mon_last + Channel::get(1).u.mon_last) / 2);
+    doSetVoltage((Channel::get(0).u.getMonLast() + Channel::get(1).u.getMonLast()) / 2);
 }
 
 void Channel::currentBalancing() {
-    //DebugTraceF("CH%d channel current balancing: CH1_Imon=%f, CH2_Imon=%f", index, Channel::get(0).i.mon_last, Channel::get(1).i.mon_last);
+    //DebugTraceF("CH%d channel current balancing: CH1_Imon=%f, CH2_Imon=%f", index, Channel::get(0).i.getMonLast(), Channel::get(1).i.getMonLast());
     if (util::isNaN(iBeforeBalancing)) {
         iBeforeBalancing = i.set;
     }
-    doSetCurrent((Channel::get(0).i.mon_last + Channel::get(1).i.mon_last) / 2);
+    doSetCurrent((Channel::get(0).i.getMonLast() + Channel::get(1).i.getMonLast()) / 2);
 }
 
 void Channel::restoreVoltageToValueBeforeBalancing() {
@@ -697,6 +1007,7 @@ void Channel::tick(uint32_t tick_usec) {
 
     ioexp.tick(tick_usec);
     adc.tick(tick_usec);
+    consumeAdcSamples();
     onTimeCounter.tick(tick_usec);
 
     if (getFeatures() & CH_FEATURE_LRIPPLE) {
@@ -714,17 +1025,17 @@ void Channel::tick(uint32_t tick_usec) {
     /// and that condition lasts more then DP_NEG_DELAY seconds (default 5 s),
     /// down-programmer circuit has to be switched off.
     if (isOutputEnabled()) {
-        if (u.mon_last * i.mon_last >= DP_NEG_LEV || tick_usec < dpNegMonitoringTime) {
+        if (u.getMonLast() * i.getMonLast() >= DP_NEG_LEV || tick_usec < dpNegMonitoringTime) {
             dpNegMonitoringTime = tick_usec;
         } else {
             if (tick_usec - dpNegMonitoringTime > DP_NEG_DELAY * 1000000UL) {
                 if (flags.dpOn) {
-                    DebugTraceF("CH%d, neg. P, DP off: %f", index, u.mon_last * i.mon_last);
+                    DebugTraceF("CH%d, neg. P, DP off: %f", index, u.getMonLast() * i.getMonLast());
                     dpNegMonitoringTime = tick_usec;
                     psu::generateError(SCPI_ERROR_CH1_DOWN_PROGRAMMER_SWITCHED_OFF + (index - 1));
                     doDpEnable(false);
                 } else {
-                    DebugTraceF("CH%d, neg. P, output off: %f", index, u.mon_last * i.mon_last);
+                    DebugTraceF("CH%d, neg. P, output off: %f", index, u.getMonLast() * i.getMonLast());
                     psu::generateError(SCPI_ERROR_CH1_OUTPUT_FAULT_DETECTED - (index - 1));
                     channel_dispatcher::outputEnable(*this, false);
                 }
@@ -752,11 +1063,14 @@ void Channel::tick(uint32_t tick_usec) {
 #endif
 
     if (historyPosition == -1) {
-        uHistory[0] = util::roundPrec(u.mon_last, getPrecisionFromNumSignificantDecimalDigits(VOLTAGE_NUM_SIGNIFICANT_DECIMAL_DIGITS));
-        iHistory[0] = util::roundPrec(i.mon_last, getPrecisionFromNumSignificantDecimalDigits(CURRENT_NUM_SIGNIFICANT_DECIMAL_DIGITS));
+        addHistoryValue(0);
         for (int i = 1; i < CHANNEL_HISTORY_SIZE; ++i) {
             uHistory[i] = 0;
             iHistory[i] = 0;
+            uHistoryMin[i] = 0;
+            uHistoryMax[i] = 0;
+            iHistoryMin[i] = 0;
+            iHistoryMax[i] = 0;
         }
             
         historyPosition = 1;
@@ -765,9 +1079,8 @@ void Channel::tick(uint32_t tick_usec) {
         uint32_t ytViewRateMicroseconds = (int)round(ytViewRate * 1000000L); 
 
         while (tick_usec - historyLastTick >= ytViewRateMicroseconds) {
-            uHistory[historyPosition] = util::roundPrec(u.mon_last, getPrecisionFromNumSignificantDecimalDigits(VOLTAGE_NUM_SIGNIFICANT_DECIMAL_DIGITS));
-            iHistory[historyPosition] = util::roundPrec(i.mon_last, getPrecisionFromNumSignificantDecimalDigits(CURRENT_NUM_SIGNIFICANT_DECIMAL_DIGITS));
-                
+            addHistoryValue(historyPosition);
+
             if (++historyPosition == CHANNEL_HISTORY_SIZE) {
                 historyPosition = 0;
             }
@@ -776,15 +1089,9 @@ void Channel::tick(uint32_t tick_usec) {
         }
     }
 
-    doAutoSelectCurrentRange(tick_usec);
-}
-
-float Channel::remapAdcDataToVoltage(int16_t adc_data) {
-    return util::remap((float)adc_data, (float)AnalogDigitalConverter::ADC_MIN, U_MIN, (float)AnalogDigitalConverter::ADC_MAX, U_MAX_CONF);
-}
+    historyStore.tick(tick_usec);
 
-float Channel::remapAdcDataToCurrent(int16_t adc_data) {
-    return util::remap((float)adc_data, (float)AnalogDigitalConverter::ADC_MIN, I_MIN, (float)AnalogDigitalConverter::ADC_MAX, getDualRangeMax());
+    doAutoSelectCurrentRange(tick_usec);
 }
 
 int16_t Channel::remapVoltageToAdcData(float value) {
@@ -797,10 +1104,45 @@ int16_t Channel::remapCurrentToAdcData(float value) {
     return (int16_t)util::clamp(adc_value, (float)(-AnalogDigitalConverter::ADC_MAX - 1), (float)AnalogDigitalConverter::ADC_MAX);
 }
 
-void Channel::adcDataIsReady(int16_t data, bool startAgain) {
-    uint8_t nextStartReg0 = 0;
+uint8_t Channel::getAdcNextStartReg0(uint8_t reg0) {
+    switch (reg0) {
+    case AnalogDigitalConverter::ADC_REG0_READ_U_MON:
+        return AnalogDigitalConverter::ADC_REG0_READ_I_MON;
 
-    switch (adc.start_reg0) {
+    case AnalogDigitalConverter::ADC_REG0_READ_I_MON:
+        if (isOutputEnabled()) {
+            if (!isRemoteProgrammingEnabled()) {
+                return AnalogDigitalConverter::ADC_REG0_READ_U_MON;
+            }
+
+            if (adc.isContinuousConversionMode()) {
+                // U_SET readback is needed for remote programming, but not as often as U_MON and I_MON
+                if (++adcSetReadbackCounter < ADC_CONTINUOUS_SET_READBACK_PERIOD) {
+                    return AnalogDigitalConverter::ADC_REG0_READ_U_MON;
+                }
+                adcSetReadbackCounter = 0;
+            }
+        }
+        return AnalogDigitalConverter::ADC_REG0_READ_U_SET;
+
+    case AnalogDigitalConverter::ADC_REG0_READ_U_SET:
+        if (isOutputEnabled() && isRemoteProgrammingEnabled()) {
+            return AnalogDigitalConverter::ADC_REG0_READ_U_MON;
+        }
+        return AnalogDigitalConverter::ADC_REG0_READ_I_SET;
+
+    case AnalogDigitalConverter::ADC_REG0_READ_I_SET:
+        if (isOutputEnabled()) {
+            return AnalogDigitalConverter::ADC_REG0_READ_U_MON;
+        }
+        return 0;
+    }
+
+    return 0;
+}
+
+void Channel::adcDataIsReady(uint8_t reg0, int16_t data) {
+    switch (reg0) {
 
     case AnalogDigitalConverter::ADC_REG0_READ_U_MON:
     {
@@ -819,27 +1161,7 @@ void Channel::adcDataIsReady(int16_t data, bool startAgain) {
         //}
         u.mon_adc = data;
 
-        float value;
-        if (isVoltageCalibrationEnabled()) {
-
-            value = remapAdcDataToVoltage(data);
-
-#if !defined(EEZ_PSU_SIMULATOR)
-            value -= VOLTAGE_GND_OFFSET;
-#endif
-
-            value = util::remap(value, cal_conf.u.min.adc, cal_conf.u.min.val, cal_conf.u.max.adc, cal_conf.u.max.val);
-        } else {
-            value = remapAdcDataToVoltage(data);
-
-#if !defined(EEZ_PSU_SIMULATOR)
-            value -= VOLTAGE_GND_OFFSET;
-#endif
-        }
-
-        u.addMonValue(value);
-
-        nextStartReg0 = AnalogDigitalConverter::ADC_REG0_READ_I_MON;
+        u.addMonValue(uMonConversion[isVoltageCalibrationEnabled() ? 1 : 0].toMicroUnits(data));
     }
     break;
 
@@ -854,31 +1176,17 @@ void Channel::adcDataIsReady(int16_t data, bool startAgain) {
         //}
         i.mon_adc = data;
 
-        float value = remapAdcDataToCurrent(data) - getDualRangeGndOffset();
-
-        if (isCurrentCalibrationEnabled()) {
-            value = util::remap(value,
-                cal_conf.i[flags.currentCurrentRange].min.adc,
-                cal_conf.i[flags.currentCurrentRange].min.val,
-                cal_conf.i[flags.currentCurrentRange].max.adc,
-                cal_conf.i[flags.currentCurrentRange].max.val);
-        }
-
-        i.addMonValue(value);
+        i.addMonValue(iMonConversion[flags.currentCurrentRange][isCurrentCalibrationEnabled() ? 1 : 0].toMicroUnits(data));
 
         if (isOutputEnabled()) {
-            if (isRemoteProgrammingEnabled()) {
-                nextStartReg0 = AnalogDigitalConverter::ADC_REG0_READ_U_SET;
-            }
-            else {
-                nextStartReg0 = AnalogDigitalConverter::ADC_REG0_READ_U_MON;
-            }
-        }
-        else {
+            addMeasurementBufferValue(u.mon_last_micro, i.mon_last_micro);
+
+            uHistoryAccumulator.add(u.mon_last_micro);
+            iHistoryAccumulator.add(i.mon_last_micro);
+            historyStore.addSample(u.mon_last_micro, i.mon_last_micro);
+        } else {
             u.resetMonValues();
             i.resetMonValues();
-
-            nextStartReg0 = AnalogDigitalConverter::ADC_REG0_READ_U_SET;
         }
     }
     break;
@@ -889,13 +1197,7 @@ void Channel::adcDataIsReady(int16_t data, bool startAgain) {
         debug::g_uMonDac[index - 1].set(data);
 #endif
 
-        float value = remapAdcDataToVoltage(data);
-
-#if !defined(EEZ_PSU_SIMULATOR)
-        if (!flags.rprogEnabled) {
-            value -= VOLTAGE_GND_OFFSET;
-        }
-#endif
+        int32_t value = uSetConversion[flags.rprogEnabled ? 1 : 0].toMicroUnits(data);
 
         //if (isVoltageCalibrationEnabled()) {
         //    u.mon_dac = util::remap(value, cal_conf.u.min.adc, cal_conf.u.min.val, cal_conf.u.max.adc, cal_conf.u.max.val);
@@ -904,13 +1206,6 @@ void Channel::adcDataIsReady(int16_t data, bool startAgain) {
         //}
 
         u.addMonDacValue(value);
-
-        if (isOutputEnabled() && isRemoteProgrammingEnabled()) {
-            nextStartReg0 = AnalogDigitalConverter::ADC_REG0_READ_U_MON;
-        }
-        else {
-            nextStartReg0 = AnalogDigitalConverter::ADC_REG0_READ_I_SET;
-        }
     }
     break;
 
@@ -920,7 +1215,7 @@ void Channel::adcDataIsReady(int16_t data, bool startAgain) {
         debug::g_iMonDac[index - 1].set(data);
 #endif
 
-        float value = remapAdcDataToCurrent(data) - getDualRangeGndOffset();
+        int32_t value = iSetConversion[flags.currentCurrentRange].toMicroUnits(data);
 
         //if (isCurrentCalibrationEnabled()) {
         //    i.mon_dac = util::remap(value,
@@ -933,17 +1228,9 @@ void Channel::adcDataIsReady(int16_t data, bool startAgain) {
         //}
 
         i.addMonDacValue(value);
-
-        if (isOutputEnabled()) {
-            nextStartReg0 = AnalogDigitalConverter::ADC_REG0_READ_U_MON;
-        }
     }
     break;
     }
-
-    if (startAgain) {
-        adc.start(nextStartReg0);
-    }
 }
 
 void Channel::updateCcAndCvSwitch() {
@@ -997,11 +1284,51 @@ void Channel::protectionCheck() {
     protectionCheck(opp);
 }
 
-void Channel::eventAdcData(int16_t adc_data, bool startAgain) {
+#if CONF_FAST_TRIP_PROTECTION
+void Channel::fastTripCheck(uint8_t reg0, int16_t adc_data, uint32_t tick_usec) {
+    ProtectionValue *cpv;
+    uint8_t numSamples;
+    if (reg0 == AnalogDigitalConverter::ADC_REG0_READ_U_MON) {
+        cpv = &ovp;
+        numSamples = CONF_FAST_TRIP_OVP_NUM_SAMPLES;
+    } else if (reg0 == AnalogDigitalConverter::ADC_REG0_READ_I_MON) {
+        cpv = &ocp;
+        numSamples = CONF_FAST_TRIP_OCP_NUM_SAMPLES;
+    } else {
+        return;
+    }
+
+    if (cpv->fast_trip_enabled && cpv->fastTripSample(adc_data, numSamples)) {
+        cpv->fast_trip_enabled = false;
+        // If this interrupts IO expander update in the main loop, output enable bit
+        // could be written back, but then it is turned off again by protectionEnter.
+        ioexp.changeBit(IOExpander::IO_BIT_OUT_OUTPUT_ENABLE, false);
+        cpv->trip_latency = micros() - tick_usec;
+        cpv->fast_trip_pending = true;
+    }
+}
+#endif
+
+void Channel::eventAdcData(const AdcSample &sample) {
     if (!psu::isPowerUp()) return;
 
-    adcDataIsReady(adc_data, startAgain);
+    adcSampleTick = sample.tick_usec;
+
+    adcDataIsReady(sample.reg0, sample.data);
     protectionCheck();
+
+#if OPTION_SD_CARD
+    if (sample.reg0 == AnalogDigitalConverter::ADC_REG0_READ_I_MON && isOutputEnabled()) {
+        dlog::adcData(*this, sample.tick_usec);
+    }
+#endif
+}
+
+void Channel::consumeAdcSamples() {
+    AdcSample sample;
+    while (adc.sample_buffer.pop(sample)) {
+        eventAdcData(sample);
+    }
 }
 
 void Channel::eventGpio(uint8_t gpio) {
@@ -1033,10 +1360,22 @@ void Channel::eventGpio(uint8_t gpio) {
     }
 }
 
+#if ADC_USE_INTERRUPTS
+/// Wait for ADC interrupts to finish some conversions. Samples are consumed while
+/// waiting, so sample buffer doesn't overflow and the last samples are not lost.
+void Channel::adcDelay(uint32_t ms) {
+    uint32_t start = millis();
+    do {
+        delay(1);
+        consumeAdcSamples();
+    } while (millis() - start < ms);
+}
+#endif
+
 void Channel::adcReadMonDac() {
 #if ADC_USE_INTERRUPTS
     adc.start(AnalogDigitalConverter::ADC_REG0_READ_U_SET);
-    delay(ADC_TIMEOUT_MS * 2);
+    adcDelay(ADC_TIMEOUT_MS * 2);
 #else
     adc.start(AnalogDigitalConverter::ADC_REG0_READ_U_SET);
     delay(ADC_TIMEOUT_MS);
@@ -1044,13 +1383,14 @@ void Channel::adcReadMonDac() {
     delay(ADC_TIMEOUT_MS);
     adc.tick(micros());
 #endif
+    consumeAdcSamples();
 }
 
 void Channel::adcReadAll() {
     if (isOutputEnabled()) {
 #if ADC_USE_INTERRUPTS
         adc.start(AnalogDigitalConverter::ADC_REG0_READ_U_SET);
-        delay(ADC_TIMEOUT_MS * 3);
+        adcDelay(ADC_TIMEOUT_MS * 3);
 #else
         adc.start(AnalogDigitalConverter::ADC_REG0_READ_U_SET);
         delay(ADC_TIMEOUT_MS);
@@ -1065,7 +1405,7 @@ void Channel::adcReadAll() {
     } else {
 #if ADC_USE_INTERRUPTS
         adc.start(AnalogDigitalConverter::ADC_REG0_READ_U_MON);
-        delay(ADC_TIMEOUT_MS * 4);
+        adcDelay(ADC_TIMEOUT_MS * 4);
 #else
         adc.start(AnalogDigitalConverter::ADC_REG0_READ_U_MON);
         delay(ADC_TIMEOUT_MS);
@@ -1078,6 +1418,8 @@ void Channel::adcReadAll() {
         adc.tick(micros());
 #endif
     }
+
+    consumeAdcSamples();
 }
 
 void Channel::doDpEnable(bool enable) {
@@ -1091,6 +1433,17 @@ void Channel::doDpEnable(bool enable) {
 }
 
 void Channel::executeOutputEnable(bool enable) {
+#if CONF_FAST_TRIP_PROTECTION
+    if (!enable) {
+        ovp.fast_trip_enabled = false;
+        ocp.fast_trip_enabled = false;
+    } else {
+        // trip from the previous output on period is already handled when output was turned off
+        ovp.fast_trip_pending = false;
+        ocp.fast_trip_pending = false;
+    }
+#endif
+
     ioexp.changeBit(IOExpander::IO_BIT_OUT_OUTPUT_ENABLE, enable);
     setOperBits(OPER_ISUM_OE_OFF, !enable);
     bp::switchOutput(this, enable);
@@ -1131,12 +1484,24 @@ void Channel::executeOutputEnable(bool enable) {
     restoreCurrentToValueBeforeBalancing();
 
     if (enable) {
+        resetMeasurementBuffer();
+
         // start ADC conversion
         adc.start(AnalogDigitalConverter::ADC_REG0_READ_U_MON);
 
         onTimeCounter.start();
     } else {
         onTimeCounter.stop();
+
+#if CONF_FAST_TRIP_PROTECTION
+        // fast trip detected in the conversion handler before protectionCheck had a chance to handle it
+        if (ovp.fast_trip_pending) {
+            protectionEnter(ovp);
+        }
+        if (ocp.fast_trip_pending) {
+            protectionEnter(ocp);
+        }
+#endif
     }
 }
 
@@ -1209,11 +1574,11 @@ bool Channel::isLowRippleAllowed(uint32_t tick_usec) {
         delayLowRippleCheck = false;
     }
 
-    if (i.mon_last > SOA_PREG_CURR || i.mon_last > SOA_POSTREG_PTOT / (SOA_VIN - u.mon_last)) {
+    if (i.getMonLast() > SOA_PREG_CURR || i.getMonLast() > SOA_POSTREG_PTOT / (SOA_VIN - u.getMonLast())) {
         return false;
     }
 
-    if (i.mon_last * (SOA_VIN - u.mon_last) > SOA_POSTREG_PTOT) {
+    if (i.getMonLast() * (SOA_VIN - u.getMonLast()) > SOA_POSTREG_PTOT) {
         return false;
     }
 
@@ -1378,33 +1743,41 @@ void Channel::calibrationFindVoltageRange(float minDac, float minVal, float minA
     cal_conf.u.max.dac = maxDac;
     cal_conf.u.max.val = maxVal;
     cal_conf.u.max.adc = maxAdc;
+    // mid point on the line between min and max, so only min and max are used
+    cal_conf.u.mid.dac = (minDac + maxDac) / 2;
+    cal_conf.u.mid.val = (minVal + maxVal) / 2;
+    cal_conf.u.mid.adc = (minAdc + maxAdc) / 2;
+    updateAdcDataConversions();
 
     doSetVoltage(U_MIN);
     //DebugTraceF("U_MIN=%f", U_MIN);
     delay(100);
 #if !ADC_USE_INTERRUPTS
     adc.start(AnalogDigitalConverter::ADC_REG0_READ_U_MON);
-    delayMicroseconds(2 * ADC_READ_TIME_US);
+    delayMicroseconds(2 * adc.getConversionTimeUs());
     adc.tick(micros());
 #endif
+    consumeAdcSamples();
     //DebugTraceF("DAC=%d", (int)debug::g_uDac[index-1].get());
     //DebugTraceF("MON_ADC=%d", (int)u.mon_adc);
-    *min = u.mon_last;
+    *min = u.getMonLast();
 
     doSetVoltage(U_MAX);
     //DebugTraceF("U_MAX=%f", U_MAX);
     delay(200); // guard time, because without load it will require more than 15ms to jump to the max
 #if !ADC_USE_INTERRUPTS
     adc.start(AnalogDigitalConverter::ADC_REG0_READ_U_MON);
-    delayMicroseconds(2 * ADC_READ_TIME_US);
+    delayMicroseconds(2 * adc.getConversionTimeUs());
     adc.tick(micros());
 #endif
+    consumeAdcSamples();
     //DebugTraceF("DAC=%d", (int)debug::g_uDac[index-1].get());
     //DebugTraceF("MON_ADC=%d", (int)u.mon_adc);
-    *max = u.mon_last;
+    *max = u.getMonLast();
 
     cal_conf.flags.u_cal_params_exists = u_cal_params_exists;
     cal_conf.u = calValueConf;
+    updateAdcDataConversions();
 
     flags._calEnabled = false;
 }
@@ -1430,33 +1803,41 @@ void Channel::calibrationFindCurrentRange(float minDac, float minVal, float minA
     cal_conf.i[0].max.dac = maxDac;
     cal_conf.i[0].max.val = maxVal;
     cal_conf.i[0].max.adc = maxAdc;
+    // mid point on the line between min and max, so only min and max are used
+    cal_conf.i[0].mid.dac = (minDac + maxDac) / 2;
+    cal_conf.i[0].mid.val = (minVal + maxVal) / 2;
+    cal_conf.i[0].mid.adc = (minAdc + maxAdc) / 2;
+    updateAdcDataConversions();
 
     doSetCurrent(I_MIN);
     //DebugTraceF("I_MIN=%f", I_MIN);
     delay(100);
 #if !ADC_USE_INTERRUPTS
     adc.start(AnalogDigitalConverter::ADC_REG0_READ_I_MON);
-    delayMicroseconds(2 * ADC_READ_TIME_US);
+    delayMicroseconds(2 * adc.getConversionTimeUs());
     adc.tick(micros());
 #endif
+    consumeAdcSamples();
     //DebugTraceF("DAC=%d", (int)debug::g_iDac[index-1].get());
     //DebugTraceF("MON_ADC=%d", (int)i.mon_adc);
-    *min = i.mon_last;
+    *min = i.getMonLast();
 
     doSetCurrent(I_MAX);
     delay(100);
     //DebugTraceF("I_MAX=%f", I_MAX);
 #if !ADC_USE_INTERRUPTS
     adc.start(AnalogDigitalConverter::ADC_REG0_READ_I_MON);
-    delayMicroseconds(2 * ADC_READ_TIME_US);
+    delayMicroseconds(2 * adc.getConversionTimeUs());
     adc.tick(micros());
 #endif
+    consumeAdcSamples();
     //DebugTraceF("DAC=%d", (int)debug::g_iDac[index-1].get());
     //DebugTraceF("MON_ADC=%d", (int)i.mon_adc);
-    *max = i.mon_last;
+    *max = i.getMonLast();
 
     cal_conf.flags.i_cal_params_exists_range_high = i_cal_params_exists;
     cal_conf.i[0] = calValueConf;
+    updateAdcDataConversions();
 
     flags._calEnabled = false;
 }
@@ -1513,12 +1894,14 @@ bool Channel::isLowRippleAutoEnabled() {
 
 void Channel::doSetVoltage(float value) {
     u.set = value;
-    u.mon_dac = 0;
+    u.mon_dac_micro = 0;
 
     if (prot_conf.u_level < u.set) {
         prot_conf.u_level = u.set;
     }
 
+    updateProtectionThreshold(ovp);
+
     if (U_MAX != U_MAX_CONF) {
         value = util::remap(value, 0, 0, U_MAX_CONF, U_MAX);
     }
@@ -1559,7 +1942,9 @@ void Channel::doSetCurrent(float value) {
     }
 
     i.set = value;
-    i.mon_dac = 0;
+    i.mon_dac_micro = 0;
+
+    updateProtectionThreshold(ocp);
 
     if (I_MAX != I_MAX_CONF) {
         value = util::remap(value, 0, 0, I_MAX_CONF, I_MAX);
@@ -1645,7 +2030,9 @@ void Channel::setQuesBits(int bit_mask, bool on) {
     }
 #if OPTION_ETHERNET
     if (ethernet::g_testResult == psu::TEST_OK) {
-        reg_set_ques_isum_bit(&ethernet::g_scpiContext, this, bit_mask, on);
+        for (int i = 0; i < CONF_ETHERNET_MAX_SESSIONS; ++i) {
+            reg_set_ques_isum_bit(&ethernet::g_scpiContext[i], this, bit_mask, on);
+        }
     }
 #endif
 }
@@ -1656,7 +2043,9 @@ void Channel::setOperBits(int bit_mask, bool on) {
     }
 #if OPTION_ETHERNET
     if (ethernet::g_testResult == psu::TEST_OK) {
-        reg_set_oper_isum_bit(&ethernet::g_scpiContext, this, bit_mask, on);
+        for (int i = 0; i < CONF_ETHERNET_MAX_SESSIONS; ++i) {
+            reg_set_oper_isum_bit(&ethernet::g_scpiContext[i], this, bit_mask, on);
+        }
     }
 #endif
 }
@@ -1729,7 +2118,7 @@ void Channel::limitMaxCurrent(MaxCurrentLimitCause cause) {
         maxCurrentLimitCause = cause;
 
         if (isMaxCurrentLimited()) {
-            if (isOutputEnabled() && i.mon_last > ERR_MAX_CURRENT) {
+            if (isOutputEnabled() && i.getMonLast() > ERR_MAX_CURRENT) {
                 setCurrent(0);
             }
 
@@ -1856,6 +2245,11 @@ float Channel::getDualRangeMax() {
 //}
 
 void Channel::doSetCurrentRange() {
+#if CONF_FAST_TRIP_PROTECTION
+    // fast trip data is calculated for the current range
+    ocp.fast_trip_enabled = false;
+#endif
+
     if (flags.outputEnabled) {
         if (flags.currentCurrentRange == 0) {
             // 5A
@@ -1899,7 +2293,7 @@ void Channel::doAutoSelectCurrentRange(uint32_t tickCount) {
                             doSetCurrent(i.set);
                         }
                     } else if (i.mon_measured) {
-                        if (util::less(i.mon_last, 0.5, getPrecision(VALUE_TYPE_FLOAT_AMPER))) {
+                        if (util::less(i.getMonLast(), 0.5, getPrecision(VALUE_TYPE_FLOAT_AMPER))) {
                             setCurrentRange(1);
                             dac.set_current((uint16_t)65535);
                         }
@@ -1915,5 +2309,30 @@ void Channel::doAutoSelectCurrentRange(uint32_t tickCount) {
     }
 }
 
+void Channel::doSetAcquisition(AcquisitionMode mode, uint8_t dataRate) {
+    adc.setConversionMode(mode == ACQUISITION_MODE_CONTINUOUS, dataRate);
+    adcSetReadbackCounter = 0;
+
+    if (isOutputEnabled()) {
+        adc.start(AnalogDigitalConverter::ADC_REG0_READ_U_MON);
+    }
+}
+
+void Channel::setAcquisitionMode(AcquisitionMode mode) {
+    doSetAcquisition(mode, adc.getDataRate());
+}
+
+AcquisitionMode Channel::getAcquisitionMode() {
+    return adc.isContinuousConversionMode() ? ACQUISITION_MODE_CONTINUOUS : ACQUISITION_MODE_NORMAL;
+}
+
+void Channel::setAcquisitionDataRate(uint8_t dataRate) {
+    doSetAcquisition(getAcquisitionMode(), dataRate);
+}
+
+uint8_t Channel::getAcquisitionDataRate() {
+    return adc.getDataRate();
+}
+
 }
-} // namespace eez::psu
\ No newline at end of file
+} // namespace eez::psu
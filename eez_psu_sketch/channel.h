@@ -23,6 +23,7 @@
 #include "adc.h"
 #include "dac.h"
 #include "temp_sensor.h"
+#include "history.h"
 
 #define IS_OVP_VALUE(channel, cpv) (&cpv == &channel->ovp)
 #define IS_OCP_VALUE(channel, cpv) (&cpv == &channel->ocp)
@@ -77,6 +78,11 @@ enum CurrentRange {
     CURRENT_RANGE_LOW
 };
 
+enum AcquisitionMode {
+    ACQUISITION_MODE_NORMAL, // single shot conversions of all ADC inputs
+    ACQUISITION_MODE_CONTINUOUS // continuous conversions, U_SET/I_SET readback is skipped while output is on
+};
+
 /// PSU channel.
 class Channel {
     friend class DigitalAnalogConverter;
@@ -105,12 +111,12 @@ public:
 
     /// Calibration parameters for the voltage and current.
     /// There are three points defined: `min`, `mid` and `max`.
-    /// Only `min` and `max` are used in actual calculations -
-    /// `mid` is only used for the validity checking.
     /// Here is how `DAC` value is calculated from the `real_value` set by user:
     /// `DAC = min.dac + (real_value - min.val) * (max.dac - min.dac) / (max.val - min.val);`
-    /// And here is how `real_value` is calculated from the `ADC` value:
-    /// `real_value = min.val + (ADC - min.adc) * (max.val - min.val) / (max.adc - min.adc);`
+    /// And here is how `real_value` is calculated from the `ADC` value,
+    /// where `p1` and `p2` are `min` and `mid` if `ADC < mid.adc`, or `mid` and `max` otherwise:
+    /// `real_value = p1.val + (ADC - p1.adc) * (p2.val - p1.val) / (p2.adc - p1.adc);`
+    /// See AdcDataConversion.
     struct CalibrationValueConfiguration {
         /// Min point.
         CalibrationValuePointConfiguration min;
@@ -149,6 +155,32 @@ public:
         char calibration_remark[CALIBRATION_REMARK_MAX_LENGTH + 1];
     };
 
+    /// Conversion of the data read from ADC to the measured value, precomputed from the
+    /// calibration configuration by Channel::updateAdcDataConversions, so no float operation
+    /// is needed per sample. It is piecewise linear function with two segments.
+    struct AdcDataConversion {
+        /// ADC data from which the second segment is used.
+        int16_t segmentStart;
+        /// Per segment slope, in micro units (uV or uA) per ADC data unit, with 16 fractional bits.
+        int32_t slope[2];
+        /// Per segment offset, in micro units.
+        int32_t offset[2];
+
+        /// Build conversion from the [minValue, maxValue] range of the ADC
+        /// and the optional calibration points.
+        void build(float minValue, float maxValue, float gndOffset, const CalibrationValueConfiguration *calValueConf);
+
+        /// Returns measured value in micro units (uV or uA).
+        int32_t toMicroUnits(int16_t adc_data) const {
+            int i = adc_data < segmentStart ? 0 : 1;
+            return (int32_t)(((int64_t)adc_data * slope[i]) >> 16) + offset[i];
+        }
+
+        /// Find the lowest ADC data converted to the value at or above the threshold.
+        /// @returns false if there is no such ADC data or conversion is not monotonic.
+        bool findAdcData(int64_t threshold, int16_t &adc_data) const;
+    };
+
     /// Binary flags for the channel protection configuration
     struct ProtectionConfigurationFlags {
         /// Is OVP enabled?
@@ -205,16 +237,18 @@ public:
 
         bool mon_measured;
 
-        float mon;
-        float mon_last;
+        // Measured values are kept in micro units (uV or uA), so averaging is done in integers.
+        // Running total of NUM_ADC_AVERAGING_VALUES values fits in int32_t up to 71 V or A.
+        int32_t mon_micro;
+        int32_t mon_last_micro;
         int8_t mon_index;
-        float mon_arr[NUM_ADC_AVERAGING_VALUES];
-        float mon_total;
+        int32_t mon_arr[NUM_ADC_AVERAGING_VALUES];
+        int32_t mon_total;
 
-        float mon_dac;
+        int32_t mon_dac_micro;
         int8_t mon_dac_index;
-        float mon_dac_arr[NUM_ADC_AVERAGING_VALUES];
-        float mon_dac_total;
+        int32_t mon_dac_arr[NUM_ADC_AVERAGING_VALUES];
+        int32_t mon_dac_total;
 
         float step;
         float limit;
@@ -225,20 +259,65 @@ public:
 
         void init(float set_, float step_, float limit_);
         void resetMonValues();
-        void addMonDacValue(float value);
-        void addMonValue(float value);
+        void addMonDacValue(int32_t value_micro);
+        void addMonValue(int32_t value_micro);
+
+        /// Averaged measured value.
+        float getMon() const { return mon_micro * 1E-6f; }
+        /// Last measured value.
+        float getMonLast() const { return mon_last_micro * 1E-6f; }
+        /// Averaged value measured on DAC output.
+        float getMonDac() const { return mon_dac_micro * 1E-6f; }
     };
 
     /// Runtime protection binary flags (alarmed, tripped)
     struct ProtectionFlags {
         unsigned alarmed : 1;
         unsigned tripped : 1;
+        /// Last trip was detected by the fast trip, see CONF_FAST_TRIP_PROTECTION.
+        unsigned fast_tripped : 1;
     };
 
     /// Runtime protection values    
     struct ProtectionValue {
         ProtectionFlags flags;
         uint32_t alarm_started;
+        /// Protection level for which the threshold is calculated.
+        float level;
+        /// Lowest measured value, in micro units, at which the protection condition is met
+        /// (for OPP the power in micro units squared above which the condition is met).
+        int64_t threshold;
+        /// Time from the end of ADC conversion of the sample which tripped the protection
+        /// until the output was turned off, in microseconds.
+        volatile uint32_t trip_latency;
+#if CONF_FAST_TRIP_PROTECTION
+        /// Fast trip is checked in the ADC conversion handler.
+        volatile bool fast_trip_enabled;
+        /// Set by the ADC conversion handler when output is turned off by the fast trip.
+        volatile bool fast_trip_pending;
+        /// Fast trip can't happen if the threshold is out of the ADC data range.
+        bool fast_trip_possible;
+        /// Raw ADC data at or above which fast trip fires.
+        volatile int16_t fast_trip_data;
+        /// Number of consecutive samples at or above fast_trip_data.
+        volatile uint8_t fast_trip_count;
+        /// Conversion and threshold for which fast_trip_data is calculated.
+        const AdcDataConversion *fast_trip_conversion;
+        int64_t fast_trip_threshold;
+
+        /// Count the raw sample against fast_trip_data.
+        /// @returns true if the last numSamples samples were all at or above fast_trip_data.
+        bool fastTripSample(int16_t adc_data, uint8_t numSamples) {
+            if (adc_data < fast_trip_data) {
+                fast_trip_count = 0;
+                return false;
+            }
+            if (fast_trip_count < numSamples) {
+                ++fast_trip_count;
+            }
+            return fast_trip_count >= numSamples;
+        }
+#endif
     };
 
 #ifdef EEZ_PSU_SIMULATOR
@@ -370,6 +449,11 @@ public:
 
 #ifdef EEZ_PSU_SIMULATOR
     Simulator simulator;
+
+    /// Convert U_SET ADC data to voltage, without calibration and GND offset.
+    float simulatorAdcDataToVoltage(int16_t adc_data);
+    /// Convert I_SET ADC data of the current range to current, without calibration and GND offset.
+    float simulatorAdcDataToCurrent(int16_t adc_data);
 #endif // EEZ_PSU_SIMULATOR
 
     Channel(
@@ -399,6 +483,9 @@ public:
     /// Clear channel calibration configuration.
     void clearCalibrationConf();
 
+    /// Rebuild ADC data conversions, must be called every time cal_conf is changed.
+    void updateAdcDataConversions();
+
     /// Test the channel.
     bool test();
 
@@ -417,10 +504,26 @@ public:
     /// Called by main loop, used for channel maintenance.
     void tick(uint32_t tick_usec);
 
+    /// Called from the main loop for the each raw sample produced by ADC.
+    /// @param sample Raw ADC sample.
+    void eventAdcData(const AdcSample &sample);
+
+    /// Process, in batch, all the raw samples queued by ADC conversion handler.
+    void consumeAdcSamples();
+
+    /// Which ADC input to convert after the conversion selected by reg0 is finished.
+    /// Called from ADC conversion handler, so only channel flags are checked here.
+    /// @returns Value of ADC register 0 or 0 if there is nothing more to convert.
+    uint8_t getAdcNextStartReg0(uint8_t reg0);
+
+#if CONF_FAST_TRIP_PROTECTION
+    /// Called from ADC conversion handler. Turns the output off right away if raw ADC data
+    /// is at or above the fast trip threshold, protection is entered later by the main loop.
+    void fastTripCheck(uint8_t reg0, int16_t adc_data, uint32_t tick_usec);
+#endif
+
     /// Called from IO expander interrupt routine.
     /// @param gpio State of IO expander GPIO register.
-    /// @param adc_data ADC snapshot data.
-    void eventAdcData(int16_t adc_data, bool startAgain = true);
     void eventGpio(uint8_t gpio);
 
     /// Called when device power is turned off, so channel
@@ -515,12 +618,6 @@ public:
     /// Returns "CC", "CV" or "UR"
     char *getCvModeStr();
 
-    /// Remap ADC data value to actual voltage value
-    float remapAdcDataToVoltage(int16_t adc_data);
-
-    /// Remap ADC data value to actual current value (use calibration if configured).
-    float remapAdcDataToCurrent(int16_t adc_data);
-
     /// Remap voltage value to ADC data value (use calibration if configured).
     int16_t remapVoltageToAdcData(float value);
 
@@ -578,11 +675,20 @@ public:
     float getISetUnbalanced() { return isCurrentBalanced() ? iBeforeBalancing : i.set; }
 
     int getCurrentHistoryValuePosition() { return historyPosition; }
-    float getUMonHistory(int position) const { return uHistory[position]; }
-    float getIMonHistory(int position) const { return iHistory[position]; }
+    float getUMonHistory(int position, history::ValueKind kind = history::VALUE_KIND_LAST) const;
+    float getIMonHistory(int position, history::ValueKind kind = history::VALUE_KIND_LAST) const;
 
     void resetHistory();
 
+    /// Min/max/avg U_MON/I_MON history at 1 second, 1 minute and 1 hour resolution (see SENSe:HISTory?).
+    const history::Store &getHistoryStore() const { return historyStore; }
+
+    /// Number of measurements in the measurement buffer (see FETCh:ARRay).
+    int getMeasurementBufferCount() const { return measurementBufferCount; }
+    /// Copy the last count measurements, oldest first, from the measurement buffer.
+    /// @returns Number of copied measurements.
+    int getMeasurementBufferValues(float *uMon, float *iMon, int count);
+
     TriggerMode getVoltageTriggerMode();
     void setVoltageTriggerMode(TriggerMode mode);
 
@@ -604,6 +710,12 @@ public:
     float getDualRangeMax();
     void setCurrentRange(uint8_t currentRange);
 
+    void setAcquisitionMode(AcquisitionMode mode);
+    AcquisitionMode getAcquisitionMode();
+    /// @param dataRate ADC data rate code, see AnalogDigitalConverter::getDataRateSps.
+    void setAcquisitionDataRate(uint8_t dataRate);
+    uint8_t getAcquisitionDataRate();
+
 private:
     bool delayed_dp_off;
     uint32_t delayed_dp_off_start;
@@ -611,6 +723,9 @@ private:
     uint32_t outputEnableStartTime;
     uint32_t dpNegMonitoringTime;
 
+    /// End of ADC conversion of the sample which is being processed.
+    uint32_t adcSampleTick;
+
     float U_MIN;
     float U_DEF;
     float U_MAX;
@@ -632,13 +747,41 @@ private:
 
     float uHistory[CHANNEL_HISTORY_SIZE];
     float iHistory[CHANNEL_HISTORY_SIZE];
+    float uHistoryMin[CHANNEL_HISTORY_SIZE];
+    float uHistoryMax[CHANNEL_HISTORY_SIZE];
+    float iHistoryMin[CHANNEL_HISTORY_SIZE];
+    float iHistoryMax[CHANNEL_HISTORY_SIZE];
     int historyPosition;
     uint32_t historyLastTick;
+    // samples measured since the last YT view history value
+    history::Accumulator uHistoryAccumulator;
+    history::Accumulator iHistoryAccumulator;
+    void addHistoryValue(int position);
+
+    history::Store historyStore;
+
+    // in micro units, converted to float when fetched
+    int32_t uMeasurementBuffer[CHANNEL_MEASUREMENT_BUFFER_SIZE];
+    int32_t iMeasurementBuffer[CHANNEL_MEASUREMENT_BUFFER_SIZE];
+    int measurementBufferPosition;
+    int measurementBufferCount;
+    void resetMeasurementBuffer();
+    void addMeasurementBufferValue(int32_t uMon, int32_t iMon);
 
     float VOLTAGE_GND_OFFSET;
     float CURRENT_GND_OFFSET;
 
+    /// U_MON conversion: [0] without and [1] with calibration.
+    AdcDataConversion uMonConversion[2];
+    /// I_MON conversion: [current range][0] without and [current range][1] with calibration.
+    AdcDataConversion iMonConversion[2][2];
+    /// U_SET conversion: [0] with and [1] without (remote programming) GND offset.
+    AdcDataConversion uSetConversion[2];
+    /// I_SET conversion: [current range].
+    AdcDataConversion iSetConversion[2];
+
     void clearProtectionConf();
+    void updateProtectionThreshold(ProtectionValue &cpv);
     void protectionEnter(ProtectionValue &cpv);
     void protectionCheck(ProtectionValue &cpv);
     void protectionCheck();
@@ -649,7 +792,10 @@ private:
     bool isVoltageCalibrationEnabled();
     bool isCurrentCalibrationEnabled();
 
-    void adcDataIsReady(int16_t data, bool startAgain);
+    void adcDataIsReady(uint8_t reg0, int16_t data);
+#if ADC_USE_INTERRUPTS
+    void adcDelay(uint32_t ms);
+#endif
     
     void voltageBalancing();
     void currentBalancing();
@@ -686,6 +832,9 @@ private:
     uint32_t autoRangeCheckLastTickCount;
     void doAutoSelectCurrentRange(uint32_t tickCount);
 
+    uint8_t adcSetReadbackCounter;
+    void doSetAcquisition(AcquisitionMode mode, uint8_t dataRate);
+
     void doSetCurrentRange();
 };
 
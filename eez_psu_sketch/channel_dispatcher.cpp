@@ -190,30 +190,44 @@ float getUSetUnbalanced(const Channel &channel) {
 
 float getUMon(const Channel &channel) { 
     if (isSeries()) {
-        return Channel::get(0).u.mon + Channel::get(1).u.mon;
+        return Channel::get(0).u.getMon() + Channel::get(1).u.getMon();
     }
-    return channel.u.mon; 
+    return channel.u.getMon(); 
 }
 
 float getUMonLast(const Channel &channel) {
 	if (isSeries()) {
-		return Channel::get(0).u.mon_last + Channel::get(1).u.mon_last;
+		return Channel::get(0).u.getMonLast() + Channel::get(1).u.getMonLast();
 	}
-	return channel.u.mon_last;
+	return channel.u.getMonLast();
 }
 
-float getUMonHistory(const Channel &channel, int position) {
+float getUMonHistory(const Channel &channel, int position, history::ValueKind kind) {
     if (isSeries()) {
-        return Channel::get(0).getUMonHistory(position) + Channel::get(1).getUMonHistory(position);
+        return Channel::get(0).getUMonHistory(position, kind) + Channel::get(1).getUMonHistory(position, kind);
     }
-    return channel.getUMonHistory(position); 
+    return channel.getUMonHistory(position, kind);
 }
 
 float getUMonDac(const Channel &channel) { 
     if (isSeries()) {
-        return Channel::get(0).u.mon_dac + Channel::get(1).u.mon_dac;
+        return Channel::get(0).u.getMonDac() + Channel::get(1).u.getMonDac();
     }
-    return channel.u.mon_dac; 
+    return channel.u.getMonDac(); 
+}
+
+int32_t getUMonMicro(const Channel &channel) {
+    if (isSeries()) {
+        return Channel::get(0).u.mon_micro + Channel::get(1).u.mon_micro;
+    }
+    return channel.u.mon_micro;
+}
+
+int32_t getUMonDacMicro(const Channel &channel) {
+    if (isSeries()) {
+        return Channel::get(0).u.mon_dac_micro + Channel::get(1).u.mon_dac_micro;
+    }
+    return channel.u.mon_dac_micro;
 }
 
 float getULimit(const Channel &channel) {
@@ -350,30 +364,37 @@ float getISetUnbalanced(const Channel &channel) {
 
 float getIMon(const Channel &channel) { 
     if (isParallel()) {
-        return Channel::get(0).i.mon + Channel::get(1).i.mon;
+        return Channel::get(0).i.getMon() + Channel::get(1).i.getMon();
     }
-    return channel.i.mon; 
+    return channel.i.getMon(); 
 }
 
 float getIMonLast(const Channel &channel) {
 	if (isParallel()) {
-		return Channel::get(0).i.mon_last + Channel::get(1).i.mon_last;
+		return Channel::get(0).i.getMonLast() + Channel::get(1).i.getMonLast();
 	}
-	return channel.i.mon_last;
+	return channel.i.getMonLast();
 }
 
-float getIMonHistory(const Channel &channel, int position) {
+float getIMonHistory(const Channel &channel, int position, history::ValueKind kind) {
     if (isParallel()) {
-        return Channel::get(0).getIMonHistory(position) + Channel::get(1).getIMonHistory(position);
+        return Channel::get(0).getIMonHistory(position, kind) + Channel::get(1).getIMonHistory(position, kind);
     }
-    return channel.getIMonHistory(position); 
+    return channel.getIMonHistory(position, kind);
 }
 
 float getIMonDac(const Channel &channel) { 
     if (isParallel()) {
-        return Channel::get(0).i.mon_dac + Channel::get(1).i.mon_dac;
+        return Channel::get(0).i.getMonDac() + Channel::get(1).i.getMonDac();
+    }
+    return channel.i.getMonDac(); 
+}
+
+int32_t getIMonMicro(const Channel &channel) {
+    if (isParallel()) {
+        return Channel::get(0).i.mon_micro + Channel::get(1).i.mon_micro;
     }
-    return channel.i.mon_dac; 
+    return channel.i.mon_micro;
 }
 
 float getILimit(const Channel &channel) {
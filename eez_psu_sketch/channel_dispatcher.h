@@ -49,8 +49,12 @@ float getUSet(const Channel &channel);
 float getUSetUnbalanced(const Channel &channel);
 float getUMon(const Channel &channel);
 float getUMonLast(const Channel &channel);
-float getUMonHistory(const Channel &channel, int position);
+float getUMonHistory(const Channel &channel, int position, history::ValueKind kind = history::VALUE_KIND_LAST);
 float getUMonDac(const Channel &channel);
+/// Averaged measured voltage in uV, used by the protection check.
+int32_t getUMonMicro(const Channel &channel);
+/// Averaged voltage measured on DAC output in uV, used by the protection check.
+int32_t getUMonDacMicro(const Channel &channel);
 float getULimit(const Channel &channel);
 float getUMaxLimit(const Channel &channel);
 float getUMin(const Channel &channel);
@@ -68,8 +72,10 @@ float getISet(const Channel &channel);
 float getISetUnbalanced(const Channel &channel);
 float getIMon(const Channel &channel);
 float getIMonLast(const Channel &channel);
-float getIMonHistory(const Channel &channel, int position);
+float getIMonHistory(const Channel &channel, int position, history::ValueKind kind = history::VALUE_KIND_LAST);
 float getIMonDac(const Channel &channel);
+/// Averaged measured current in uA, used by the protection check.
+int32_t getIMonMicro(const Channel &channel);
 float getILimit(const Channel &channel);
 float getIMaxLimit(const Channel &channel);
 float getIMin(const Channel &channel);
@@ -72,6 +72,14 @@
 #endif
 #define ADC_SPS_TIME_CRITICAL 5 // used when time/performance critical operation is running
 
+/// How often, in microseconds, ADC conversion end is checked when
+/// continuous acquisition mode (SENS:ACQ:MODE CONT) is selected on any channel.
+#define ADC_CONTINUOUS_READ_TIME_US 500
+
+/// In continuous acquisition mode, while output is enabled and remote programming is active,
+/// U_SET is read back only once per this many U_MON/I_MON conversion pairs.
+#define ADC_CONTINUOUS_SET_READBACK_PERIOD 8
+
 /// Duration, in milliseconds, from the last ADC interrupt
 /// after which ADC timeout condition is declared.  
 #define ADC_TIMEOUT_MS 60
@@ -79,6 +87,10 @@
 /// Maximum number of attempts to recover from ADC timeout before giving up.
 #define MAX_ADC_TIMEOUT_RECOVERY_ATTEMPTS 3
 
+/// Number of raw ADC samples (per channel) that can wait to be processed by the main loop.
+/// Must be power of 2.
+#define ADC_SAMPLE_BUFFER_SIZE 32
+
 /// Password minimum length in number characters.
 #define PASSWORD_MIN_LENGTH 4
 
@@ -152,6 +164,23 @@
 /// Value is given in seconds.
 #define PROT_DELAY_CORRECTION 0.002f
 
+/// Set to 1 to check OVP and OCP with zero delay also in the ADC conversion
+/// handler: raw ADC data is compared with the protection level converted to
+/// ADC data and output is turned off without waiting for the averaged value
+/// and the main loop. Not used for the coupled channels.
+#define CONF_FAST_TRIP_PROTECTION 1
+
+/// Fast trip fires this many ADC data units above the protection level,
+/// so the noise around the level is left to the averaged protection check.
+#define CONF_FAST_TRIP_HYSTERESIS 0
+
+/// Number of consecutive raw U_MON/I_MON samples which must reach the fast
+/// trip level before the fast trip fires. Current is noisier, especially in
+/// CC mode where it is regulated at the OCP level, so a single I_MON sample
+/// is not enough.
+#define CONF_FAST_TRIP_OVP_NUM_SAMPLES 1
+#define CONF_FAST_TRIP_OCP_NUM_SAMPLES 3
+
 /// This is the delay period, after the channel output went OFF,
 /// after which we shall turn DP off.
 /// Value is given in seconds.
@@ -173,6 +202,18 @@
 #define DISPLAY_ORIENTATION DISPLAY_ORIENTATION_LANDSCAPE
 #endif
 
+/// Size (in bytes) of the RAM cache of glyphs pre-decoded into horizontal runs,
+/// set to 0 to always draw glyphs directly from the font data.
+/// Digits, sign, decimal point and units of the big channel displays take about 1.5 KB.
+#define CONF_GUI_GLYPH_CACHE_SIZE 2048
+
+/// Max. number of glyphs in the glyph cache.
+#define CONF_GUI_GLYPH_CACHE_MAX_GLYPHS 24
+
+/// Only glyphs of this height (in pixels) or higher are cached,
+/// i.e. digits and units of the big channel displays.
+#define CONF_GUI_GLYPH_CACHE_MIN_HEIGHT 16
+
 /// Set to 1 to skip the test of PWRGOOD signal
 #define CONF_SKIP_PWRGOOD_TEST 0
 
@@ -227,6 +268,13 @@
 /// Interval (in minutes) at which "on time" will be written to EEPROM
 #define WRITE_ONTIME_INTERVAL 10
 
+/// Number of 64 bytes pages in EEPROM write-back cache.
+#define CONF_EEPROM_CACHE_PAGES 16
+
+/// Time (in milliseconds) since the last modification after which dirty EEPROM page is written.
+/// Configuration blocks and ON-time counters don't wait, they are written through.
+#define CONF_EEPROM_WRITE_BACK_DELAY_MS 100
+
 /// Maximum allowed length (including label) of the keypad text.
 #define MAX_KEYPAD_TEXT_LENGTH 128
 
@@ -243,6 +291,21 @@
 /// until we declare ethernet initialization failure.
 #define ETHERNET_DHCP_TIMEOUT 15
 
+/// Max. number of concurrent Ethernet SCPI sessions, every session has its own SCPI parser context
+/// and SCPI_PARSER_INPUT_BUFFER_LENGTH input buffer (about 2.5 KB of RAM per session).
+#define CONF_ETHERNET_MAX_SESSIONS 2
+
+/// Arbitration of the state changing commands between Ethernet sessions:
+/// 0 - session which acquired the lock with SYSTem:LOCK:REQuest? is the only one allowed to change the state,
+///     if no session holds the lock every session is allowed to change the state,
+/// 1 - the same as 0, but the first session which sends state changing command acquires the lock automatically.
+/// Lock is released with SYSTem:LOCK:RELease or when session is closed.
+#define CONF_ETHERNET_LOCK_POLICY 0
+
+/// Size of the static buffer into which the input of the Ethernet session is read
+/// before it is passed to the SCPI parser.
+#define CONF_ETHERNET_INPUT_CHUNK_SIZE 256
+
 /// Output power is monitored and if its go below DP_NEG_LEV
 /// that is negative value in Watts (default -1 W),
 /// and that condition lasts more then DP_NEG_DELAY seconds (default 5 s),
@@ -259,10 +322,20 @@
 /// But, unfortunately, now ethernet doesn't work.
 #define REPLACE_SPI_TRANSACTIONS_IMPLEMENTATION 0
 
-/// Number of history values shown in YT diagram. This value must be the same as
-/// the width of YT widget.
+/// Number of history values shown in YT diagram, one pixel column per value.
+/// Graph is aligned to the right side of YT widget and labels take the rest of the width.
 #define CHANNEL_HISTORY_SIZE 140
 
+/// Number of the last measured U_MON/I_MON pairs, per channel, returned by FETCh:ARRay.
+/// Takes 8 bytes of RAM per pair and channel.
+#define CHANNEL_MEASUREMENT_BUFFER_SIZE 64
+
+/// Number of 1 second, 1 minute and 1 hour min/max/avg U_MON/I_MON buckets, per channel,
+/// returned by SENSe:HISTory? Every bucket takes 24 bytes of RAM per channel.
+#define CHANNEL_HISTORY_NUM_SECONDS 60
+#define CHANNEL_HISTORY_NUM_MINUTES 60
+#define CHANNEL_HISTORY_NUM_HOURS 24
+
 #define GUI_YT_VIEW_RATE_DEFAULT 0.1f
 #define GUI_YT_VIEW_RATE_MIN 0.01f
 #define GUI_YT_VIEW_RATE_MAX 300.0f
@@ -337,5 +410,35 @@
 /// During data logging call file.sync every N seconds
 #define CONF_DLOG_SYNC_FILE_TIME 10 // 10 seconds
 
+/// DLOG samples are collected in RAM block of this size (in bytes) and
+/// written to the file when the block is full. Two blocks are used.
+/// Keep it equal to the SD card sector size.
+#define CONF_DLOG_BLOCK_SIZE 512
+
+/// DLOG file format version: 1 (float columns) or 2 (compressed blocks with index)
+#define CONF_DLOG_VERSION 2
+
+/// Max. number of entries in the block index at the end of the version 2 DLOG file.
+/// When index is full, two adjacent entries are merged into one.
+/// Every entry takes 120 bytes of RAM.
+#define CONF_DLOG_INDEX_SIZE 16
+
+/// DLOG preview file keeps min/max/mean of every CONF_DLOG_PREVIEW_FACTOR rows (level 0),
+/// of every CONF_DLOG_PREVIEW_FACTOR level 0 records (level 1), etc.
+#define CONF_DLOG_PREVIEW_FACTOR 16
+#define CONF_DLOG_PREVIEW_LEVELS 3
+
+/// Measure the time spent in every subsystem of the main loop and critical tick,
+/// see SYSTem:DEBug:PROFile? It takes about 1.2 KB of RAM and one micros() call per subsystem.
+#define CONF_PROFILER 1
+
+/// Interval between two critical ticks longer than this (in microseconds) is counted as a deadline miss.
+#define CONF_PROFILER_CRITICAL_TICK_DEADLINE_US 1000
+
 /// Size of serial port output buffer
 #define CONF_SERIAL_BUFFER_SIZE 64
+
+/// Size of SCPI output buffer shared by the serial and Ethernet interfaces.
+/// Response is sent when buffer is full, at the end of the response message and
+/// at the end of the input processing, so it is sent with fewer TCP packets.
+#define CONF_SCPI_OUTPUT_BUFFER_SIZE 512
@@ -107,7 +107,7 @@ bool DigitalAnalogConverter::test() {
 
     channel.adcReadMonDac();
 
-    float u_mon = channel.u.mon_dac;
+    float u_mon = channel.u.getMonDac();
     float u_diff = u_mon - u_set;
     if (fabsf(u_diff) > u_set * DAC_TEST_TOLERANCE / 100) {
         g_testResult = psu::TEST_FAILED;
@@ -119,7 +119,7 @@ bool DigitalAnalogConverter::test() {
             (int)(u_diff * 100));
     }
 
-    float i_mon = channel.i.mon_dac;
+    float i_mon = channel.i.getMonDac();
     float i_diff = i_mon - i_set;
     if (fabsf(i_diff) > i_set * DAC_TEST_TOLERANCE / 100) {
         g_testResult = psu::TEST_FAILED;
@@ -60,6 +60,7 @@ DebugDurationVariable g_mainLoopDuration("MAIN_LOOP_DURATION");
 DebugDurationVariable g_listTickDuration("LIST_TICK_DURATION");
 #endif
 DebugCounterVariable g_adcCounter("ADC_COUNTER");
+DebugCounterVariable g_adcOverflowCounter("ADC_OVERFLOW_COUNTER");
 
 DebugVariable *g_variables[] = {
     &g_uDac[0],    &g_uDac[1],
@@ -77,7 +78,8 @@ DebugVariable *g_variables[] = {
 #if CONF_DEBUG_VARIABLES
     &g_listTickDuration,
 #endif
-    &g_adcCounter
+    &g_adcCounter,
+    &g_adcOverflowCounter
 };
 
 bool g_debugWatchdog = true;
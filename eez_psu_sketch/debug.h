@@ -172,6 +172,7 @@ extern DebugDurationVariable g_mainLoopDuration;
 extern DebugDurationVariable g_listTickDuration;
 #endif
 extern DebugCounterVariable g_adcCounter;
+extern DebugCounterVariable g_adcOverflowCounter;
 
 extern bool g_debugWatchdog;
 
@@ -28,6 +28,7 @@
 #include "watchdog.h"
 #endif
 #include "dlog.h"
+#include "dlog_file.h"
 
 namespace eez {
 namespace psu {
@@ -39,6 +40,7 @@ bool g_logPower[CH_NUM];
 float g_period = PERIOD_DEFAULT;
 float g_time = TIME_DEFAULT;
 trigger::Source g_triggerSource = trigger::SOURCE_IMMEDIATE;
+DataSource g_dataSource = DATA_SOURCE_TIMER;
 char g_filePath[MAX_PATH_LENGTH + 1];
 
 enum State {
@@ -58,6 +60,61 @@ double g_currentTime;
 double g_nextTime;
 uint32_t g_lastSyncTickCount;
 
+// used with DATA_SOURCE_ADC
+static uint32_t g_totalNumRows;
+
+static int g_adcChannelIndex;
+static uint32_t g_numSamples;
+static double g_lastSampleTime;
+
+// samples are collected in one block while the other is written to the file
+struct BlockBuffer {
+	File *file;
+	uint8_t blocks[2][CONF_DLOG_BLOCK_SIZE];
+	bool blockFull[2];
+	uint8_t fillBlockIndex;
+	uint16_t fillBlockPosition;
+};
+
+static BlockBuffer g_dataBuffer;
+
+#define MAX_NUM_COLUMNS (1 + 3 * CH_MAX)
+
+static int g_numColumns;
+
+// used with VERSION2
+struct ColumnSummary {
+	float min;
+	float max;
+	float mean; // sum of values while data block is filled
+	uint32_t count;
+};
+
+struct IndexEntry {
+	uint32_t firstBlock;
+	uint32_t firstRow;
+	ColumnSummary columns[MAX_NUM_COLUMNS];
+};
+
+static float g_resolution[MAX_NUM_COLUMNS];
+static int32_t g_lastCode[MAX_NUM_COLUMNS];
+static ColumnSummary g_blockSummary[MAX_NUM_COLUMNS];
+static uint32_t g_numRows;
+static uint32_t g_blockFirstRow;
+static uint16_t g_blockDataOffset;
+static uint32_t g_numBlocks;
+
+static IndexEntry g_index[CONF_DLOG_INDEX_SIZE];
+static uint16_t g_numIndexEntries;
+static uint16_t g_blocksPerIndexEntry;
+
+// decimation pyramid written to the preview file
+File g_previewFile;
+static bool g_previewEnabled;
+static BlockBuffer g_previewBuffer;
+static ColumnSummary g_previewSummary[CONF_DLOG_PREVIEW_LEVELS][MAX_NUM_COLUMNS];
+static uint16_t g_previewCount[CONF_DLOG_PREVIEW_LEVELS];
+
 void setState(State newState) {
 	if (g_state != newState) {
 		if (newState == STATE_EXECUTING) {
@@ -130,28 +187,419 @@ void triggerGenerated(bool startImmediatelly) {
 	}
 }
 
-#define MAGIC1  0x2D5A4545L
-#define MAGIC2  0x474F4C44L
-#define VERSION 0x00000001L
+void resetBlocks(BlockBuffer &buffer, File &file) {
+	buffer.file = &file;
+	buffer.blockFull[0] = false;
+	buffer.blockFull[1] = false;
+	buffer.fillBlockIndex = 0;
+	buffer.fillBlockPosition = 0;
+}
+
+void writeBlock(BlockBuffer &buffer, uint8_t blockIndex) {
+	buffer.file->write(buffer.blocks[blockIndex], CONF_DLOG_BLOCK_SIZE);
+	buffer.blockFull[blockIndex] = false;
+}
+
+void writeAllBlocks(BlockBuffer &buffer) {
+	uint8_t otherBlockIndex = (buffer.fillBlockIndex + 1) % 2;
+	if (buffer.blockFull[otherBlockIndex]) {
+		writeBlock(buffer, otherBlockIndex);
+	}
+
+	if (buffer.fillBlockPosition > 0) {
+		buffer.file->write(buffer.blocks[buffer.fillBlockIndex], buffer.fillBlockPosition);
+		buffer.fillBlockPosition = 0;
+	}
+}
+
+bool isBlockFull(BlockBuffer &buffer) {
+	return buffer.blockFull[(buffer.fillBlockIndex + 1) % 2];
+}
+
+void writeFullBlock(BlockBuffer &buffer) {
+	uint8_t otherBlockIndex = (buffer.fillBlockIndex + 1) % 2;
+	if (buffer.blockFull[otherBlockIndex]) {
+		writeBlock(buffer, otherBlockIndex);
+	}
+}
+
+void fillBlockDone(BlockBuffer &buffer) {
+	buffer.blockFull[buffer.fillBlockIndex] = true;
+	buffer.fillBlockIndex = (buffer.fillBlockIndex + 1) % 2;
+	buffer.fillBlockPosition = 0;
+
+	if (buffer.blockFull[buffer.fillBlockIndex]) {
+		// main loop didn't manage to write this block, so it must be done now
+		writeBlock(buffer, buffer.fillBlockIndex);
+	}
+}
+
+void writeUint8(BlockBuffer &buffer, uint8_t value) {
+	buffer.blocks[buffer.fillBlockIndex][buffer.fillBlockPosition] = value;
+
+	if (++buffer.fillBlockPosition == CONF_DLOG_BLOCK_SIZE) {
+		fillBlockDone(buffer);
+	}
+}
+
+void writeUint16(BlockBuffer &buffer, uint16_t value) {
+	writeUint8(buffer, value & 0xFF);
+	writeUint8(buffer, (value >> 8) & 0xFF);
+}
+
+void writeUint32(BlockBuffer &buffer, uint32_t value) {
+	writeUint8(buffer, value & 0xFF);
+	writeUint8(buffer, (value >> 8) & 0xFF);
+	writeUint8(buffer, (value >> 16) & 0xFF);
+	writeUint8(buffer, value >> 24);
+}
+
+void writeFloat(BlockBuffer &buffer, float value) {
+	uint32_t data;
+	memcpy(&data, &value, 4);
+	writeUint32(buffer, data);
+}
 
 void writeUint8(uint8_t value) {
-	g_file.write((const uint8_t *)&value, 1);
+	writeUint8(g_dataBuffer, value);
 }
 
 void writeUint16(uint16_t value) {
-	writeUint8(value & 0xFF);
-	writeUint8((value >> 8) & 0xFF);
+	writeUint16(g_dataBuffer, value);
 }
 
 void writeUint32(uint32_t value) {
-	writeUint8(value & 0xFF);
-	writeUint8((value >> 8) & 0xFF);
-	writeUint8((value >> 16) & 0xFF);
-	writeUint8(value >> 24);
+	writeUint32(g_dataBuffer, value);
 }
 
 void writeFloat(float value) {
-	writeUint32(*((uint32_t *)&value));
+	writeFloat(g_dataBuffer, value);
+}
+
+uint8_t *putUint16(uint8_t *p, uint16_t value) {
+	*p++ = value & 0xFF;
+	*p++ = (value >> 8) & 0xFF;
+	return p;
+}
+
+uint8_t *putUint32(uint8_t *p, uint32_t value) {
+	*p++ = value & 0xFF;
+	*p++ = (value >> 8) & 0xFF;
+	*p++ = (value >> 16) & 0xFF;
+	*p++ = value >> 24;
+	return p;
+}
+
+uint8_t *putFloat(uint8_t *p, float value) {
+	uint32_t data;
+	memcpy(&data, &value, 4);
+	return putUint32(p, data);
+}
+
+void resetColumnSummary(ColumnSummary &summary) {
+	summary.min = NAN;
+	summary.max = NAN;
+	summary.mean = 0;
+	summary.count = 0;
+}
+
+void mergeColumnSummary(ColumnSummary &summary, const ColumnSummary &other) {
+	if (other.count == 0) {
+		return;
+	}
+
+	if (summary.count == 0) {
+		summary = other;
+		return;
+	}
+
+	if (other.min < summary.min) {
+		summary.min = other.min;
+	}
+	if (other.max > summary.max) {
+		summary.max = other.max;
+	}
+
+	uint32_t count = summary.count + other.count;
+	summary.mean = (summary.mean * summary.count + other.mean * other.count) / count;
+	summary.count = count;
+}
+
+void openDataBlock() {
+	g_blockFirstRow = g_numRows;
+	g_dataBuffer.fillBlockPosition = g_blockDataOffset;
+	for (int i = 0; i < g_numColumns; ++i) {
+		g_lastCode[i] = 0;
+		resetColumnSummary(g_blockSummary[i]);
+	}
+}
+
+void addBlockToIndex() {
+	if (g_numBlocks % g_blocksPerIndexEntry == 0) {
+		if (g_numIndexEntries == CONF_DLOG_INDEX_SIZE) {
+			// index is full, merge every two entries into one
+			for (int i = 0; i < CONF_DLOG_INDEX_SIZE / 2; ++i) {
+				g_index[i] = g_index[2 * i];
+				for (int j = 0; j < g_numColumns; ++j) {
+					mergeColumnSummary(g_index[i].columns[j], g_index[2 * i + 1].columns[j]);
+				}
+			}
+			g_numIndexEntries = CONF_DLOG_INDEX_SIZE / 2;
+			g_blocksPerIndexEntry *= 2;
+		}
+
+		IndexEntry &entry = g_index[g_numIndexEntries++];
+		entry.firstBlock = g_numBlocks;
+		entry.firstRow = g_blockFirstRow;
+		for (int i = 0; i < g_numColumns; ++i) {
+			entry.columns[i] = g_blockSummary[i];
+		}
+	} else {
+		IndexEntry &entry = g_index[g_numIndexEntries - 1];
+		for (int i = 0; i < g_numColumns; ++i) {
+			mergeColumnSummary(entry.columns[i], g_blockSummary[i]);
+		}
+	}
+}
+
+void closeDataBlock() {
+	uint32_t numRows = g_numRows - g_blockFirstRow;
+	if (numRows == 0) {
+		return;
+	}
+
+	uint8_t *block = g_dataBuffer.blocks[g_dataBuffer.fillBlockIndex];
+
+	memset(block + g_dataBuffer.fillBlockPosition, 0, CONF_DLOG_BLOCK_SIZE - g_dataBuffer.fillBlockPosition);
+
+	for (int i = 0; i < g_numColumns; ++i) {
+		if (g_blockSummary[i].count > 0) {
+			g_blockSummary[i].mean /= g_blockSummary[i].count;
+		} else {
+			g_blockSummary[i].mean = NAN;
+		}
+	}
+
+	uint8_t *p = putUint32(block, g_blockFirstRow);
+	p = putUint16(p, (uint16_t)numRows);
+	p = putUint16(p, g_dataBuffer.fillBlockPosition - g_blockDataOffset);
+	for (int i = 0; i < g_numColumns; ++i) {
+		p = putFloat(p, g_blockSummary[i].min);
+	}
+	for (int i = 0; i < g_numColumns; ++i) {
+		p = putFloat(p, g_blockSummary[i].max);
+	}
+	for (int i = 0; i < g_numColumns; ++i) {
+		p = putFloat(p, g_blockSummary[i].mean);
+	}
+
+	addBlockToIndex();
+	++g_numBlocks;
+
+	fillBlockDone(g_dataBuffer);
+	openDataBlock();
+}
+
+void writeRowV2(const float *values) {
+	if (CONF_DLOG_BLOCK_SIZE - g_dataBuffer.fillBlockPosition < g_numColumns * (int)VARINT_MAX_SIZE) {
+		closeDataBlock();
+	}
+
+	uint8_t *p = g_dataBuffer.blocks[g_dataBuffer.fillBlockIndex] + g_dataBuffer.fillBlockPosition;
+
+	for (int i = 0; i < g_numColumns; ++i) {
+		float value = values[i];
+		p = writeValue(p, value, g_resolution[i], g_lastCode[i]);
+		if (util::isNaN(value)) {
+			continue;
+		}
+
+		ColumnSummary &summary = g_blockSummary[i];
+		if (summary.count == 0 || value < summary.min) {
+			summary.min = value;
+		}
+		if (summary.count == 0 || value > summary.max) {
+			summary.max = value;
+		}
+		summary.mean += value;
+		++summary.count;
+	}
+
+	g_dataBuffer.fillBlockPosition = p - g_dataBuffer.blocks[g_dataBuffer.fillBlockIndex];
+	++g_numRows;
+}
+
+void writeIndexV2() {
+	uint32_t indexOffset = (1 + g_numBlocks) * CONF_DLOG_BLOCK_SIZE;
+
+	// index starts at the block boundary, drop the opened (empty) data block
+	g_dataBuffer.fillBlockPosition = 0;
+
+	for (int i = 0; i < g_numIndexEntries; ++i) {
+		IndexEntry &entry = g_index[i];
+		writeUint32(entry.firstBlock);
+		writeUint32(entry.firstRow);
+		for (int j = 0; j < g_numColumns; ++j) {
+			writeFloat(entry.columns[j].min);
+		}
+		for (int j = 0; j < g_numColumns; ++j) {
+			writeFloat(entry.columns[j].max);
+		}
+		for (int j = 0; j < g_numColumns; ++j) {
+			writeFloat(entry.columns[j].mean);
+		}
+	}
+
+	writeUint32(indexOffset);
+	writeUint16(g_numIndexEntries);
+	writeUint16(g_blocksPerIndexEntry);
+	writeUint32(g_numRows);
+	writeUint32(MAGIC_INDEX);
+}
+
+bool getPreviewFilePath(const char *filePath, char *previewFilePath) {
+	const char *name = strrchr(filePath, '/');
+	const char *extension = strrchr(filePath, '.');
+
+	size_t length = extension && extension > name ? extension - filePath : strlen(filePath);
+	if (length + sizeof(PREVIEW_FILE_EXTENSION) - 1 > MAX_PATH_LENGTH) {
+		return false;
+	}
+
+	memcpy(previewFilePath, filePath, length);
+	strcpy(previewFilePath + length, PREVIEW_FILE_EXTENSION);
+
+	return true;
+}
+
+void startPreview(uint16_t flags, uint32_t columns) {
+	char previewFilePath[MAX_PATH_LENGTH + 1];
+	if (!getPreviewFilePath(g_filePath, previewFilePath)) {
+		g_previewEnabled = false;
+		return;
+	}
+
+	g_previewFile = SD.open(previewFilePath, FILE_WRITE);
+	if (!g_previewFile) {
+		g_previewEnabled = false;
+		return;
+	}
+
+	if (!g_previewFile.truncate(0)) {
+		g_previewFile.close();
+		g_previewEnabled = false;
+		return;
+	}
+
+	g_previewEnabled = true;
+
+	resetBlocks(g_previewBuffer, g_previewFile);
+
+	writeUint32(g_previewBuffer, MAGIC1);
+	writeUint32(g_previewBuffer, MAGIC_PREVIEW);
+	writeUint16(g_previewBuffer, PREVIEW_VERSION);
+	writeUint16(g_previewBuffer, flags);
+	writeUint32(g_previewBuffer, columns);
+	writeFloat(g_previewBuffer, g_period);
+	writeUint16(g_previewBuffer, g_numColumns);
+	writeUint16(g_previewBuffer, CONF_DLOG_PREVIEW_FACTOR);
+	writeUint16(g_previewBuffer, CONF_DLOG_PREVIEW_LEVELS);
+	writeUint16(g_previewBuffer, 0);
+
+	for (int level = 0; level < CONF_DLOG_PREVIEW_LEVELS; ++level) {
+		g_previewCount[level] = 0;
+		for (int i = 0; i < g_numColumns; ++i) {
+			resetColumnSummary(g_previewSummary[level][i]);
+		}
+	}
+}
+
+void writePreviewRecord(int level) {
+	ColumnSummary *summary = g_previewSummary[level];
+
+	for (int i = 0; i < g_numColumns; ++i) {
+		writeFloat(g_previewBuffer, summary[i].min);
+	}
+	for (int i = 0; i < g_numColumns; ++i) {
+		writeFloat(g_previewBuffer, summary[i].max);
+	}
+	for (int i = 0; i < g_numColumns; ++i) {
+		writeFloat(g_previewBuffer, summary[i].count > 0 ? summary[i].mean : NAN);
+	}
+
+	if (level + 1 < CONF_DLOG_PREVIEW_LEVELS) {
+		for (int i = 0; i < g_numColumns; ++i) {
+			mergeColumnSummary(g_previewSummary[level + 1][i], summary[i]);
+		}
+	}
+
+	g_previewCount[level] = 0;
+	for (int i = 0; i < g_numColumns; ++i) {
+		resetColumnSummary(summary[i]);
+	}
+
+	if (level + 1 < CONF_DLOG_PREVIEW_LEVELS && ++g_previewCount[level + 1] == CONF_DLOG_PREVIEW_FACTOR) {
+		writePreviewRecord(level + 1);
+	}
+}
+
+void addRowToPreview(const float *values) {
+	for (int i = 0; i < g_numColumns; ++i) {
+		if (!util::isNaN(values[i])) {
+			ColumnSummary value;
+			value.min = values[i];
+			value.max = values[i];
+			value.mean = values[i];
+			value.count = 1;
+			mergeColumnSummary(g_previewSummary[0][i], value);
+		}
+	}
+
+	if (++g_previewCount[0] == CONF_DLOG_PREVIEW_FACTOR) {
+		writePreviewRecord(0);
+	}
+}
+
+void writeRow(const float *values) {
+	if (CONF_DLOG_VERSION == VERSION2) {
+		writeRowV2(values);
+	} else {
+		for (int i = 0; i < g_numColumns; ++i) {
+			writeFloat(values[i]);
+		}
+	}
+
+	if (g_previewEnabled) {
+		addRowToPreview(values);
+	}
+
+	++g_totalNumRows;
+}
+
+void initColumns(uint16_t flags) {
+	g_numColumns = 0;
+
+	if (flags & FLAG_JITTER) {
+		g_resolution[g_numColumns++] = 1E-6f;
+	}
+
+	for (int i = 0; i < CH_NUM; ++i) {
+		Channel &channel = Channel::get(i);
+
+		// one ADC step, for the dual range channel it is the step of the low range
+		float uResolution = channel.u.max / AnalogDigitalConverter::ADC_MAX;
+		float iResolution = (channel.hasSupportForCurrentDualRange() ? channel.i.max / 10 : channel.i.max) / AnalogDigitalConverter::ADC_MAX;
+
+		if (g_logVoltage[i]) {
+			g_resolution[g_numColumns++] = uResolution;
+		}
+		if (g_logCurrent[i]) {
+			g_resolution[g_numColumns++] = iResolution;
+		}
+		if (g_logPower[i]) {
+			g_resolution[g_numColumns++] = channel.u.max * iResolution;
+		}
+	}
 }
 
 int startImmediately() {
@@ -160,6 +608,19 @@ int startImmediately() {
 		return err;
 	}
 
+	if (g_dataSource == DATA_SOURCE_ADC) {
+		// samples are taken on I_MON conversions, which are done only while output is on
+		for (int i = 0; i < CH_NUM; ++i) {
+			if (g_logVoltage[i] || g_logCurrent[i] || g_logPower[i]) {
+				g_adcChannelIndex = i;
+				break;
+			}
+		}
+		if (!Channel::get(g_adcChannelIndex).isOutputEnabled()) {
+			return SCPI_ERROR_EXECUTION_ERROR; // @todo find better SCPI error code
+		}
+	}
+
 	g_file = SD.open(g_filePath, FILE_WRITE);
 	if (!g_file) {
 		return SCPI_ERROR_EXECUTION_ERROR; // @todo find better SCPI error code
@@ -171,16 +632,20 @@ int startImmediately() {
 
 	setState(STATE_EXECUTING);
 
+	resetBlocks(g_dataBuffer, g_file);
+
 	writeUint32(MAGIC1);
 	writeUint32(MAGIC2);
 	
-	writeUint16(VERSION);
+	writeUint16(CONF_DLOG_VERSION);
 	
-	if (CONF_DLOG_JITTER) {
-		writeUint16(1);
-	} else {
-		writeUint16(0);
+	uint16_t flags = 0;
+	if (g_dataSource == DATA_SOURCE_ADC) {
+		flags |= FLAG_ADC;
+	} else if (CONF_DLOG_JITTER) {
+		flags |= FLAG_JITTER;
 	}
+	writeUint16(flags);
 	
 	uint32_t columns = 0;
 	for (int iChannel = 0; iChannel < CH_NUM; ++iChannel) {
@@ -200,6 +665,29 @@ int startImmediately() {
 	writeFloat(g_time);
 	writeUint32(datetime::nowUtc());
 
+	initColumns(flags);
+	startPreview(flags, columns);
+
+	if (CONF_DLOG_VERSION == VERSION2) {
+		writeUint16(CONF_DLOG_BLOCK_SIZE);
+		writeUint16(g_numColumns);
+		for (int i = 0; i < g_numColumns; ++i) {
+			writeFloat(g_resolution[i]);
+		}
+
+		// header takes the whole first block, so data blocks are aligned to the SD card sectors
+		while (g_dataBuffer.fillBlockPosition > 0) {
+			writeUint8(0);
+		}
+
+		g_numRows = 0;
+		g_numBlocks = 0;
+		g_numIndexEntries = 0;
+		g_blocksPerIndexEntry = 1;
+		g_blockDataOffset = BLOCK_HEADER_SIZE + g_numColumns * BLOCK_COLUMN_SUMMARY_SIZE;
+		openDataBlock();
+	}
+
 	g_lastTickCount = micros();
 	g_seconds = 0;
 	g_micros = 0;
@@ -208,14 +696,57 @@ int startImmediately() {
 	g_nextTime = 0;
 	g_lastSyncTickCount = g_lastTickCount;
 
-	log(g_lastTickCount);
+	if (g_dataSource == DATA_SOURCE_ADC) {
+		// the first sample is taken at the first ADC conversion
+		g_numSamples = 0;
+		g_lastSampleTime = 0;
+	} else {
+		log(g_lastTickCount);
+	}
 
 	return SCPI_RES_OK;
 }
 
+void writeMeasuredPeriod(File &file) {
+	if (g_numSamples < 2) {
+		return;
+	}
+
+	float period = (float)(g_lastSampleTime / (g_numSamples - 1));
+	uint32_t value;
+	memcpy(&value, &period, 4);
+
+	uint8_t buffer[4];
+	buffer[0] = value & 0xFF;
+	buffer[1] = (value >> 8) & 0xFF;
+	buffer[2] = (value >> 16) & 0xFF;
+	buffer[3] = value >> 24;
+
+	if (file.seek(HEADER_PERIOD_OFFSET)) {
+		file.write(buffer, 4);
+	}
+}
+
 void finishLogging() {
 	setState(STATE_IDLE);
+	if (CONF_DLOG_VERSION == VERSION2) {
+		closeDataBlock();
+		writeIndexV2();
+	}
+	writeAllBlocks(g_dataBuffer);
+	if (g_dataSource == DATA_SOURCE_ADC) {
+		writeMeasuredPeriod(g_file);
+	}
 	g_file.close();
+
+	if (g_previewEnabled) {
+		writeAllBlocks(g_previewBuffer);
+		if (g_dataSource == DATA_SOURCE_ADC) {
+			writeMeasuredPeriod(g_previewFile);
+		}
+		g_previewFile.close();
+		g_previewEnabled = false;
+	}
 	for (int i = 0; i < CH_NUM; ++i) {
 		g_logVoltage[i] = 0;
 		g_logCurrent[i] = 0;
@@ -231,7 +762,7 @@ void abort() {
 	}
 }
 
-void log(uint32_t tickCount) {
+void updateCurrentTime(uint32_t tickCount) {
 	g_micros += tickCount - g_lastTickCount;
 	g_lastTickCount = tickCount;
 
@@ -241,6 +772,39 @@ void log(uint32_t tickCount) {
 	}
 
 	g_currentTime = g_seconds + g_micros * 1E-6;
+}
+
+void getSample(float *values) {
+	for (int i = 0; i < CH_NUM; ++i) {
+		Channel &channel = Channel::get(i);
+
+		float uMon = 0;
+		float iMon = 0;
+
+		if (g_logVoltage[i]) {
+			uMon = channel_dispatcher::getUMonLast(channel);
+			*values++ = uMon;
+		}
+
+		if (g_logCurrent[i]) {
+			iMon = channel_dispatcher::getIMonLast(channel);
+			*values++ = iMon;
+		}
+
+		if (g_logPower[i]) {
+			if (!g_logVoltage[i]) {
+				uMon = channel_dispatcher::getUMonLast(channel);
+			}
+			if (!g_logCurrent[i]) {
+				iMon = channel_dispatcher::getIMonLast(channel);
+			}
+			*values++ = uMon * iMon;
+		}
+	}
+}
+
+void log(uint32_t tickCount) {
+	updateCurrentTime(tickCount);
 
 	if (g_currentTime >= g_nextTime) {
 #if OPTION_WATCHDOG && (EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R3B4 || EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R5B12)
@@ -249,6 +813,8 @@ void log(uint32_t tickCount) {
 
 		float dt = (float)(g_currentTime - g_nextTime);
 
+		float values[MAX_NUM_COLUMNS];
+
 		while (1) {
 			g_nextTime = ++g_iSample * g_period;
 			if (g_currentTime < g_nextTime || g_nextTime > g_time) {
@@ -256,65 +822,63 @@ void log(uint32_t tickCount) {
 			}
 
 			// we missed a sample, write NAN
-#ifdef DLOG_JITTER
-			writeFloat(NAN);
-#endif
-			for (int i = 0; i < CH_NUM; ++i) {
-				Channel &channel = Channel::get(i);
-				if (g_logVoltage[i]) {
-					writeFloat(NAN);
-				}
-				if (g_logCurrent[i]) {
-					writeFloat(NAN);
-				}
-				if (g_logPower[i]) {
-					writeFloat(NAN);
-				}
+			for (int i = 0; i < g_numColumns; ++i) {
+				values[i] = NAN;
 			}
+			writeRow(values);
 		}
 
-
 		// write sample
-#ifdef DLOG_JITTER
-		writeFloat(dt);
+#if CONF_DLOG_JITTER
+		values[0] = dt;
+		getSample(values + 1);
+#else
+		getSample(values);
 #endif
-		for (int i = 0; i < CH_NUM; ++i) {
-			Channel &channel = Channel::get(i);
+		writeRow(values);
 
-			float uMon;
-			float iMon;
+		if (g_nextTime > g_time) {
+			finishLogging();
+		}
 
-			if (g_logVoltage[i]) {
-				uMon = channel_dispatcher::getUMonLast(channel);
-				writeFloat(uMon);
-			}
+#if OPTION_WATCHDOG && (EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R3B4 || EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R5B12)
+		watchdog::enable();
+#endif
+	}
+}
 
-			if (g_logCurrent[i]) {
-				iMon = channel_dispatcher::getIMonLast(channel);
-				writeFloat(iMon);
-			}
+void adcData(Channel &channel, uint32_t tickCount) {
+	if (g_state != STATE_EXECUTING || g_dataSource != DATA_SOURCE_ADC || channel.index - 1 != g_adcChannelIndex) {
+		return;
+	}
 
-			if (g_logPower[i]) {
-				if (!g_logVoltage[i]) {
-					uMon = channel_dispatcher::getUMonLast(channel);
-				}
-				if (!g_logCurrent[i]) {
-					iMon = channel_dispatcher::getIMonLast(channel);
-				}
-				writeFloat(uMon * iMon);
-			}
-		}
+	if (g_numSamples == 0) {
+		// time is measured from the first conversion
+		g_lastTickCount = tickCount;
+	}
+
+	updateCurrentTime(tickCount);
+
+	if (g_currentTime >= g_nextTime) {
+#if OPTION_WATCHDOG && (EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R3B4 || EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R5B12)
+		watchdog::disable();
+#endif
+
+		float values[MAX_NUM_COLUMNS];
+		getSample(values);
+		writeRow(values);
+
+		++g_numSamples;
+		g_lastSampleTime = g_currentTime;
+
+		// if ADC is slower than logging period there is nothing to write for the missed periods
+		do {
+			g_nextTime = ++g_iSample * g_period;
+		} while (g_nextTime <= g_currentTime);
 
 		if (g_nextTime > g_time) {
 			finishLogging();
 		}
-		else {
-			int32_t diff = tickCount - g_lastSyncTickCount;
-			if (diff > CONF_DLOG_SYNC_FILE_TIME * 1000000L) {
-				g_lastSyncTickCount = tickCount;
-				g_file.sync();
-			}
-		}
 
 #if OPTION_WATCHDOG && (EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R3B4 || EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R5B12)
 		watchdog::enable();
@@ -329,10 +893,208 @@ void tick(uint32_t tickCount) {
 			generateError(err);
 		}
 	} else if (g_state == STATE_EXECUTING) {
-		log(tickCount);
+		if (g_dataSource == DATA_SOURCE_TIMER) {
+			log(tickCount);
+		} else if (!Channel::get(g_adcChannelIndex).isOutputEnabled()) {
+			// no more samples will come from ADC
+			finishLogging();
+		}
 	}
 }
 
+void fileTick(uint32_t tickCount) {
+	if (g_state == STATE_EXECUTING) {
+		int32_t diff = tickCount - g_lastSyncTickCount;
+		bool sync = diff > CONF_DLOG_SYNC_FILE_TIME * 1000000L;
+
+		if (isBlockFull(g_dataBuffer) || (g_previewEnabled && isBlockFull(g_previewBuffer)) || sync) {
+#if OPTION_WATCHDOG && (EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R3B4 || EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R5B12)
+			watchdog::disable();
+#endif
+
+			writeFullBlock(g_dataBuffer);
+			if (g_previewEnabled) {
+				writeFullBlock(g_previewBuffer);
+			}
+
+			if (sync) {
+				g_lastSyncTickCount = tickCount;
+				g_file.sync();
+				if (g_previewEnabled) {
+					g_previewFile.sync();
+				}
+			}
+
+#if OPTION_WATCHDOG && (EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R3B4 || EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R5B12)
+			watchdog::enable();
+#endif
+		}
+	}
+}
+
+uint32_t readUint32(const uint8_t *p) {
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+float readFloat(const uint8_t *p) {
+	uint32_t value = readUint32(p);
+	float result;
+	memcpy(&result, &value, 4);
+	return result;
+}
+
+void readPreviewRecord(const uint8_t *p, int numColumns, ColumnSummary *summary) {
+	for (int i = 0; i < numColumns; ++i) {
+		summary[i].min = readFloat(p + 4 * i);
+		summary[i].max = readFloat(p + 4 * (numColumns + i));
+		summary[i].mean = readFloat(p + 4 * (2 * numColumns + i));
+		summary[i].count = util::isNaN(summary[i].mean) ? 0 : 1;
+	}
+}
+
+void outputPreviewPixel(ColumnSummary *summary, int numColumns, void *param, void (*callback)(void *param, const float *values, int count)) {
+	float values[3 * MAX_NUM_COLUMNS];
+	for (int i = 0; i < numColumns; ++i) {
+		if (summary[i].count > 0) {
+			values[3 * i] = summary[i].min;
+			values[3 * i + 1] = summary[i].max;
+			values[3 * i + 2] = summary[i].mean;
+		} else {
+			values[3 * i] = NAN;
+			values[3 * i + 1] = NAN;
+			values[3 * i + 2] = NAN;
+		}
+		resetColumnSummary(summary[i]);
+	}
+	callback(param, values, 3 * numColumns);
+}
+
+bool getPreview(const char *filePath, float from, float to, uint16_t numPixels, void *param, void (*callback)(void *param, const float *values, int count), int *err) {
+	if (sd_card::g_testResult != TEST_OK) {
+		if (err) *err = SCPI_ERROR_MASS_STORAGE_ERROR;
+		return false;
+	}
+
+	char previewFilePath[MAX_PATH_LENGTH + 1];
+	if (!getPreviewFilePath(filePath, previewFilePath)) {
+		if (err) *err = SCPI_ERROR_FILE_NAME_NOT_FOUND;
+		return false;
+	}
+
+	File file = SD.open(previewFilePath, FILE_READ);
+	if (!file) {
+		if (err) *err = SCPI_ERROR_FILE_NAME_NOT_FOUND;
+		return false;
+	}
+
+	uint8_t header[PREVIEW_HEADER_SIZE];
+	if (file.read(header, PREVIEW_HEADER_SIZE) != PREVIEW_HEADER_SIZE || readUint32(header) != MAGIC1 || readUint32(header + 4) != MAGIC_PREVIEW) {
+		file.close();
+		if (err) *err = SCPI_ERROR_MASS_STORAGE_ERROR;
+		return false;
+	}
+
+	float period = readFloat(header + 16);
+	int numColumns = header[20] | (header[21] << 8);
+	uint16_t factor = header[22] | (header[23] << 8);
+	int numLevels = header[24] | (header[25] << 8);
+	if (numColumns > MAX_NUM_COLUMNS || factor < 2 || numLevels < 1) {
+		file.close();
+		if (err) *err = SCPI_ERROR_MASS_STORAGE_ERROR;
+		return false;
+	}
+
+	uint32_t recordSize = numColumns * BLOCK_COLUMN_SUMMARY_SIZE;
+	uint32_t numRecords = (file.size() - PREVIEW_HEADER_SIZE) / recordSize;
+
+	// find the number of level 0 records, i.e. the largest n such that (n - 1)-th record is in the file
+	uint32_t numLevel0Records = 0;
+	uint32_t high = numRecords;
+	while (numLevel0Records < high) {
+		uint32_t middle = numLevel0Records + (high - numLevel0Records + 1) / 2;
+		if (getPreviewRecordPosition(0, middle - 1, factor, numLevels) < numRecords) {
+			numLevel0Records = middle;
+		} else {
+			high = middle - 1;
+		}
+	}
+
+	double fromRow = from / period;
+	double toRow = to / period;
+	if (toRow > (double)numLevel0Records * factor) {
+		toRow = (double)numLevel0Records * factor;
+	}
+
+	// select the coarsest level which still has at least one record per pixel
+	int level = 0;
+	uint32_t rowsPerRecord = factor;
+	uint32_t numLevelRecords = numLevel0Records;
+	while (level + 1 < numLevels && (toRow - fromRow) / (rowsPerRecord * factor) >= numPixels) {
+		++level;
+		rowsPerRecord *= factor;
+		numLevelRecords /= factor;
+	}
+
+	if (err) *err = SCPI_RES_OK;
+
+	callback(param, NULL, 3 * numColumns * numPixels);
+
+	ColumnSummary pixelSummary[MAX_NUM_COLUMNS];
+	for (int i = 0; i < numColumns; ++i) {
+		resetColumnSummary(pixelSummary[i]);
+	}
+
+	double rowsPerPixel = (toRow - fromRow) / numPixels;
+	uint16_t iPixel = 0;
+
+	if (rowsPerPixel > 0) {
+		uint32_t firstRecord = fromRow > 0 ? (uint32_t)(fromRow / rowsPerRecord) : 0;
+		uint32_t lastRecord = (uint32_t)ceil(toRow / rowsPerRecord);
+		if (lastRecord > numLevelRecords) {
+			lastRecord = numLevelRecords;
+		}
+
+		for (uint32_t iRecord = firstRecord; iRecord < lastRecord; ++iRecord) {
+			// record goes to the pixel which contains its middle row
+			double pixel = ((iRecord + 0.5) * rowsPerRecord - fromRow) / rowsPerPixel;
+			if (pixel < 0 || pixel >= numPixels) {
+				continue;
+			}
+
+			while (iPixel < (uint16_t)pixel) {
+				outputPreviewPixel(pixelSummary, numColumns, param, callback);
+				++iPixel;
+			}
+
+			uint8_t record[MAX_NUM_COLUMNS * BLOCK_COLUMN_SUMMARY_SIZE];
+			if (!file.seek(PREVIEW_HEADER_SIZE + getPreviewRecordPosition(level, iRecord, factor, numLevels) * recordSize) ||
+				file.read(record, recordSize) != (int)recordSize) {
+				break;
+			}
+
+			ColumnSummary recordSummary[MAX_NUM_COLUMNS];
+			readPreviewRecord(record, numColumns, recordSummary);
+			for (int i = 0; i < numColumns; ++i) {
+				mergeColumnSummary(pixelSummary[i], recordSummary[i]);
+			}
+		}
+	}
+
+	for (; iPixel < numPixels; ++iPixel) {
+		outputPreviewPixel(pixelSummary, numColumns, param, callback);
+	}
+
+	file.close();
+
+	callback(param, NULL, -1);
+
+	return true;
+}
+
+uint32_t getTotalNumRows() {
+	return g_totalNumRows;
+}
+
 void reset() {
 	abort();
 
@@ -345,6 +1107,7 @@ void reset() {
 	g_period = PERIOD_DEFAULT;
 	g_time = TIME_DEFAULT;
 	g_triggerSource = trigger::SOURCE_IMMEDIATE;
+	g_dataSource = DATA_SOURCE_TIMER;
 	g_filePath[0] = 0;
 }
 
@@ -28,7 +28,14 @@ extern bool g_logVoltage[CH_NUM];
 extern bool g_logCurrent[CH_NUM];
 extern bool g_logPower[CH_NUM];
 
-static const float PERIOD_MIN = 0.02f;
+enum DataSource {
+	DATA_SOURCE_TIMER, // sample the last measured values from the critical tick
+	DATA_SOURCE_ADC // sample the values when they are converted by the ADC
+};
+extern DataSource g_dataSource;
+
+static const float PERIOD_MIN = 0.005f;
+static const float PERIOD_MIN_ADC = 0.001f;
 static const float PERIOD_MAX = 120.0f;
 static const float PERIOD_DEFAULT = 0.02f;
 extern float g_period;
@@ -49,9 +56,27 @@ void triggerGenerated(bool startImmediatelly = true);
 int startImmediately();
 void abort();
 
+static const uint16_t PREVIEW_PIXELS_MAX = 1000;
+
+/// Called from the critical tick, samples are collected here.
 void tick(uint32_t tick_usec);
+/// Called from the main loop, outside of the critical tick, writes collected samples to the file.
+void fileTick(uint32_t tick_usec);
+/// Called from the main loop when new U_MON/I_MON pair is measured on the channel.
+/// @param tick_usec Time when I_MON conversion is finished.
+void adcData(Channel &channel, uint32_t tick_usec);
 void reset();
 
+/// Returns number of rows written to all the DLOG files since boot.
+uint32_t getTotalNumRows();
+
+/// Calculates min/max/mean of every column for every pixel of the time window [from, to]
+/// using the decimation levels from the preview file written next to the DLOG file.
+/// Callback is called once with values == NULL and the total number of values,
+/// then once for every pixel with 3 values (min, max, mean) per column and
+/// finally with values == NULL and count == -1.
+bool getPreview(const char *filePath, float from, float to, uint16_t numPixels, void *param, void (*callback)(void *param, const float *values, int count), int *err);
+
 }
 }
 } // namespace eez::psu::dlog
@@ -0,0 +1,206 @@
+/*
+* EEZ PSU Firmware
+* Copyright (C) 2018-present, Envox d.o.o.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+
+/*
+DLOG file format, shared between the firmware and the host tools.
+All values are little endian.
+
+Version 1:
+    header (28 bytes):
+        uint32 MAGIC1, uint32 MAGIC2, uint16 version, uint16 flags,
+        uint32 columns, float period, float time, uint32 start time
+    rows of float values, one value per column
+
+Version 2:
+    header block (block size bytes, zero padded):
+        the same 28 bytes as in version 1, followed by
+        uint16 block size, uint16 number of columns, float resolution[number of columns]
+    data blocks (block size bytes each, zero padded):
+        uint32 first row, uint16 number of rows, uint16 data length,
+        float min[number of columns], float max[number of columns], float mean[number of columns],
+        data (rows of varints, one varint per column)
+    index (optional, missing if logging was interrupted):
+        index entries:
+            uint32 first block, uint32 first row,
+            float min[number of columns], float max[number of columns], float mean[number of columns]
+        trailer (16 bytes at the end of the file):
+            uint32 index offset, uint16 number of index entries, uint16 blocks per index entry,
+            uint32 number of rows, uint32 MAGIC_INDEX
+
+    Column value is stored as code = round(value / resolution). Varint 0 means NAN,
+    otherwise it is zigzag(code - previous code in the same column) + 1. Previous code
+    is 0 at the start of each block, so every block can be decoded independently.
+
+Preview file (decimation pyramid), written next to the DLOG file with the PREVIEW_FILE_EXTENSION:
+    header (28 bytes):
+        uint32 MAGIC1, uint32 MAGIC_PREVIEW, uint16 version, uint16 flags,
+        uint32 columns, float period, uint16 number of columns, uint16 factor,
+        uint16 number of levels, uint16 reserved
+    records (number of columns * 12 bytes each):
+        float min[number of columns], float max[number of columns], float mean[number of columns]
+
+    Level 0 record summarizes factor rows, level 1 record summarizes factor level 0 records, etc.
+    Records are stored in the order they are produced: level 0 record is followed by the level 1
+    record it completes (if any), which is followed by the level 2 record it completes, etc.,
+    so the position of any record can be calculated with getPreviewRecordPosition.
+    Incomplete records at the end of logging are not stored.
+
+Columns bit mask has 4 bits per channel: bit 0 is voltage, bit 1 is current and bit 2 is power.
+If FLAG_JITTER is set, jitter (in seconds) is the first column.
+*/
+
+namespace eez {
+namespace psu {
+namespace dlog {
+
+static const uint32_t MAGIC1 = 0x2D5A4545L;
+static const uint32_t MAGIC2 = 0x474F4C44L;
+static const uint32_t MAGIC_INDEX = 0x58444944L;
+static const uint32_t MAGIC_PREVIEW = 0x56504C44L;
+
+static const uint16_t VERSION1 = 1;
+static const uint16_t VERSION2 = 2;
+static const uint16_t PREVIEW_VERSION = 1;
+
+static const uint16_t FLAG_JITTER = 0x0001; // every sample starts with jitter column
+static const uint16_t FLAG_ADC = 0x0002; // samples are taken from ADC, period in header is measured average
+
+static const uint32_t HEADER_SIZE_V1 = 28;
+static const uint32_t HEADER_PERIOD_OFFSET = 16;
+
+static const uint32_t BLOCK_HEADER_SIZE = 8;
+static const uint32_t BLOCK_COLUMN_SUMMARY_SIZE = 12;
+static const uint32_t INDEX_ENTRY_HEADER_SIZE = 8;
+static const uint32_t INDEX_TRAILER_SIZE = 16;
+
+static const uint32_t VARINT_MAX_SIZE = 5;
+
+/// Largest absolute code value, keeps zigzag encoded deltas inside uint32.
+static const float CODE_MAX = 1.0E9f;
+
+static const uint32_t PREVIEW_HEADER_SIZE = 28;
+static const char PREVIEW_FILE_EXTENSION[] = ".dlp";
+
+inline uint32_t zigzagEncode(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+inline int32_t zigzagDecode(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+/// Writes varint to the buffer, returns pointer after the last written byte.
+inline uint8_t *writeVarint(uint8_t *p, uint32_t value) {
+    while (value >= 0x80) {
+        *p++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *p++ = (uint8_t)value;
+    return p;
+}
+
+/// Reads varint from the buffer, returns pointer after the last read byte or 0 if buffer end is reached.
+inline const uint8_t *readVarint(const uint8_t *p, const uint8_t *end, uint32_t &value) {
+    value = 0;
+    for (int shift = 0; p < end && shift < 35; shift += 7) {
+        uint8_t byte = *p++;
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return p;
+        }
+    }
+    return 0;
+}
+
+/// Writes column value of the version 2 row and updates the previous code of the column,
+/// returns pointer after the last written byte.
+inline uint8_t *writeValue(uint8_t *p, float value, float resolution, int32_t &lastCode) {
+    if (value != value) {
+        // NAN
+        *p++ = 0;
+        return p;
+    }
+
+    float code = roundf(value / resolution);
+    if (code > CODE_MAX) {
+        code = CODE_MAX;
+    } else if (code < -CODE_MAX) {
+        code = -CODE_MAX;
+    }
+
+    p = writeVarint(p, zigzagEncode((int32_t)code - lastCode) + 1);
+    lastCode = (int32_t)code;
+    return p;
+}
+
+/// Reads column value of the version 2 row and updates the previous code of the column,
+/// returns pointer after the last read byte or 0 if buffer end is reached.
+inline const uint8_t *readValue(const uint8_t *p, const uint8_t *end, float resolution, int32_t &lastCode, float &value) {
+    uint32_t varint;
+    p = readVarint(p, end, varint);
+    if (!p) {
+        return 0;
+    }
+
+    if (varint == 0) {
+        value = NAN;
+    } else {
+        lastCode += zigzagDecode(varint - 1);
+        value = lastCode * resolution;
+    }
+    return p;
+}
+
+inline int getNumColumns(uint32_t columns, uint16_t flags) {
+    int numColumns = flags & FLAG_JITTER ? 1 : 0;
+    for (; columns; columns >>= 1) {
+        if (columns & 1) {
+            ++numColumns;
+        }
+    }
+    return numColumns;
+}
+
+/// Returns position (counted in records) of the index-th record of the level in the preview file.
+inline uint32_t getPreviewRecordPosition(int level, uint32_t index, uint16_t factor, int numLevels) {
+    // level 0 record which completes this record
+    uint32_t level0Index = index + 1;
+    for (int i = 0; i < level; ++i) {
+        level0Index *= factor;
+    }
+    level0Index -= 1;
+
+    // records of the same or lower levels completed by level0Index are before this record,
+    // records of the higher levels completed by level0Index are after this record
+    uint32_t position = 0;
+    uint32_t scale = 1;
+    for (int i = 0; i < numLevels; ++i, scale *= factor) {
+        position += (i <= level ? level0Index + 1 : level0Index) / scale;
+    }
+
+    return position - 1;
+}
+
+}
+}
+} // namespace eez::psu::dlog
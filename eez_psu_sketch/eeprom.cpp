@@ -48,24 +48,6 @@ void read_chunk(uint8_t *buffer, uint16_t buffer_size, uint16_t address) {
     SPI_endTransaction();
 }
 
-void read(uint8_t *buffer, uint16_t buffer_size, uint16_t address) {
-    for (uint16_t i = 0; i < buffer_size; i += 64) {
-        read_chunk(buffer + i, MIN(buffer_size - i, 64), address + i);
-    }
-
-    delay(1);
-
-    uint8_t verifyBuffer[256];
-    uint16_t verifySize = MIN(buffer_size, sizeof(verifyBuffer));
-    for (uint16_t i = 0; i < verifySize; i += 64) {
-        read_chunk(verifyBuffer + i, MIN(buffer_size - i, 64), address + i);
-    }
-
-    if (memcmp(buffer, verifyBuffer, verifySize)) {
-        DebugTrace("EEPROM read verify error");
-    }
-}
-
 bool is_write_in_progress() {
     SPI_beginTransaction(AT25256B_SPI);
     digitalWrite(EEPROM_SELECT, LOW);
@@ -76,7 +58,17 @@ bool is_write_in_progress() {
     return (data & (1 << 0));
 }
 
-void write_chunk(const uint8_t *buffer, uint16_t buffer_size, uint16_t address) {
+void write_disable() {
+    SPI_beginTransaction(AT25256B_SPI);
+    digitalWrite(EEPROM_SELECT, LOW);  // select chip
+    SPI.transfer(WRDI);                // send write disable command
+    digitalWrite(EEPROM_SELECT, HIGH); // deselect chip
+    SPI_endTransaction();
+}
+
+/// Starts programming of the chunk, chunk must not cross the page boundary.
+/// Chip will not accept any command (except RDSR) until write cycle is finished.
+void start_write_chunk(const uint8_t *buffer, uint16_t buffer_size, uint16_t address) {
     SPI_beginTransaction(AT25256B_SPI);
 
     // enable writing
@@ -96,7 +88,9 @@ void write_chunk(const uint8_t *buffer, uint16_t buffer_size, uint16_t address)
 
     digitalWrite(EEPROM_SELECT, HIGH); // release chip
     SPI_endTransaction();
+}
 
+void wait_write_finished() {
     uint32_t s = micros();
     while (is_write_in_progress()) {
         uint32_t e = micros();
@@ -106,39 +100,230 @@ void write_chunk(const uint8_t *buffer, uint16_t buffer_size, uint16_t address)
         }
     }
 
-    // disable writing
-    SPI_beginTransaction(AT25256B_SPI);
-    digitalWrite(EEPROM_SELECT, LOW);  // select chip
-    SPI.transfer(WRDI);                // send write disable command
-    digitalWrite(EEPROM_SELECT, HIGH); // deselect chip
-    SPI_endTransaction();
+    write_disable();
+}
+
+void write_chunk(const uint8_t *buffer, uint16_t buffer_size, uint16_t address) {
+    start_write_chunk(buffer, buffer_size, address);
+    wait_write_finished();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Write-back page cache.
+//
+// write() only updates the cached copy of the affected pages and marks them dirty
+// if their content actually changed, so rewriting the same data costs no write cycles.
+// Dirty pages are programmed one page per tick() after CONF_EEPROM_WRITE_BACK_DELAY_MS
+// of no modifications, so consecutive writes to the same page (e.g. event queue header)
+// are coalesced into the single write cycle. Page which fails the verification after
+// the background write stays dirty and is programmed again.
+// Write-through write() programs and verifies the affected dirty pages at once and
+// reports the failure to the caller.
+
+static const uint16_t NO_PAGE = 0xFFFF;
+
+struct CachePage {
+    uint16_t address;
+    bool dirty;
+    uint32_t lastModifiedTime;
+    uint8_t data[EEPROM_PAGE_SIZE];
+};
+
+static CachePage g_cache[CONF_EEPROM_CACHE_PAGES];
+static bool g_cacheInitialized;
+static int g_nextVictim;
+
+/// Page which is currently programmed by the tick(), -1 if none.
+static int g_writePage = -1;
+static uint32_t g_writeStartTime;
+
+void initCache() {
+    for (int i = 0; i < CONF_EEPROM_CACHE_PAGES; ++i) {
+        g_cache[i].address = NO_PAGE;
+        g_cache[i].dirty = false;
+    }
+    g_cacheInitialized = true;
+}
+
+/// Compares EEPROM content with the page, page is marked dirty again if it differs.
+bool verifyWrittenPage(CachePage &page) {
+    uint8_t verifyBuffer[EEPROM_PAGE_SIZE];
+    read_chunk(verifyBuffer, EEPROM_PAGE_SIZE, page.address);
+    if (memcmp(page.data, verifyBuffer, EEPROM_PAGE_SIZE) != 0) {
+        DebugTraceF("EEPROM write verify failed at address: %d", (int)page.address);
+        page.dirty = true;
+        page.lastModifiedTime = millis();
+        return false;
+    }
+    return true;
+}
+
+/// Waits for the write cycle started by the tick() to finish.
+void finishPageWrite() {
+    if (g_writePage != -1) {
+        wait_write_finished();
+        verifyWrittenPage(g_cache[g_writePage]);
+        g_writePage = -1;
+    }
+}
+
+bool writePage(CachePage &page) {
+    page.dirty = false;
+    write_chunk(page.data, EEPROM_PAGE_SIZE, page.address);
+    return verifyWrittenPage(page);
+}
+
+CachePage *findPage(uint16_t address) {
+    for (int i = 0; i < CONF_EEPROM_CACHE_PAGES; ++i) {
+        if (g_cache[i].address == address) {
+            return &g_cache[i];
+        }
+    }
+    return 0;
+}
+
+CachePage *allocatePage(uint16_t address) {
+    finishPageWrite();
+
+    // prefer free or clean page, evict dirty page (by writing it) only if there is no other choice
+    int victim = -1;
+    for (int i = 0; i < CONF_EEPROM_CACHE_PAGES; ++i) {
+        int j = (g_nextVictim + i) % CONF_EEPROM_CACHE_PAGES;
+        if (g_cache[j].address == NO_PAGE) {
+            victim = j;
+            break;
+        }
+        if (victim == -1 && !g_cache[j].dirty) {
+            victim = j;
+        }
+    }
+
+    if (victim == -1) {
+        victim = g_nextVictim;
+        writePage(g_cache[victim]);
+    }
+
+    g_nextVictim = (victim + 1) % CONF_EEPROM_CACHE_PAGES;
+
+    CachePage &page = g_cache[victim];
+    page.address = address;
+    page.dirty = false;
+    read_chunk(page.data, EEPROM_PAGE_SIZE, address);
+    return &page;
 }
 
-static uint8_t *buffer_verify;
-static uint16_t buffer_verify_size;
+////////////////////////////////////////////////////////////////////////////////
+
+void read(uint8_t *buffer, uint16_t buffer_size, uint16_t address) {
+    if (!g_cacheInitialized) {
+        initCache();
+    }
+
+    finishPageWrite();
+
+    while (buffer_size > 0) {
+        uint16_t pageAddress = address & ~(EEPROM_PAGE_SIZE - 1);
+        uint16_t offset = address - pageAddress;
+        uint16_t size = MIN(buffer_size, EEPROM_PAGE_SIZE - offset);
+
+        CachePage *page = findPage(pageAddress);
+        if (page) {
+            memcpy(buffer, page->data + offset, size);
+        } else {
+            read_chunk(buffer, size, address);
+        }
+
+        buffer += size;
+        buffer_size -= size;
+        address += size;
+    }
+}
+
+bool write(const uint8_t *buffer, uint16_t buffer_size, uint16_t address, bool writeThrough) {
+    if (!g_cacheInitialized) {
+        initCache();
+    }
+
+    bool result = true;
+
+    while (buffer_size > 0) {
+        uint16_t pageAddress = address & ~(EEPROM_PAGE_SIZE - 1);
+        uint16_t offset = address - pageAddress;
+        uint16_t size = MIN(buffer_size, EEPROM_PAGE_SIZE - offset);
+
+        CachePage *page = findPage(pageAddress);
+        if (!page) {
+            page = allocatePage(pageAddress);
+        }
+
+        if (memcmp(page->data + offset, buffer, size) != 0) {
+            if (g_writePage != -1 && page == &g_cache[g_writePage]) {
+                // page is modified while it is programmed, it will be programmed again
+                finishPageWrite();
+            }
+            memcpy(page->data + offset, buffer, size);
+            page->dirty = true;
+            page->lastModifiedTime = millis();
+        }
+
+        if (writeThrough) {
+            if (g_writePage != -1 && page == &g_cache[g_writePage]) {
+                // verified, or marked dirty again, when finished
+                finishPageWrite();
+            }
+            if (page->dirty && !writePage(*page)) {
+                result = false;
+            }
+        }
+
+        buffer += size;
+        buffer_size -= size;
+        address += size;
+    }
+
+    return result;
+}
 
-bool write(const uint8_t *buffer, uint16_t buffer_size, uint16_t address) {
-    for (uint16_t i = 0; i < buffer_size; i += 64) {
-        write_chunk(buffer + i, MIN(buffer_size - i, 64), address + i);
+void tick(uint32_t tick_usec) {
+    if (!g_cacheInitialized) {
+        return;
     }
 
-    if (!buffer_verify || buffer_size > buffer_verify_size) {
-        if (buffer_verify) {
-            free(buffer_verify);
+    if (g_writePage != -1) {
+        if (is_write_in_progress() && tick_usec - g_writeStartTime < 3000) {
+            return;
         }
-        buffer_verify = (uint8_t *)malloc(buffer_size);
-        buffer_verify_size = buffer_size;
-        //DebugTraceF("buffer_verify_size = %u", buffer_verify_size);
+        finishPageWrite();
     }
 
-    read(buffer_verify, buffer_size, address);
+    uint32_t time = millis();
+    for (int i = 0; i < CONF_EEPROM_CACHE_PAGES; ++i) {
+        CachePage &page = g_cache[i];
+        if (page.dirty && time - page.lastModifiedTime >= CONF_EEPROM_WRITE_BACK_DELAY_MS) {
+            // program one page per tick, don't wait for the write cycle to finish
+            page.dirty = false;
+            start_write_chunk(page.data, EEPROM_PAGE_SIZE, page.address);
+            g_writePage = i;
+            g_writeStartTime = tick_usec;
+            break;
+        }
+    }
+}
 
-    if (memcmp(buffer, buffer_verify, buffer_size) == 0) {
+bool flush() {
+    if (!g_cacheInitialized) {
         return true;
     }
 
-    DebugTrace("EEPROM write verify failed!");
-    return false;
+    finishPageWrite();
+
+    bool result = true;
+    for (int i = 0; i < CONF_EEPROM_CACHE_PAGES; ++i) {
+        if (g_cache[i].dirty && !writePage(g_cache[i])) {
+            result = false;
+        }
+    }
+    return result;
 }
 
 void init() {
@@ -162,14 +347,27 @@ bool test() {
             test_buffer[i] = i % 32;
         }
 
-        write(test_buffer, EEPROM_TEST_BUFFER_SIZE, EEPROM_TEST_ADDRESS);
+        if (!g_cacheInitialized) {
+            initCache();
+        }
+
+        // bypass the cache, test must access the chip,
+        // which doesn't accept the write until background page write is finished
+        finishPageWrite();
+        write_chunk(test_buffer, EEPROM_TEST_BUFFER_SIZE, EEPROM_TEST_ADDRESS);
 
         // read buffer from eeprom
         for (uint16_t i = 0; i < EEPROM_TEST_BUFFER_SIZE; ++i) {
             test_buffer[i] = 0;
         }
 
-        read(test_buffer, EEPROM_TEST_BUFFER_SIZE, EEPROM_TEST_ADDRESS);
+        read_chunk(test_buffer, EEPROM_TEST_BUFFER_SIZE, EEPROM_TEST_ADDRESS);
+
+        // clean cached copy of the test page is stale now, dirty one will overwrite the test data
+        CachePage *page = findPage(EEPROM_TEST_ADDRESS);
+        if (page && !page->dirty) {
+            read_chunk(page->data, EEPROM_PAGE_SIZE, page->address);
+        }
 
         // compare it
         g_testResult = psu::TEST_OK;
@@ -42,7 +42,7 @@
 |12288  | 232|[Profile](#profile) 7                     |
 |13312  | 232|[Profile](#profile) 8                     |
 |14336  | 232|[Profile](#profile) 9                     |
-|16384  | 610|[Event Queue](#event-queue)               |
+|16384  |1616|[Event Queue](#event-queue)               |
 
 ## <a name="ontime-counter">ON-time counter</a>
 
@@ -225,10 +225,12 @@
 |------|-----|-------------------------|-----------------------------|
 |0     |4    |int                      |Magic number                 |
 |4     |2    |int                      |Version                      |
-|6     |2    |int                      |Queue head                   |
-|8     |2    |int                      |Queue size                   |
-|10    |2    |int                      |Last error event index       |
-|16    |1600 |[struct](#event)         |Max. 100 events              |
+|6     |2    |int                      |Capacity                     |
+|16    |1600 |[struct](#event)         |Max. 200 events              |
+
+Header is written only when the region is formatted. Events are written one after another
+rotating over the region, head and size of the queue are recovered at boot by finding
+the event which is not followed by the event with the next sequence number.
 
 ## <a name="event">Event</a>
 
@@ -236,6 +238,8 @@
 |------|----|-------------------------|-----------------------------|
 |0     |4   |datetime                 |Event date and time          |
 |4     |2   |int                      |Event ID                     |
+|6     |1   |int                      |Sequence number              |
+|7     |1   |int                      |Bit 7: previous events are read, bits 0-6: checksum |
 
 */
 
@@ -247,6 +251,8 @@ namespace eeprom {
 static const uint16_t EEPROM_TEST_ADDRESS = 0;
 static const uint16_t EEPROM_TEST_BUFFER_SIZE = 64;
 
+static const uint16_t EEPROM_PAGE_SIZE = 64;
+
 // opcodes
 static const uint8_t WREN = 6;
 static const uint8_t WRDI = 4;
@@ -268,7 +274,17 @@ bool test();
 extern TestResult g_testResult;
 
 void read(uint8_t *buffer, uint16_t buffer_size, uint16_t address);
-bool write(const uint8_t *buffer, uint16_t buffer_size, uint16_t address);
+/// Writes to the cache, modified pages are programmed later by tick().
+/// With writeThrough, modified pages are programmed and verified before returning.
+/// @returns false if write-through programming failed verification.
+bool write(const uint8_t *buffer, uint16_t buffer_size, uint16_t address, bool writeThrough = false);
+
+/// Programs dirty cache pages in the background, one page at a time.
+void tick(uint32_t tick_usec);
+
+/// Synchronously programs all dirty cache pages.
+/// @returns false if any page failed verification.
+bool flush();
 
 }
 }
@@ -50,8 +50,19 @@ psu::TestResult g_testResult = psu::TEST_FAILED;
 
 static EthernetServer *server;
 
-static bool g_isConnected = false;
-static EthernetClient g_activeClient;
+struct Session {
+    bool isConnected;
+    EthernetClient client;
+    scpi_reg_val_t psuRegs[SCPI_PSU_REG_COUNT];
+    scpi_psu_t psuContext;
+    char inputBuffer[SCPI_PARSER_INPUT_BUFFER_LENGTH];
+    int16_t errorQueueData[SCPI_PARSER_ERROR_QUEUE_SIZE + 1];
+};
+
+static Session g_sessions[CONF_ETHERNET_MAX_SESSIONS];
+static int g_nextSession;
+static int g_lockOwner = -1;
+static char g_inputChunk[CONF_ETHERNET_INPUT_CHUNK_SIZE];
 //static uint32_t g_lastCheckDhcpLeaseTime;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -68,21 +79,32 @@ size_t ethernet_client_write_str(EthernetClient &client, const char *str) {
     return ethernet_client_write(client, str, strlen(str));
 }
 
+EthernetClient &getClient(scpi_t *context) {
+    return g_sessions[context - g_scpiContext].client;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
+size_t clientWrite(scpi_t *context, const char * data, size_t len) {
+    return ethernet_client_write(getClient(context), data, len);
+}
+
 size_t SCPI_Write(scpi_t *context, const char * data, size_t len) {
-    return ethernet_client_write(g_activeClient, data, len);
+    return scpi::bufferedWrite(context, data, len, clientWrite);
 }
 
 scpi_result_t SCPI_Flush(scpi_t * context) {
+    scpi::flushOutput();
     return SCPI_RES_OK;
 }
 
 int SCPI_Error(scpi_t *context, int_fast16_t err) {
     if (err != 0) {
+        scpi::flushOutput();
+
         char errorOutputBuffer[256];
         sprintf_P(errorOutputBuffer, PSTR("**ERROR: %d,\"%s\"\r\n"), (int16_t)err, SCPI_ErrorTranslate(err));
-        ethernet_client_write(g_activeClient, errorOutputBuffer, strlen(errorOutputBuffer));
+        ethernet_client_write(getClient(context), errorOutputBuffer, strlen(errorOutputBuffer));
 
 		if (err == SCPI_ERROR_INPUT_BUFFER_OVERRUN) {
 			scpi::onBufferOverrun(*context);
@@ -93,6 +115,12 @@ int SCPI_Error(scpi_t *context, int_fast16_t err) {
 }
 
 scpi_result_t SCPI_Control(scpi_t *context, scpi_ctrl_name_t ctrl, scpi_reg_val_t val) {
+    scpi::flushOutput();
+
+    if (SCPI_CTRL_SRQ == ctrl && !((scpi_psu_t *)context->user_context)->notify) {
+        return SCPI_RES_OK;
+    }
+
     char outputBuffer[256];
     if (SCPI_CTRL_SRQ == ctrl) {
         sprintf_P(outputBuffer, PSTR("**SRQ: 0x%X (%d)\r\n"), val, val);
@@ -100,23 +128,43 @@ scpi_result_t SCPI_Control(scpi_t *context, scpi_ctrl_name_t ctrl, scpi_reg_val_
         sprintf_P(outputBuffer, PSTR("**CTRL %02x: 0x%X (%d)\r\n"), ctrl, val, val);
     }
 
-    ethernet_client_write(g_activeClient, outputBuffer, strlen(outputBuffer));
+    ethernet_client_write(getClient(context), outputBuffer, strlen(outputBuffer));
 
     return SCPI_RES_OK;
 }
 
 scpi_result_t SCPI_Reset(scpi_t *context) {
+    scpi::flushOutput();
+
     char errorOutputBuffer[256];
     strcpy_P(errorOutputBuffer, PSTR("**Reset\r\n"));
-    ethernet_client_write(g_activeClient, errorOutputBuffer, strlen(errorOutputBuffer));
+    ethernet_client_write(getClient(context), errorOutputBuffer, strlen(errorOutputBuffer));
 
     return psu::reset() ? SCPI_RES_OK : SCPI_RES_ERR;
 }
 
-////////////////////////////////////////////////////////////////////////////////
+scpi_bool_t SCPI_Check(scpi_t *context) {
+    if (!scpi::isStateChangingCommand(context)) {
+        return TRUE;
+    }
+
+    int sessionIndex = context - g_scpiContext;
 
-static scpi_reg_val_t g_scpiPsuRegs[SCPI_PSU_REG_COUNT];
-static scpi_psu_t g_scpiPsuContext = { g_scpiPsuRegs };
+#if CONF_ETHERNET_LOCK_POLICY == 1
+    if (g_lockOwner == -1) {
+        g_lockOwner = sessionIndex;
+    }
+#endif
+
+    if (g_lockOwner != -1 && g_lockOwner != sessionIndex) {
+        SCPI_ErrorPush(context, SCPI_ERROR_COMMAND_PROTECTED);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
 
 static scpi_interface_t g_scpiInterface = {
     SCPI_Error,
@@ -124,12 +172,75 @@ static scpi_interface_t g_scpiInterface = {
     SCPI_Control,
     SCPI_Flush,
     SCPI_Reset,
+    SCPI_Check,
 };
 
-static char g_scpiInputBuffer[SCPI_PARSER_INPUT_BUFFER_LENGTH];
-static int16_t g_errorQueueData[SCPI_PARSER_ERROR_QUEUE_SIZE + 1];
+scpi_t g_scpiContext[CONF_ETHERNET_MAX_SESSIONS];
+
+////////////////////////////////////////////////////////////////////////////////
+
+int findSession(EthernetClient &client) {
+    for (int i = 0; i < CONF_ETHERNET_MAX_SESSIONS; ++i) {
+        if (g_sessions[i].isConnected && g_sessions[i].client == client) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int findFreeSession() {
+    for (int i = 0; i < CONF_ETHERNET_MAX_SESSIONS; ++i) {
+        if (!g_sessions[i].isConnected) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/// New client starts with the power on state of the SCPI context, not the one left by the previous client.
+void openSession(int sessionIndex, EthernetClient &client) {
+    Session &session = g_sessions[sessionIndex];
+    session.client = client;
+    session.isConnected = true;
+
+    scpi_t *context = &g_scpiContext[sessionIndex];
+    scpi::emptyBuffer(*context);
+    scpi::resetContext(context);
+    scpi::reg_reset(context);
+    session.psuContext.isBufferOverrun = false;
+    session.psuContext.notify = true;
+}
+
+void closeSession(int sessionIndex) {
+    Session &session = g_sessions[sessionIndex];
+    session.isConnected = false;
+    session.client = EthernetClient();
+
+    if (g_lockOwner == sessionIndex) {
+        g_lockOwner = -1;
+    }
+}
+
+/// Reads all the available input of the session and passes it to the SCPI parser.
+void serveSession(int sessionIndex) {
+    Session &session = g_sessions[sessionIndex];
 
-scpi_t g_scpiContext;
+    size_t size;
+    while ((size = session.client.available()) > 0) {
+        if (size > CONF_ETHERNET_INPUT_CHUNK_SIZE) {
+            size = CONF_ETHERNET_INPUT_CHUNK_SIZE;
+        }
+        size = session.client.read((uint8_t *)g_inputChunk, size);
+        SPI_endTransaction();
+        input(g_scpiContext[sessionIndex], g_inputChunk, size);
+        SPI_beginTransaction(ETHERNET_SPI);
+
+        if (!session.isConnected) {
+            // closed while executing the command (see update())
+            break;
+        }
+    }
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -204,11 +315,15 @@ void init() {
 #endif
 #endif
 
-    scpi::init(g_scpiContext,
-        g_scpiPsuContext,
-        &g_scpiInterface,
-        g_scpiInputBuffer, SCPI_PARSER_INPUT_BUFFER_LENGTH,
-        g_errorQueueData, SCPI_PARSER_ERROR_QUEUE_SIZE + 1);
+    for (int i = 0; i < CONF_ETHERNET_MAX_SESSIONS; ++i) {
+        Session &session = g_sessions[i];
+        session.psuContext.registers = session.psuRegs;
+        scpi::init(g_scpiContext[i],
+            session.psuContext,
+            &g_scpiInterface,
+            session.inputBuffer, SCPI_PARSER_INPUT_BUFFER_LENGTH,
+            session.errorQueueData, SCPI_PARSER_ERROR_QUEUE_SIZE + 1);
+    }
 
     //g_lastCheckDhcpLeaseTime = micros();
 }
@@ -244,41 +359,37 @@ void tick(uint32_t tick_usec) {
 
     SPI_beginTransaction(ETHERNET_SPI);
 
-    if (g_isConnected) {
-        if (!g_activeClient.connected()) {
-            g_isConnected = false;
-            g_activeClient = EthernetClient();
-            DebugTrace("Ethernet client lost!");
+    for (int i = 0; i < CONF_ETHERNET_MAX_SESSIONS; ++i) {
+        if (g_sessions[i].isConnected && !g_sessions[i].client.connected()) {
+            closeSession(i);
+            DebugTraceF("Ethernet client %d lost!", i + 1);
         }
     }
 
     EthernetClient client = server->available();
 
-    if (client) {
-        if (!g_isConnected) {
+    if (client && findSession(client) == -1) {
+        int sessionIndex = findFreeSession();
+        if (sessionIndex != -1) {
             client.flush();
-            g_activeClient = client;
-            g_isConnected = true;
-			scpi::emptyBuffer(g_scpiContext);
-            DebugTrace("A new ethernet client detected!");
+            openSession(sessionIndex, client);
+            DebugTraceF("A new ethernet client %d detected!", sessionIndex + 1);
+        } else {
+            SPI_endTransaction();
+            ethernet_client_write_str(client, "**ERROR: too many clients connected\r\n");
+            SPI_beginTransaction(ETHERNET_SPI);
+            client.stop();
+            DebugTrace("Too many clients, new client rejected!");
         }
+    }
 
-        size_t size;
-        while ((size = client.available()) > 0) {
-            uint8_t* msg = (uint8_t*)malloc(size);
-            size = client.read(msg, size);
-            if (client == g_activeClient) {
-                SPI_endTransaction();
-                input(g_scpiContext, (const char *)msg, size);
-                SPI_beginTransaction(ETHERNET_SPI);
-            }
-            else {
-                SPI_endTransaction();
-                ethernet_client_write_str(client, "**ERROR: another client already connected\r\n");
-                SPI_beginTransaction(ETHERNET_SPI);
-                DebugTrace("Another client detected and ignored!");
-            }
-            free(msg);
+    // serve one session with the available input per tick, round-robin
+    for (int i = 0; i < CONF_ETHERNET_MAX_SESSIONS; ++i) {
+        int sessionIndex = (g_nextSession + i) % CONF_ETHERNET_MAX_SESSIONS;
+        if (g_sessions[sessionIndex].isConnected && g_sessions[sessionIndex].client.available() > 0) {
+            serveSession(sessionIndex);
+            g_nextSession = (sessionIndex + 1) % CONF_ETHERNET_MAX_SESSIONS;
+            break;
         }
     }
 
@@ -290,16 +401,47 @@ uint32_t getIpAddress() {
 }
 
 bool isConnected() {
-    return g_isConnected;
+    for (int i = 0; i < CONF_ETHERNET_MAX_SESSIONS; ++i) {
+        if (g_sessions[i].isConnected) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int getSessionNumber(scpi_t *context) {
+    if (context >= g_scpiContext && context < g_scpiContext + CONF_ETHERNET_MAX_SESSIONS) {
+        return context - g_scpiContext + 1;
+    }
+    return 0;
+}
+
+bool requestLock(scpi_t *context) {
+    int sessionIndex = getSessionNumber(context) - 1;
+    if (g_lockOwner == -1) {
+        g_lockOwner = sessionIndex;
+    }
+    return g_lockOwner == sessionIndex;
+}
+
+void releaseLock(scpi_t *context) {
+    if (g_lockOwner == getSessionNumber(context) - 1) {
+        g_lockOwner = -1;
+    }
+}
+
+int getLockOwner() {
+    return g_lockOwner + 1;
 }
 
 void update() {
-    if (g_isConnected) {
-        if (g_activeClient.connected()) {
-            g_activeClient.stop();
-            g_activeClient = EthernetClient();
+    for (int i = 0; i < CONF_ETHERNET_MAX_SESSIONS; ++i) {
+        if (g_sessions[i].isConnected) {
+            if (g_sessions[i].client.connected()) {
+                g_sessions[i].client.stop();
+            }
+            closeSession(i);
         }
-        g_isConnected = false;
     }
 
     g_testResult = psu::TEST_WARNING;
@@ -25,7 +25,7 @@ namespace psu {
 namespace ethernet {
 
 extern TestResult g_testResult;
-extern scpi_t g_scpiContext;
+extern scpi_t g_scpiContext[CONF_ETHERNET_MAX_SESSIONS];
 
 void init();
 bool test();
@@ -34,8 +34,18 @@ void tick(uint32_t tick_usec);
 
 uint32_t getIpAddress();
 
+/// Returns true if at least one client is connected.
 bool isConnected();
 
+/// Returns session number (1 .. CONF_ETHERNET_MAX_SESSIONS) of the SCPI context or 0 if it is not Ethernet session.
+int getSessionNumber(scpi_t *context);
+
+/// Acquires the lock for the state changing commands, returns true if the session holds the lock.
+bool requestLock(scpi_t *context);
+void releaseLock(scpi_t *context);
+/// Returns session number of the lock owner or 0 if nobody holds the lock.
+int getLockOwner();
+
 void update();  
 
 }
@@ -27,15 +27,22 @@ namespace psu {
 namespace event_queue {
 
 static const uint32_t MAGIC = 0xD8152FC3L;
-static const uint16_t VERSION = 4;
+static const uint16_t VERSION = 5;
 
-static const uint16_t MAX_EVENTS = 100;
+static const uint16_t EVENT_HEADER_SIZE = 16;
+static const uint16_t EVENT_RECORDS_SIZE = 1600;
+
+static const uint16_t MAX_EVENTS = EVENT_RECORDS_SIZE / sizeof(EventRecord);
 static const uint16_t NULL_INDEX = MAX_EVENTS;
 
-static const uint16_t EVENT_HEADER_SIZE = 16;
-static const uint16_t EVENT_SIZE = 16;
+static const uint8_t FLAG_READ_MARK = 0x80;
+static const uint8_t CHECKSUM_MASK = 0x7F;
 
-static EventQueueHeader eventQueue;
+static uint16_t g_head; // position of the next record
+static uint16_t g_size;
+static uint8_t g_sequence; // sequence number of the next record
+static uint16_t g_lastErrorEventIndex;
+static bool g_readMarkPending;
 
 static int16_t g_eventsToPush[6];
 static uint8_t g_eventsToPushHead = 0;
@@ -46,93 +53,212 @@ static uint8_t g_pageIndex = 0;
 static Event g_lastErrorEvent;
 static bool g_lastErrorEventChanged;
 
-void readHeader() {
-    eeprom::read((uint8_t *)&eventQueue, sizeof(EventQueueHeader), eeprom::EEPROM_EVENT_QUEUE_START_ADDRESS);
+uint16_t getRecordAddress(uint16_t position) {
+    return eeprom::EEPROM_EVENT_QUEUE_START_ADDRESS + EVENT_HEADER_SIZE + position * sizeof(EventRecord);
 }
 
-void writeHeader() {
-    if (eeprom::g_testResult == psu::TEST_OK) {
-        eeprom::write((uint8_t *)&eventQueue, sizeof(EventQueueHeader), eeprom::EEPROM_EVENT_QUEUE_START_ADDRESS);
+uint8_t calcChecksum(const EventRecord &record) {
+    const uint8_t *p = (const uint8_t *)&record;
+    uint8_t sum = 0;
+    for (unsigned i = 0; i < offsetof(EventRecord, flags); ++i) {
+        sum += p[i];
     }
+    // all zeros or all ones record is never valid
+    return ~sum & CHECKSUM_MASK;
 }
 
-void readEvent(uint16_t eventIndex, Event *e) {
-    eeprom::read((uint8_t *)e, sizeof(Event), eeprom::EEPROM_EVENT_QUEUE_START_ADDRESS + EVENT_HEADER_SIZE + eventIndex * EVENT_SIZE);
+bool readRecord(uint16_t position, EventRecord &record) {
+    eeprom::read((uint8_t *)&record, sizeof(EventRecord), getRecordAddress(position));
+    return (record.flags & CHECKSUM_MASK) == calcChecksum(record);
 }
 
-void writeEvent(uint16_t eventIndex, Event *e) {
-    if (eeprom::g_testResult == psu::TEST_OK) {
-        eeprom::write((uint8_t *)e, sizeof(Event), eeprom::EEPROM_EVENT_QUEUE_START_ADDRESS + EVENT_HEADER_SIZE + eventIndex * EVENT_SIZE);
+void format() {
+    if (eeprom::g_testResult != psu::TEST_OK) {
+        return;
+    }
+
+    uint8_t zeros[64];
+    memset(zeros, 0, sizeof(zeros));
+    for (uint16_t i = 0; i < EVENT_RECORDS_SIZE; i += sizeof(zeros)) {
+        eeprom::write(zeros, MIN(EVENT_RECORDS_SIZE - i, (uint16_t)sizeof(zeros)), getRecordAddress(0) + i);
+    }
+
+    EventQueueHeader header;
+    header.magicNumber = MAGIC;
+    header.version = VERSION;
+    header.capacity = MAX_EVENTS;
+    eeprom::write((uint8_t *)&header, sizeof(EventQueueHeader), eeprom::EEPROM_EVENT_QUEUE_START_ADDRESS);
+}
+
+/// Finds the newest record, i.e. the valid record not followed by the record with the next sequence number,
+/// and then replays the queue from the oldest record to find the last error event.
+void recover() {
+    g_head = 0;
+    g_size = 0;
+    g_sequence = 0;
+    g_lastErrorEventIndex = NULL_INDEX;
+
+    EventRecord first;
+    bool firstValid = readRecord(0, first);
+
+    EventRecord record = first;
+    bool valid = firstValid;
+    int newest = -1;
+    for (uint16_t i = 0; i < MAX_EVENTS; ++i) {
+        EventRecord next;
+        bool nextValid;
+        if (i + 1 < MAX_EVENTS) {
+            nextValid = readRecord(i + 1, next);
+        } else {
+            next = first;
+            nextValid = firstValid;
+        }
+
+        if (valid && !(nextValid && next.sequence == (uint8_t)(record.sequence + 1))) {
+            newest = i;
+            break;
+        }
+
+        record = next;
+        valid = nextValid;
+    }
+
+    if (newest == -1) {
+        return;
+    }
+
+    g_head = (newest + 1) % MAX_EVENTS;
+    g_sequence = record.sequence + 1;
+
+    // count consecutive records backwards from the newest one
+    g_size = 1;
+    uint8_t sequence = record.sequence;
+    while (g_size < MAX_EVENTS) {
+        EventRecord previous;
+        if (!readRecord((newest - g_size + MAX_EVENTS) % MAX_EVENTS, previous) || previous.sequence != (uint8_t)(sequence - 1)) {
+            break;
+        }
+        sequence = previous.sequence;
+        ++g_size;
+    }
+
+    for (uint16_t i = 0; i < g_size; ++i) {
+        uint16_t position = (g_head - g_size + i + MAX_EVENTS) % MAX_EVENTS;
+        readRecord(position, record);
+
+        if (record.flags & FLAG_READ_MARK) {
+            g_lastErrorEventIndex = NULL_INDEX;
+        }
+
+        Event e;
+        e.dateTime = record.dateTime;
+        e.eventId = record.eventId;
+        int eventType = getEventType(&e);
+        if (eventType == EVENT_TYPE_ERROR || eventType == EVENT_TYPE_WARNING && g_lastErrorEventIndex == NULL_INDEX) {
+            g_lastErrorEventIndex = position;
+        }
     }
 }
 
 void init() {
-    readHeader();
     g_lastErrorEventChanged = true;
 
-    if (eventQueue.magicNumber != MAGIC || eventQueue.version != VERSION || eventQueue.head >= MAX_EVENTS || eventQueue.size > MAX_EVENTS) {
-        eventQueue.magicNumber = MAGIC;
-        eventQueue.version = VERSION;
-        eventQueue.head = 0;
-        eventQueue.size = 0;
-        eventQueue.lastErrorEventIndex = NULL_INDEX;
+    EventQueueHeader header;
+    eeprom::read((uint8_t *)&header, sizeof(EventQueueHeader), eeprom::EEPROM_EVENT_QUEUE_START_ADDRESS);
+
+    if (header.magicNumber != MAGIC || header.version != VERSION || header.capacity != MAX_EVENTS) {
+        format();
+
+        g_head = 0;
+        g_size = 0;
+        g_sequence = 0;
+        g_lastErrorEventIndex = NULL_INDEX;
 
         pushEvent(EVENT_INFO_WELCOME);
+    } else {
+        recover();
     }
 }
 
-void doPushEvent(int16_t eventId) {
+void doPushEvent(int16_t eventId, EventRecord &record) {
     Event e;
 
     e.dateTime = datetime::now();
     e.eventId = eventId;
 
-    writeEvent(eventQueue.head, &e);
+    record.dateTime = e.dateTime;
+    record.eventId = e.eventId;
+    record.sequence = g_sequence++;
+    record.flags = calcChecksum(record);
+    if (g_readMarkPending) {
+        record.flags |= FLAG_READ_MARK;
+        g_readMarkPending = false;
+    }
 
-    if (eventQueue.lastErrorEventIndex == eventQueue.head) {
+    if (g_lastErrorEventIndex == g_head) {
         // this event overwrote last error event, therefore:
-        eventQueue.lastErrorEventIndex = NULL_INDEX;
+        g_lastErrorEventIndex = NULL_INDEX;
         g_lastErrorEventChanged = true;
     }
 
     int eventType = getEventType(&e);
-    if (eventType == EVENT_TYPE_ERROR || eventType == EVENT_TYPE_WARNING && eventQueue.lastErrorEventIndex == NULL_INDEX) {
-        eventQueue.lastErrorEventIndex = eventQueue.head;
+    if (eventType == EVENT_TYPE_ERROR || eventType == EVENT_TYPE_WARNING && g_lastErrorEventIndex == NULL_INDEX) {
+        g_lastErrorEventIndex = g_head;
         g_lastErrorEventChanged = true;
     }
 
-    eventQueue.head = (eventQueue.head + 1) % MAX_EVENTS;
-    if (eventQueue.size < MAX_EVENTS) {
-        ++eventQueue.size;
+    g_head = (g_head + 1) % MAX_EVENTS;
+    if (g_size < MAX_EVENTS) {
+        ++g_size;
     }
 
-    writeHeader();
-
-    if (getEventType(&e) == EVENT_TYPE_ERROR) {
+    if (eventType == EVENT_TYPE_ERROR) {
         sound::playBeep();
     }
 }
 
 void tick(uint32_t tick_usec) {
+    if (g_eventsToPushHead == 0) {
+        return;
+    }
+
+    // all pending events are committed with a single EEPROM write (two if the region wraps around)
+    EventRecord records[MAX_EVENTS_TO_PUSH];
+    uint16_t position = g_head;
     for (int i = 0; i < g_eventsToPushHead; ++i) {
-        doPushEvent(g_eventsToPush[i]);
+        doPushEvent(g_eventsToPush[i], records[i]);
+    }
+
+    if (eeprom::g_testResult == psu::TEST_OK) {
+        int n = MIN(g_eventsToPushHead, MAX_EVENTS - position);
+        eeprom::write((uint8_t *)records, n * sizeof(EventRecord), getRecordAddress(position));
+        if (n < g_eventsToPushHead) {
+            eeprom::write((uint8_t *)(records + n), (g_eventsToPushHead - n) * sizeof(EventRecord), getRecordAddress(0));
+        }
     }
+
     g_eventsToPushHead = 0;
 }
 
 int getNumEvents() {
-    return eventQueue.size;
+    return g_size;
+}
+
+void readEvent(uint16_t position, Event *e) {
+    EventRecord record;
+    readRecord(position, record);
+    e->dateTime = record.dateTime;
+    e->eventId = record.eventId;
 }
 
 void getEvent(uint16_t index, Event *e) {
-    uint16_t eventIndex = (eventQueue.head - (index + 1) + MAX_EVENTS) % MAX_EVENTS;
-    readEvent(eventIndex, e);
+    readEvent((g_head - (index + 1) + MAX_EVENTS) % MAX_EVENTS, e);
 }
 
 void getLastErrorEvent(Event *e) {
     if (g_lastErrorEventChanged) {
-        if (eventQueue.lastErrorEventIndex != NULL_INDEX) {
-            readEvent(eventQueue.lastErrorEventIndex, &g_lastErrorEvent);
+        if (g_lastErrorEventIndex != NULL_INDEX) {
+            readEvent(g_lastErrorEventIndex, &g_lastErrorEvent);
         } else {
             g_lastErrorEvent.eventId = EVENT_TYPE_NONE;
         }
@@ -220,10 +346,11 @@ void pushEvent(int16_t eventId) {
 }
 
 void markAsRead() {
-    if (eventQueue.lastErrorEventIndex != NULL_INDEX) {
-        eventQueue.lastErrorEventIndex = NULL_INDEX;
+    if (g_lastErrorEventIndex != NULL_INDEX) {
+        g_lastErrorEventIndex = NULL_INDEX;
         g_lastErrorEventChanged = true;
-        writeHeader();
+        // stored with the next event
+        g_readMarkPending = true;
     }
 }
 
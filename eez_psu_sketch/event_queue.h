@@ -146,12 +146,11 @@ static const int EVENTS_PER_PAGE = 7;
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/// Written only when the event queue region is formatted.
 struct EventQueueHeader {
     uint32_t magicNumber;
     uint16_t version;
-    uint16_t head;
-    uint16_t size;
-    uint16_t lastErrorEventIndex;
+    uint16_t capacity;
 };
 
 struct Event {
@@ -159,6 +158,15 @@ struct Event {
     int16_t eventId;
 };
 
+/// Event as stored in EEPROM. Records are written one after another, rotating over the region,
+/// head and size of the queue are recovered at boot from the sequence numbers.
+struct EventRecord {
+    uint32_t dateTime;
+    int16_t eventId;
+    uint8_t sequence;
+    uint8_t flags; // bit 7: all the previous events are marked as read, bits 0-6: checksum
+};
+
 void init();
 void tick(uint32_t tick_usec);
 
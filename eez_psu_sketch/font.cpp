@@ -119,6 +119,104 @@ void Font::getGlyph(uint8_t requested_encoding, Glyph &glyph) {
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+#if CONF_GUI_GLYPH_CACHE_SIZE > 0
+
+struct GlyphCacheEntry {
+    const uint8_t *data PROGMEM;
+    uint16_t runsOffset;
+};
+
+static GlyphCacheEntry g_glyphCacheEntries[CONF_GUI_GLYPH_CACHE_MAX_GLYPHS];
+static int g_glyphCacheNumEntries;
+
+static uint8_t g_glyphCacheRuns[CONF_GUI_GLYPH_CACHE_SIZE];
+static int g_glyphCacheRunsSize;
+/// Set when a glyph doesn't fit, glyphs already in the cache are kept and all the others
+/// are drawn directly from the font data, so no glyph is decoded again in every frame.
+static bool g_glyphCacheFull;
+
+static bool isGlyphPixelSet(const Glyph &glyph, int widthInBytes, int x, int y) {
+    uint8_t data = arduino_util::prog_read_byte(glyph.data + GLYPH_HEADER_SIZE + y * widthInBytes + x / 8);
+    return (data & (0x80 >> (x % 8))) != 0;
+}
+
+/// Decodes glyph pixels into runs and returns the number of bytes used.
+/// If runs is 0 only the number of bytes needed is returned.
+static int decodeGlyphRuns(const Glyph &glyph, uint8_t *runs) {
+    int widthInBytes = (glyph.width + 7) / 8;
+    int size = 0;
+
+    for (int y = 0; y < glyph.height; ++y) {
+        int numRunsOffset = size++;
+        int numRuns = 0;
+
+        bool foreground = false;
+        int x = 0;
+        do {
+            int length = 0;
+            while (x < glyph.width && isGlyphPixelSet(glyph, widthInBytes, x, y) == foreground) {
+                ++x;
+                ++length;
+            }
+
+            if (runs) {
+                runs[size] = length;
+            }
+            ++size;
+            ++numRuns;
+
+            foreground = !foreground;
+        } while (x < glyph.width);
+
+        if (runs) {
+            runs[numRunsOffset] = numRuns;
+        }
+    }
+
+    return size;
+}
+
+const uint8_t *getGlyphRuns(const Glyph &glyph) {
+    // number of runs in a row must fit in a byte
+    if (glyph.height < CONF_GUI_GLYPH_CACHE_MIN_HEIGHT || glyph.width == 255) {
+        return 0;
+    }
+
+    for (int i = 0; i < g_glyphCacheNumEntries; ++i) {
+        if (g_glyphCacheEntries[i].data == glyph.data) {
+            return g_glyphCacheRuns + g_glyphCacheEntries[i].runsOffset;
+        }
+    }
+
+    if (g_glyphCacheFull) {
+        return 0;
+    }
+
+    int size = decodeGlyphRuns(glyph, 0);
+    if (size > CONF_GUI_GLYPH_CACHE_SIZE) {
+        return 0;
+    }
+
+    if (g_glyphCacheNumEntries == CONF_GUI_GLYPH_CACHE_MAX_GLYPHS || g_glyphCacheRunsSize + size > CONF_GUI_GLYPH_CACHE_SIZE) {
+        g_glyphCacheFull = true;
+        return 0;
+    }
+
+    GlyphCacheEntry &entry = g_glyphCacheEntries[g_glyphCacheNumEntries++];
+    entry.data = glyph.data;
+    entry.runsOffset = g_glyphCacheRunsSize;
+
+    uint8_t *runs = g_glyphCacheRuns + g_glyphCacheRunsSize;
+    decodeGlyphRuns(glyph, runs);
+    g_glyphCacheRunsSize += size;
+
+    return runs;
+}
+
+#endif
+
 }
 }
 }
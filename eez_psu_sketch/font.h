@@ -59,6 +59,15 @@ private:
     const uint8_t * PROGMEM findGlyphData(uint8_t requested_encoding);
     void fillGlyphParameters(Glyph &glyph);
 };
+
+#if CONF_GUI_GLYPH_CACHE_SIZE > 0
+/// Returns glyph pixels decoded into horizontal runs, decoding the glyph into the cache on first use.
+/// Every glyph row starts with the number of runs followed by the run lengths,
+/// runs alternate between background and foreground starting with background (possibly of zero length).
+/// Returns 0 if glyph is not cached.
+const uint8_t *getGlyphRuns(const Glyph &glyph);
+#endif
+
 }
 }
 }
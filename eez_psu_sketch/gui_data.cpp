@@ -676,6 +676,717 @@ static bool isPMonData(const Cursor &cursor, uint8_t id) {
     return id == DATA_ID_CHANNEL_P_MON || isDisplayValue(cursor, id, DISPLAY_VALUE_POWER);
 }
 
+/*
+We are auto generating model name from the channels definition:
+
+<cnt>/<volt>/<curr>[-<cnt2>/<volt2>/<curr2>] (<platform>)
+
+Where is:
+
+<cnt>      - number of the equivalent channels
+<volt>     - max. voltage
+<curr>     - max. curr
+<platform> - Mega, Due, Simulator or Unknown
+*/
+const char *getModelInfo() {
+    static char model_info[CH_NUM * (sizeof("XX V / XX A") - 1) + CH_NUM * (sizeof(" - ") - 1) + 1];
+
+    if (*model_info == 0) {
+        char *p = Channel::getChannelsInfoShort(model_info);
+        *p = 0;
+    }
+
+    return model_info;
+}
+
+const char *getFirmwareInfo() {
+    static const char FIRMWARE_LABEL[] PROGMEM = "Firmware: ";
+    static char firmware_info[sizeof(FIRMWARE_LABEL) - 1 + sizeof(FIRMWARE) - 1 + 1];
+
+    if (*firmware_info == 0) {
+        strcat_P(firmware_info, FIRMWARE_LABEL);
+        strcat_P(firmware_info, PSTR(FIRMWARE));
+    }
+
+    return firmware_info;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static Channel &getChannel(const Cursor &cursor) {
+    int iChannel = cursor.i >= 0 ? cursor.i : (g_channel ? (g_channel->index - 1) : 0);
+    return Channel::get(iChannel);
+}
+
+static int getChannelStatusCode(Channel &channel) {
+    return channel.index > CH_NUM ? 0 : (channel.isOk() ? 1 : 2);
+}
+
+static ChannelSnapshot &getChannelSnapshot(Channel &channel) {
+    ChannelSnapshot &channelSnapshot = g_channelSnapshot[channel.index - 1];
+    uint32_t currentTime = micros();
+    if (!channelSnapshot.lastSnapshotTime || currentTime - channelSnapshot.lastSnapshotTime >= CONF_GUI_REFRESH_EVERY_MS * 1000UL) {
+        char *mode_str = channel.getCvModeStr();
+        channelSnapshot.mode = 0;
+        float uMon = channel_dispatcher::getUMon(channel);
+        float iMon = channel_dispatcher::getIMon(channel);
+        if (strcmp(mode_str, "CC") == 0) {
+            channelSnapshot.monValue = Value(uMon, VALUE_TYPE_FLOAT_VOLT, channel.index-1);
+        } else if (strcmp(mode_str, "CV") == 0) {
+            channelSnapshot.monValue = Value(iMon, VALUE_TYPE_FLOAT_AMPER, channel.index-1);
+        } else {
+            channelSnapshot.mode = 1;
+            if (uMon < iMon) {
+                channelSnapshot.monValue = Value(uMon, VALUE_TYPE_FLOAT_VOLT, channel.index-1);
+            } else {
+                channelSnapshot.monValue = Value(iMon, VALUE_TYPE_FLOAT_AMPER, channel.index-1);
+            }
+        }
+
+        channelSnapshot.pMon = util::multiply(uMon, iMon, getPrecision(VALUE_TYPE_FLOAT_WATT));
+
+        channelSnapshot.lastSnapshotTime = currentTime;
+    }
+    return channelSnapshot;
+}
+
+static unsigned getDisplayValue(uint8_t id, Channel &channel) {
+    return id == DATA_ID_CHANNEL_DISPLAY_VALUE1 ? channel.flags.displayValue1 : channel.flags.displayValue2;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static Value getChannelsViewMode(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return Value(persist_conf::devConf.flags.channelsViewMode);
+}
+
+static Value getChannelCouplingIsAllowed(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return data::Value(channel_dispatcher::isCouplingOrTrackingAllowed() ? 1 : 0);
+}
+
+static Value getChannelCouplingMode(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return data::Value(channel_dispatcher::getType());
+}
+
+static Value getChannelIsCoupled(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return data::Value(channel_dispatcher::isCoupled() ? 1 : 0);
+}
+
+static Value getChannelIsTracked(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return data::Value(channel_dispatcher::isTracked() ? 1 : 0);
+}
+
+static Value getChannelIsCoupledOrTracked(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return data::Value(channel_dispatcher::isCoupled() || channel_dispatcher::isTracked() ? 1 : 0);
+}
+
+static Value getChannelCouplingIsSeries(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return data::Value(channel_dispatcher::isSeries() ? 1 : 0);
+}
+
+static Value getChannelStatus(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return Value(getChannelStatusCode(channel));
+}
+
+static Value getChannelOutputState(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return Value(channel.isOutputEnabled() ? 1 : 0);
+}
+
+static Value getChannelOutputMode(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return Value(getChannelSnapshot(channel).mode);
+}
+
+static Value getEditEnabled(const Cursor &cursor, uint8_t id, Channel &channel) {
+    if ((channel_dispatcher::getVoltageTriggerMode(channel) != TRIGGER_MODE_FIXED && !trigger::isIdle()) || isPageActiveOrOnStack(PAGE_ID_CH_SETTINGS_LISTS)) {
+        return 0;
+    }
+    if (psu::calibration::isEnabled()) {
+        return 0;
+    }
+    return 1;
+}
+
+static Value getTriggerIsInitiated(const Cursor &cursor, uint8_t id, Channel &channel) {
+    bool isInitiated = trigger::isInitiated();
+#if OPTION_SD_CARD
+    if (!isInitiated && dlog::isInitiated()) {
+        isInitiated = true;
+    }
+#endif
+    return Value(isInitiated ? 1 : 0);
+}
+
+static Value getTriggerIsManual(const Cursor &cursor, uint8_t id, Channel &channel) {
+    bool isManual = trigger::getSource() == trigger::SOURCE_MANUAL;
+#if OPTION_SD_CARD
+    if (!isManual && dlog::g_triggerSource == trigger::SOURCE_MANUAL) {
+        isManual = true;
+    }
+#endif
+    return Value(isManual ? 1 : 0);
+}
+
+static Value getChannelMonValue(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return getChannelSnapshot(channel).monValue;
+}
+
+static Value getChannelUSet(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return Value(channel_dispatcher::getUSet(channel), VALUE_TYPE_FLOAT_VOLT, channel.index-1);
+}
+
+static Value getChannelUEdit(const Cursor &cursor, uint8_t id, Channel &channel) {
+    if ((g_focusCursor == cursor || channel_dispatcher::isCoupled()) && g_focusDataId == DATA_ID_CHANNEL_U_EDIT && g_focusEditValue.getType() != VALUE_TYPE_NONE) {
+        return g_focusEditValue;
+    } else {
+        return Value(channel_dispatcher::getUSet(channel), VALUE_TYPE_FLOAT_VOLT, channel.index-1);
+    }
+}
+
+static Value getChannelUMon(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return Value(channel_dispatcher::getUMon(channel), VALUE_TYPE_FLOAT_VOLT, channel.index-1);
+}
+
+static Value getChannelUMonDac(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return Value(channel_dispatcher::getUMonDac(channel), VALUE_TYPE_FLOAT_VOLT, channel.index-1);
+}
+
+static Value getChannelULimit(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return Value(channel_dispatcher::getULimit(channel), VALUE_TYPE_FLOAT_VOLT, channel.index-1);
+}
+
+static Value getChannelISet(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return Value(channel_dispatcher::getISet(channel), VALUE_TYPE_FLOAT_AMPER, channel.index-1);
+}
+
+static Value getChannelIEdit(const Cursor &cursor, uint8_t id, Channel &channel) {
+    if ((g_focusCursor == cursor || channel_dispatcher::isCoupled()) && g_focusDataId == DATA_ID_CHANNEL_I_EDIT && g_focusEditValue.getType() != VALUE_TYPE_NONE) {
+        return g_focusEditValue;
+    } else {
+        return Value(channel_dispatcher::getISet(channel), VALUE_TYPE_FLOAT_AMPER, channel.index-1);
+    }
+}
+
+static Value getChannelIMon(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return Value(channel_dispatcher::getIMon(channel), VALUE_TYPE_FLOAT_AMPER, channel.index-1);
+}
+
+static Value getChannelIMonDac(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return Value(channel_dispatcher::getIMonDac(channel), VALUE_TYPE_FLOAT_AMPER, channel.index-1);
+}
+
+static Value getChannelILimit(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return Value(channel_dispatcher::getILimit(channel), VALUE_TYPE_FLOAT_VOLT, channel.index-1);
+}
+
+static Value getChannelPMon(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return Value(getChannelSnapshot(channel).pMon, VALUE_TYPE_FLOAT_WATT, channel.index-1);
+}
+
+static Value getChannelDisplayValue(const Cursor &cursor, uint8_t id, Channel &channel) {
+    switch (getDisplayValue(id, channel)) {
+    case DISPLAY_VALUE_VOLTAGE: return getChannelUMon(cursor, id, channel);
+    case DISPLAY_VALUE_CURRENT: return getChannelIMon(cursor, id, channel);
+    case DISPLAY_VALUE_POWER: return getChannelPMon(cursor, id, channel);
+    }
+    return Value();
+}
+
+static Value getLrip(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return Value(channel.flags.lrippleEnabled ? 1 : 0);
+}
+
+static Value getChannelRprogStatus(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return Value(channel.flags.rprogEnabled ? 1 : 0);
+}
+
+static Value getOvp(const Cursor &cursor, uint8_t id, Channel &channel) {
+    unsigned ovp;
+    if (!channel.prot_conf.flags.u_state) ovp = 0;
+    else if (!channel_dispatcher::isOvpTripped(channel)) ovp = 1;
+    else ovp = 2;
+    return Value(ovp);
+}
+
+static Value getOcp(const Cursor &cursor, uint8_t id, Channel &channel) {
+    unsigned ocp;
+    if (!channel.prot_conf.flags.i_state) ocp = 0;
+    else if (!channel_dispatcher::isOcpTripped(channel)) ocp = 1;
+    else ocp = 2;
+    return Value(ocp);
+}
+
+static Value getOpp(const Cursor &cursor, uint8_t id, Channel &channel) {
+    unsigned opp;
+    if (!channel.prot_conf.flags.p_state) opp = 0;
+    else if (!channel_dispatcher::isOppTripped(channel)) opp = 1;
+    else opp = 2;
+    return Value(opp);
+}
+
+static Value getOtpCh(const Cursor &cursor, uint8_t id, Channel &channel) {
+#if EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R1B9
+    return 0;
+#elif EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R3B4 || EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R5B12
+    temperature::TempSensorTemperature &tempSensor = temperature::sensors[temp_sensor::CH1 + channel.index - 1];
+    if (!tempSensor.isInstalled() || !tempSensor.isTestOK() || !tempSensor.prot_conf.state) return 0;
+    else if (!channel_dispatcher::isOtpTripped(channel)) return 1;
+    else return 2;
+#endif
+}
+
+static Value getChannelLabel(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return data::Value(channel.index, VALUE_TYPE_CHANNEL_LABEL);
+}
+
+static Value getChannelShortLabel(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return data::Value(channel.index, VALUE_TYPE_CHANNEL_SHORT_LABEL);
+}
+
+static Value getChannelTempStatus(const Cursor &cursor, uint8_t id, Channel &channel) {
+#if EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R1B9
+    return 2;
+#elif EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R3B4 || EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R5B12
+    temperature::TempSensorTemperature &tempSensor = temperature::sensors[temp_sensor::CH1 + channel.index - 1];
+    if (tempSensor.isInstalled()) return tempSensor.isTestOK() ? 1 : 0;
+    else return 2;
+#endif
+}
+
+static Value getChannelTemp(const Cursor &cursor, uint8_t id, Channel &channel) {
+    float temperature = 0;
+#if EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R3B4 || EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R5B12
+    temperature::TempSensorTemperature &tempSensor = temperature::sensors[temp_sensor::CH1 + channel.index - 1];
+    if (tempSensor.isInstalled() && tempSensor.isTestOK()) {
+        temperature = tempSensor.temperature;
+    }
+#endif
+    return data::Value(temperature, VALUE_TYPE_FLOAT_CELSIUS);
+}
+
+static Value getChannelOnTimeTotal(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return data::Value((uint32_t)channel.onTimeCounter.getTotalTime(), VALUE_TYPE_ON_TIME_COUNTER);
+}
+
+static Value getChannelOnTimeLast(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return data::Value((uint32_t)channel.onTimeCounter.getLastTime(), VALUE_TYPE_ON_TIME_COUNTER);
+}
+
+static Value getChannelHasSupportForCurrentDualRange(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return data::Value(channel.hasSupportForCurrentDualRange() ? 1 : 0);
+}
+
+static Value getChannelListCountdown(const Cursor &cursor, uint8_t id, Channel &channel) {
+    int32_t remaining;
+    uint32_t total;
+    if (list::getCurrentDwellTime(channel, remaining, total) && total >= CONF_LIST_COUNDOWN_DISPLAY_THRESHOLD) {
+        return Value((uint32_t)remaining, VALUE_TYPE_COUNTDOWN);
+    } else {
+        return Value();
+    }
+}
+
+static Value getChannelIsVoltageBalanced(const Cursor &cursor, uint8_t id, Channel &channel) {
+    if (channel_dispatcher::isSeries()) {
+        return Channel::get(0).isVoltageBalanced() || Channel::get(1).isVoltageBalanced() ? 1 : 0;
+    } else {
+        return 0;
+    }
+}
+
+static Value getChannelIsCurrentBalanced(const Cursor &cursor, uint8_t id, Channel &channel) {
+    if (channel_dispatcher::isParallel()) {
+        return Channel::get(0).isCurrentBalanced() || Channel::get(1).isCurrentBalanced() ? 1 : 0;
+    } else {
+        return 0;
+    }
+}
+
+static Value getOtpAux(const Cursor &cursor, uint8_t id, Channel &channel) {
+    temperature::TempSensorTemperature &tempSensor = temperature::sensors[temp_sensor::AUX];
+    if (!tempSensor.prot_conf.state) return 0;
+    else if (!tempSensor.isTripped()) return 1;
+    else return 2;
+}
+
+static Value getSysPasswordIsSet(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return data::Value(strlen(persist_conf::devConf2.systemPassword) > 0 ? 1 : 0);
+}
+
+static Value getSysRlState(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return data::Value(g_rlState);
+}
+
+static Value getSysTempAuxStatus(const Cursor &cursor, uint8_t id, Channel &channel) {
+    temperature::TempSensorTemperature &tempSensor = temperature::sensors[temp_sensor::AUX];
+    if (tempSensor.isInstalled()) return tempSensor.isTestOK() ? 1 : 0;
+    else return 2;
+}
+
+static Value getSysTempAux(const Cursor &cursor, uint8_t id, Channel &channel) {
+    float auxTemperature = 0;
+    temperature::TempSensorTemperature &tempSensor = temperature::sensors[temp_sensor::AUX];
+    if (tempSensor.isInstalled() && tempSensor.isTestOK()) {
+        auxTemperature = tempSensor.temperature;
+    }
+    return data::Value(auxTemperature, VALUE_TYPE_FLOAT_CELSIUS);
+}
+
+static Value getAlertMessage(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return g_alertMessage;
+}
+
+static Value getAlertMessage2(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return g_alertMessage2;
+}
+
+static Value getAlertMessage3(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return g_alertMessage3;
+}
+
+static Value getModelInfoData(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return Value(getModelInfo());
+}
+
+static Value getFirmwareInfoData(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return Value(getFirmwareInfo());
+}
+
+static Value getSerialStatus(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return data::Value(serial::g_testResult);
+}
+
+static Value getEthernetInstalled(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return data::Value(OPTION_ETHERNET);
+}
+
+#if OPTION_ETHERNET
+static Value getEthernetStatus(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return data::Value(ethernet::g_testResult);
+}
+
+static Value getEthernetIsConnected(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return data::Value(ethernet::isConnected());
+}
+#endif
+
+static Value getSysEncoderInstalled(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return data::Value(OPTION_ENCODER);
+}
+
+static Value getSysDisplayState(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return data::Value(persist_conf::devConf2.flags.displayState);
+}
+
+static Value getTextMessage(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return data::Value(getTextMessageVersion(), VALUE_TYPE_TEXT_MESSAGE);
+}
+
+static Value getSerialIsConnected(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return data::Value(serial::isConnected());
+}
+
+static Value getAsyncOperationThrobber(const Cursor &cursor, uint8_t id, Channel &channel) {
+    static char *throbber[] = {"|", "/", "-", "\\", "|", "/", "-", "\\"};
+    return data::Value(throbber[(millis() % 1000) / 125]);
+}
+
+static Value getProgress(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return g_progress;
+}
+
+static Value getIoPinsInhibitState(const Cursor &cursor, uint8_t id, Channel &channel) {
+    persist_conf::IOPin &inputPin = persist_conf::devConf2.ioPins[0];
+    if (inputPin.function == io_pins::FUNCTION_INHIBIT) {
+        return data::Value(io_pins::isInhibited() ? 1 : 0);
+    } else {
+        return data::Value(2);
+    }
+}
+
+static Value getViewStatus(const Cursor &cursor, uint8_t id, Channel &channel) {
+#if OPTION_SD_CARD
+    bool listStatusVisible = list::anyCounterVisible(CONF_LIST_COUNDOWN_DISPLAY_THRESHOLD);
+    bool dlogStatusVisible = !dlog::isIdle();
+    if (listStatusVisible && dlogStatusVisible) {
+        return data::Value(micros() % (2 * 1000000UL) < 1000000UL ? 1 : 2);
+    }
+    else if (listStatusVisible) {
+        return data::Value(1);
+    }
+    else if (dlogStatusVisible) {
+        return data::Value(2);
+    }
+#else
+    if (list::anyCounterVisible(CONF_LIST_COUNDOWN_DISPLAY_THRESHOLD)) {
+        return data::Value(1);
+    }
+#endif
+    return data::Value(0);
+}
+
+#if OPTION_SD_CARD
+static Value getDlogStatus(const Cursor &cursor, uint8_t id, Channel &channel) {
+    if (dlog::isInitiated()) {
+        return data::Value(PSTR("Dlog trigger waiting"));
+    } else if (!dlog::isIdle()) {
+        return data::Value((uint32_t)floor(dlog::g_currentTime), VALUE_TYPE_DLOG_STATUS);
+    }
+    return Value();
+}
+#endif
+
+static Value getEditValueMin(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return edit_mode::getMin();
+}
+
+static Value getEditValueMax(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return edit_mode::getMax();
+}
+
+static Value getChannelUMin(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return Value(channel_dispatcher::getUMin(channel), VALUE_TYPE_FLOAT_VOLT, channel.index-1);
+}
+
+static Value getChannelUMax(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return Value(channel_dispatcher::getUMax(channel), VALUE_TYPE_FLOAT_VOLT, channel.index-1);
+}
+
+static Value getChannelIMin(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return Value(channel_dispatcher::getIMin(channel), VALUE_TYPE_FLOAT_AMPER, channel.index-1);
+}
+
+static Value getChannelIMax(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return Value(channel_dispatcher::getIMax(channel), VALUE_TYPE_FLOAT_AMPER, channel.index-1);
+}
+
+static Value getChannelPLimit(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return Value(channel_dispatcher::getPowerLimit(channel), VALUE_TYPE_FLOAT_WATT, channel.index-1);
+}
+
+static Value getChannelPMin(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return Value(channel_dispatcher::getPowerMinLimit(channel), VALUE_TYPE_FLOAT_WATT, channel.index-1);
+}
+
+static Value getChannelPMax(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return Value(channel_dispatcher::getPowerMaxLimit(channel), VALUE_TYPE_FLOAT_WATT, channel.index-1);
+}
+
+static Value getChannelIRangeLimit(const Cursor &cursor, uint8_t id, Channel &channel) {
+    return Value(channel_dispatcher::getILimit(channel), VALUE_TYPE_FLOAT_AMPER, channel.index-1);
+}
+
+static Value getChannelDisplayValueMin(const Cursor &cursor, uint8_t id, Channel &channel) {
+    switch (getDisplayValue(id, channel)) {
+    case DISPLAY_VALUE_VOLTAGE: return getChannelUMin(cursor, id, channel);
+    case DISPLAY_VALUE_CURRENT: return getChannelIMin(cursor, id, channel);
+    case DISPLAY_VALUE_POWER: return getChannelPMin(cursor, id, channel);
+    }
+    return Value();
+}
+
+static Value getChannelDisplayValueMax(const Cursor &cursor, uint8_t id, Channel &channel) {
+    switch (getDisplayValue(id, channel)) {
+    case DISPLAY_VALUE_VOLTAGE: return getChannelUMax(cursor, id, channel);
+    case DISPLAY_VALUE_CURRENT: return getChannelIMax(cursor, id, channel);
+    case DISPLAY_VALUE_POWER: return getChannelPMax(cursor, id, channel);
+    }
+    return Value();
+}
+
+static Value getChannelDisplayValueLimit(const Cursor &cursor, uint8_t id, Channel &channel) {
+    switch (getDisplayValue(id, channel)) {
+    case DISPLAY_VALUE_VOLTAGE: return getChannelULimit(cursor, id, channel);
+    case DISPLAY_VALUE_CURRENT: return getChannelIRangeLimit(cursor, id, channel);
+    case DISPLAY_VALUE_POWER: return getChannelPLimit(cursor, id, channel);
+    }
+    return Value();
+}
+
+static bool setChannelU(const Cursor &cursor, uint8_t id, Channel &channel, Value value, int16_t *error) {
+    int iChannel = channel.index - 1;
+
+    if (!util::between(value.getFloat(), channel_dispatcher::getUMin(channel), channel_dispatcher::getUMax(channel), VALUE_TYPE_FLOAT_VOLT, iChannel)) {
+        if (error) *error = SCPI_ERROR_DATA_OUT_OF_RANGE;
+        return false;
+    }
+
+    if (util::greater(value.getFloat(), channel_dispatcher::getULimit(channel), VALUE_TYPE_FLOAT_VOLT, iChannel)) {
+        if (error) *error = SCPI_ERROR_VOLTAGE_LIMIT_EXCEEDED;
+        return false;
+    }
+
+    if (util::greater(value.getFloat() * channel_dispatcher::getISetUnbalanced(channel), channel_dispatcher::getPowerLimit(channel), VALUE_TYPE_FLOAT_WATT, iChannel)) {
+        if (error) *error = SCPI_ERROR_POWER_LIMIT_EXCEEDED;
+        return false;
+    }
+
+    channel_dispatcher::setVoltage(channel, value.getFloat());
+
+    return true;
+}
+
+static bool setChannelI(const Cursor &cursor, uint8_t id, Channel &channel, Value value, int16_t *error) {
+    int iChannel = channel.index - 1;
+
+    if (!util::between(value.getFloat(), channel_dispatcher::getIMin(channel), channel_dispatcher::getIMax(channel), VALUE_TYPE_FLOAT_AMPER, iChannel)) {
+        if (error) *error = SCPI_ERROR_DATA_OUT_OF_RANGE;
+        return false;
+    }
+
+    if (util::greater(value.getFloat(), channel_dispatcher::getILimit(channel), VALUE_TYPE_FLOAT_AMPER, iChannel)) {
+        if (error) *error = SCPI_ERROR_CURRENT_LIMIT_EXCEEDED;
+        return false;
+    }
+
+    if (util::greater(value.getFloat() * channel_dispatcher::getUSetUnbalanced(channel), channel_dispatcher::getPowerLimit(channel), VALUE_TYPE_FLOAT_VOLT, iChannel)) {
+        if (error) *error = SCPI_ERROR_POWER_LIMIT_EXCEEDED;
+        return false;
+    }
+
+    channel_dispatcher::setCurrent(channel, value.getFloat());
+
+    return true;
+}
+
+static bool setAlertMessage(const Cursor &cursor, uint8_t id, Channel &channel, Value value, int16_t *error) {
+    g_alertMessage = value;
+    return true;
+}
+
+static bool setAlertMessage2(const Cursor &cursor, uint8_t id, Channel &channel, Value value, int16_t *error) {
+    g_alertMessage2 = value;
+    return true;
+}
+
+static bool setAlertMessage3(const Cursor &cursor, uint8_t id, Channel &channel, Value value, int16_t *error) {
+    g_alertMessage3 = value;
+    return true;
+}
+
+static bool setEditSteps(const Cursor &cursor, uint8_t id, Channel &channel, Value value, int16_t *error) {
+    edit_mode_step::setStepIndex(value.getInt());
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+typedef Value (*GetDataFunction)(const Cursor &cursor, uint8_t id, Channel &channel);
+typedef bool (*SetDataFunction)(const Cursor &cursor, uint8_t id, Channel &channel, Value value, int16_t *error);
+
+/// Data item is handled only if the cursor channel is installed and OK,
+/// otherwise lookup continues with the active page, keypad, etc.
+static const uint8_t DATA_ITEM_FLAG_CHANNEL_OK = 1;
+
+/// Data handled directly by gui::data, i.e. not by the page, keypad, edit mode or calibration.
+struct DataItem {
+    uint8_t id;
+    uint8_t flags;
+    ValueType unit;
+    GetDataFunction get;
+    SetDataFunction set;
+    GetDataFunction getMin;
+    GetDataFunction getMax;
+    GetDataFunction getLimit;
+};
+
+static const DataItem g_dataItems[] = {
+    {DATA_ID_CHANNELS_VIEW_MODE, 0, VALUE_TYPE_NONE, getChannelsViewMode, 0, 0, 0, 0},
+    {DATA_ID_CHANNEL_COUPLING_IS_ALLOWED, 0, VALUE_TYPE_NONE, getChannelCouplingIsAllowed, 0, 0, 0, 0},
+    {DATA_ID_CHANNEL_COUPLING_MODE, 0, VALUE_TYPE_NONE, getChannelCouplingMode, 0, 0, 0, 0},
+    {DATA_ID_CHANNEL_IS_COUPLED, 0, VALUE_TYPE_NONE, getChannelIsCoupled, 0, 0, 0, 0},
+    {DATA_ID_CHANNEL_IS_TRACKED, 0, VALUE_TYPE_NONE, getChannelIsTracked, 0, 0, 0, 0},
+    {DATA_ID_CHANNEL_IS_COUPLED_OR_TRACKED, 0, VALUE_TYPE_NONE, getChannelIsCoupledOrTracked, 0, 0, 0, 0},
+    {DATA_ID_CHANNEL_COUPLING_IS_SERIES, 0, VALUE_TYPE_NONE, getChannelCouplingIsSeries, 0, 0, 0, 0},
+    {DATA_ID_CHANNEL_STATUS, 0, VALUE_TYPE_NONE, getChannelStatus, 0, 0, 0, 0},
+    {DATA_ID_CHANNEL_OUTPUT_STATE, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getChannelOutputState, 0, 0, 0, 0},
+    {DATA_ID_CHANNEL_OUTPUT_MODE, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getChannelOutputMode, 0, 0, 0, 0},
+    {DATA_ID_EDIT_ENABLED, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getEditEnabled, 0, 0, 0, 0},
+    {DATA_ID_TRIGGER_IS_INITIATED, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getTriggerIsInitiated, 0, 0, 0, 0},
+    {DATA_ID_TRIGGER_IS_MANUAL, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getTriggerIsManual, 0, 0, 0, 0},
+    {DATA_ID_CHANNEL_MON_VALUE, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getChannelMonValue, 0, 0, 0, 0},
+    {DATA_ID_CHANNEL_U_SET, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_FLOAT_VOLT, getChannelUSet, setChannelU, getChannelUMin, getChannelUMax, getChannelULimit},
+    {DATA_ID_CHANNEL_U_EDIT, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_FLOAT_VOLT, getChannelUEdit, setChannelU, getChannelUMin, getChannelUMax, getChannelULimit},
+    {DATA_ID_CHANNEL_U_MON, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getChannelUMon, 0, getChannelUMin, getChannelUMax, getChannelULimit},
+    {DATA_ID_CHANNEL_U_MON_DAC, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getChannelUMonDac, 0, 0, 0, 0},
+    {DATA_ID_CHANNEL_U_LIMIT, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getChannelULimit, 0, 0, 0, 0},
+    {DATA_ID_CHANNEL_I_SET, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_FLOAT_AMPER, getChannelISet, setChannelI, getChannelIMin, getChannelIMax, getChannelIRangeLimit},
+    {DATA_ID_CHANNEL_I_EDIT, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_FLOAT_AMPER, getChannelIEdit, setChannelI, getChannelIMin, getChannelIMax, getChannelIRangeLimit},
+    {DATA_ID_CHANNEL_I_MON, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getChannelIMon, 0, getChannelIMin, getChannelIMax, getChannelIRangeLimit},
+    {DATA_ID_CHANNEL_I_MON_DAC, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getChannelIMonDac, 0, 0, 0, 0},
+    {DATA_ID_CHANNEL_I_LIMIT, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getChannelILimit, 0, 0, 0, 0},
+    {DATA_ID_CHANNEL_P_MON, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getChannelPMon, 0, getChannelPMin, getChannelPMax, getChannelPLimit},
+    {DATA_ID_CHANNEL_DISPLAY_VALUE1, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getChannelDisplayValue, 0, getChannelDisplayValueMin, getChannelDisplayValueMax, getChannelDisplayValueLimit},
+    {DATA_ID_CHANNEL_DISPLAY_VALUE2, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getChannelDisplayValue, 0, getChannelDisplayValueMin, getChannelDisplayValueMax, getChannelDisplayValueLimit},
+    {DATA_ID_LRIP, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getLrip, 0, 0, 0, 0},
+    {DATA_ID_CHANNEL_RPROG_STATUS, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getChannelRprogStatus, 0, 0, 0, 0},
+    {DATA_ID_OVP, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getOvp, 0, 0, 0, 0},
+    {DATA_ID_OCP, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getOcp, 0, 0, 0, 0},
+    {DATA_ID_OPP, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getOpp, 0, 0, 0, 0},
+    {DATA_ID_OTP_CH, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getOtpCh, 0, 0, 0, 0},
+    {DATA_ID_CHANNEL_LABEL, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getChannelLabel, 0, 0, 0, 0},
+    {DATA_ID_CHANNEL_SHORT_LABEL, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getChannelShortLabel, 0, 0, 0, 0},
+    {DATA_ID_CHANNEL_TEMP_STATUS, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getChannelTempStatus, 0, 0, 0, 0},
+    {DATA_ID_CHANNEL_TEMP, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getChannelTemp, 0, 0, 0, 0},
+    {DATA_ID_CHANNEL_ON_TIME_TOTAL, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getChannelOnTimeTotal, 0, 0, 0, 0},
+    {DATA_ID_CHANNEL_ON_TIME_LAST, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getChannelOnTimeLast, 0, 0, 0, 0},
+    {DATA_ID_CHANNEL_HAS_SUPPORT_FOR_CURRENT_DUAL_RANGE, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getChannelHasSupportForCurrentDualRange, 0, 0, 0, 0},
+    {DATA_ID_CHANNEL_LIST_COUNTDOWN, DATA_ITEM_FLAG_CHANNEL_OK, VALUE_TYPE_NONE, getChannelListCountdown, 0, 0, 0, 0},
+    {DATA_ID_CHANNEL_IS_VOLTAGE_BALANCED, 0, VALUE_TYPE_NONE, getChannelIsVoltageBalanced, 0, 0, 0, 0},
+    {DATA_ID_CHANNEL_IS_CURRENT_BALANCED, 0, VALUE_TYPE_NONE, getChannelIsCurrentBalanced, 0, 0, 0, 0},
+    {DATA_ID_OTP_AUX, 0, VALUE_TYPE_NONE, getOtpAux, 0, 0, 0, 0},
+    {DATA_ID_SYS_PASSWORD_IS_SET, 0, VALUE_TYPE_NONE, getSysPasswordIsSet, 0, 0, 0, 0},
+    {DATA_ID_SYS_RL_STATE, 0, VALUE_TYPE_NONE, getSysRlState, 0, 0, 0, 0},
+    {DATA_ID_SYS_TEMP_AUX_STATUS, 0, VALUE_TYPE_NONE, getSysTempAuxStatus, 0, 0, 0, 0},
+    {DATA_ID_SYS_TEMP_AUX, 0, VALUE_TYPE_NONE, getSysTempAux, 0, 0, 0, 0},
+    {DATA_ID_ALERT_MESSAGE, 0, VALUE_TYPE_NONE, getAlertMessage, setAlertMessage, 0, 0, 0},
+    {DATA_ID_ALERT_MESSAGE_2, 0, VALUE_TYPE_NONE, getAlertMessage2, setAlertMessage2, 0, 0, 0},
+    {DATA_ID_ALERT_MESSAGE_3, 0, VALUE_TYPE_NONE, getAlertMessage3, setAlertMessage3, 0, 0, 0},
+    {DATA_ID_MODEL_INFO, 0, VALUE_TYPE_NONE, getModelInfoData, 0, 0, 0, 0},
+    {DATA_ID_FIRMWARE_INFO, 0, VALUE_TYPE_NONE, getFirmwareInfoData, 0, 0, 0, 0},
+    {DATA_ID_SERIAL_STATUS, 0, VALUE_TYPE_NONE, getSerialStatus, 0, 0, 0, 0},
+    {DATA_ID_ETHERNET_INSTALLED, 0, VALUE_TYPE_NONE, getEthernetInstalled, 0, 0, 0, 0},
+#if OPTION_ETHERNET
+    {DATA_ID_ETHERNET_STATUS, 0, VALUE_TYPE_NONE, getEthernetStatus, 0, 0, 0, 0},
+    {DATA_ID_ETHERNET_IS_CONNECTED, 0, VALUE_TYPE_NONE, getEthernetIsConnected, 0, 0, 0, 0},
+#endif
+    {DATA_ID_SYS_ENCODER_INSTALLED, 0, VALUE_TYPE_NONE, getSysEncoderInstalled, 0, 0, 0, 0},
+    {DATA_ID_SYS_DISPLAY_STATE, 0, VALUE_TYPE_NONE, getSysDisplayState, 0, 0, 0, 0},
+    {DATA_ID_TEXT_MESSAGE, 0, VALUE_TYPE_NONE, getTextMessage, 0, 0, 0, 0},
+    {DATA_ID_SERIAL_IS_CONNECTED, 0, VALUE_TYPE_NONE, getSerialIsConnected, 0, 0, 0, 0},
+    {DATA_ID_ASYNC_OPERATION_THROBBER, 0, VALUE_TYPE_NONE, getAsyncOperationThrobber, 0, 0, 0, 0},
+    {DATA_ID_PROGRESS, 0, VALUE_TYPE_NONE, getProgress, 0, 0, 0, 0},
+    {DATA_ID_IO_PINS_INHIBIT_STATE, 0, VALUE_TYPE_NONE, getIoPinsInhibitState, 0, 0, 0, 0},
+    {DATA_ID_VIEW_STATUS, 0, VALUE_TYPE_NONE, getViewStatus, 0, 0, 0, 0},
+#if OPTION_SD_CARD
+    {DATA_ID_DLOG_STATUS, 0, VALUE_TYPE_NONE, getDlogStatus, 0, 0, 0, 0},
+#endif
+    {DATA_ID_EDIT_VALUE, 0, VALUE_TYPE_NONE, 0, 0, getEditValueMin, getEditValueMax, 0},
+    {DATA_ID_EDIT_STEPS, 0, VALUE_TYPE_NONE, 0, setEditSteps, 0, 0, 0},
+};
+
+static const int NUM_DATA_ITEMS = sizeof(g_dataItems) / sizeof(DataItem);
+
+/// Maps data ID to the (1-based) index in g_dataItems, 0 if there is no item for the data ID.
+static uint8_t g_dataItemIndex[256];
+static bool g_dataItemIndexInitialized;
+
+static const DataItem *findDataItem(uint8_t id) {
+    if (!g_dataItemIndexInitialized) {
+        for (int i = 0; i < NUM_DATA_ITEMS; ++i) {
+            g_dataItemIndex[g_dataItems[i].id] = i + 1;
+        }
+        g_dataItemIndexInitialized = true;
+    }
+
+    uint8_t index = g_dataItemIndex[id];
+    return index ? &g_dataItems[index - 1] : 0;
+}
+
+/// Returns true if the channel precondition of the data item is fulfilled.
+static bool isDataItemAvailable(const DataItem *dataItem, Channel &channel) {
+    return !(dataItem->flags & DATA_ITEM_FLAG_CHANNEL_OK) || getChannelStatusCode(channel) == 1;
+}
+
 int count(uint8_t id) {
     if (id == DATA_ID_CHANNELS) {
         return CH_MAX;
@@ -726,16 +1437,12 @@ float *getFloatList(uint8_t id) {
 }
 
 Value getMin(const Cursor &cursor, uint8_t id) {
-    int iChannel = cursor.i >= 0 ? cursor.i : (g_channel ? (g_channel->index - 1) : 0);
-
-    if (id == DATA_ID_CHANNEL_U_SET || id == DATA_ID_CHANNEL_U_EDIT || isUMonData(cursor, id)) {
-        return Value(channel_dispatcher::getUMin(Channel::get(iChannel)), VALUE_TYPE_FLOAT_VOLT, iChannel);
-    } else if (id == DATA_ID_CHANNEL_I_SET || id == DATA_ID_CHANNEL_I_EDIT || isIMonData(cursor, id)) {
-        return Value(channel_dispatcher::getIMin(Channel::get(iChannel)), VALUE_TYPE_FLOAT_AMPER, iChannel);
-    } else if (isPMonData(cursor, id)) {
-        return Value(channel_dispatcher::getPowerMinLimit(Channel::get(iChannel)), VALUE_TYPE_FLOAT_WATT, iChannel);
-    } else if (id == DATA_ID_EDIT_VALUE) {
-        return edit_mode::getMin();
+    const DataItem *dataItem = findDataItem(id);
+    if (dataItem && dataItem->getMin) {
+        Value value = dataItem->getMin(cursor, id, getChannel(cursor));
+        if (value.getType() != VALUE_TYPE_NONE) {
+            return value;
+        }
     }
 
     Page *activePage = getActivePage();
@@ -750,16 +1457,12 @@ Value getMin(const Cursor &cursor, uint8_t id) {
 }
 
 Value getMax(const Cursor &cursor, uint8_t id) {
-    int iChannel = cursor.i >= 0 ? cursor.i : (g_channel ? (g_channel->index - 1) : 0);
-
-    if (id == DATA_ID_CHANNEL_U_SET || id == DATA_ID_CHANNEL_U_EDIT || isUMonData(cursor, id)) {
-        return Value(channel_dispatcher::getUMax(Channel::get(iChannel)), VALUE_TYPE_FLOAT_VOLT, iChannel);
-    } else if (id == DATA_ID_CHANNEL_I_SET || id == DATA_ID_CHANNEL_I_EDIT || isIMonData(cursor, id)) {
-        return Value(channel_dispatcher::getIMax(Channel::get(iChannel)), VALUE_TYPE_FLOAT_AMPER, iChannel);
-    } else if (isPMonData(cursor, id)) {
-        return Value(channel_dispatcher::getPowerMaxLimit(Channel::get(iChannel)), VALUE_TYPE_FLOAT_WATT, iChannel);
-    } else if (id == DATA_ID_EDIT_VALUE) {
-        return edit_mode::getMax();
+    const DataItem *dataItem = findDataItem(id);
+    if (dataItem && dataItem->getMax) {
+        Value value = dataItem->getMax(cursor, id, getChannel(cursor));
+        if (value.getType() != VALUE_TYPE_NONE) {
+            return value;
+        }
     }
 
     Page *activePage = getActivePage();
@@ -786,24 +1489,18 @@ Value getDef(const Cursor &cursor, uint8_t id) {
 }
 
 Value getLimit(const Cursor &cursor, uint8_t id) {
-    int iChannel = cursor.i >= 0 ? cursor.i : (g_channel ? (g_channel->index - 1) : 0);
-
-    if (id == DATA_ID_CHANNEL_U_SET || id == DATA_ID_CHANNEL_U_EDIT || isUMonData(cursor, id)) {
-        return Value(channel_dispatcher::getULimit(Channel::get(iChannel)), VALUE_TYPE_FLOAT_VOLT, iChannel);
-    } else if (id == DATA_ID_CHANNEL_I_SET || id == DATA_ID_CHANNEL_I_EDIT || isIMonData(cursor, id)) {
-        return Value(channel_dispatcher::getILimit(Channel::get(iChannel)), VALUE_TYPE_FLOAT_AMPER, iChannel);
-    } else if (isPMonData(cursor, id)) {
-        return Value(channel_dispatcher::getPowerLimit(Channel::get(iChannel)), VALUE_TYPE_FLOAT_WATT, iChannel);
+    const DataItem *dataItem = findDataItem(id);
+    if (dataItem && dataItem->getLimit) {
+        return dataItem->getLimit(cursor, id, getChannel(cursor));
     }
 
     return Value();
 }
 
 ValueType getUnit(const Cursor &cursor, uint8_t id) {
-    if (id == DATA_ID_CHANNEL_U_SET || id == DATA_ID_CHANNEL_U_EDIT) {
-        return VALUE_TYPE_FLOAT_VOLT;
-    } else if (id == DATA_ID_CHANNEL_I_SET || id == DATA_ID_CHANNEL_I_EDIT) {
-        return VALUE_TYPE_FLOAT_AMPER;
+    const DataItem *dataItem = findDataItem(id);
+    if (dataItem) {
+        return dataItem->unit;
     }
     return VALUE_TYPE_NONE;
 }
@@ -814,447 +1511,18 @@ void getList(const Cursor &cursor, uint8_t id, const Value **values, int &count)
     }
 }
 
-/*
-We are auto generating model name from the channels definition:
-
-<cnt>/<volt>/<curr>[-<cnt2>/<volt2>/<curr2>] (<platform>)
-
-Where is:
-
-<cnt>      - number of the equivalent channels
-<volt>     - max. voltage
-<curr>     - max. curr
-<platform> - Mega, Due, Simulator or Unknown
-*/
-const char *getModelInfo() {
-    static char model_info[CH_NUM * (sizeof("XX V / XX A") - 1) + CH_NUM * (sizeof(" - ") - 1) + 1];
-
-    if (*model_info == 0) {
-        char *p = Channel::getChannelsInfoShort(model_info);
-        *p = 0;
-    }
-
-    return model_info;
-}
-
-const char *getFirmwareInfo() {
-    static const char FIRMWARE_LABEL[] PROGMEM = "Firmware: ";
-    static char firmware_info[sizeof(FIRMWARE_LABEL) - 1 + sizeof(FIRMWARE) - 1 + 1];
-
-    if (*firmware_info == 0) {
-        strcat_P(firmware_info, FIRMWARE_LABEL);
-        strcat_P(firmware_info, PSTR(FIRMWARE));
-    }
-
-    return firmware_info;
-}
-
 Value get(const Cursor &cursor, uint8_t id) {
-    if (id == DATA_ID_CHANNELS_VIEW_MODE) {
-        return Value(persist_conf::devConf.flags.channelsViewMode);
-    }
-
-    if (id == DATA_ID_CHANNEL_COUPLING_IS_ALLOWED) {
-        return data::Value(channel_dispatcher::isCouplingOrTrackingAllowed() ? 1 : 0);
-    }
-
-    if (id == DATA_ID_CHANNEL_COUPLING_MODE) {
-        return data::Value(channel_dispatcher::getType());
-    }
-
-    if (id == DATA_ID_CHANNEL_IS_COUPLED) {
-        return data::Value(channel_dispatcher::isCoupled() ? 1 : 0);
-    }
-
-    if (id == DATA_ID_CHANNEL_IS_TRACKED) {
-        return data::Value(channel_dispatcher::isTracked() ? 1 : 0);
-    }
-
-    if (id == DATA_ID_CHANNEL_IS_COUPLED_OR_TRACKED) {
-        return data::Value(channel_dispatcher::isCoupled() || channel_dispatcher::isTracked() ? 1 : 0);
-    }
-
-    if (id == DATA_ID_CHANNEL_COUPLING_IS_SERIES) {
-        return data::Value(channel_dispatcher::isSeries() ? 1 : 0);
-    }
-
-    int iChannel = cursor.i >= 0 ? cursor.i : (g_channel ? (g_channel->index - 1) : 0);
-    
-    if (iChannel >= 0) {
-        Channel &channel = Channel::get(iChannel);
-
-        int channelStatus = channel.index > CH_NUM ? 0 : (channel.isOk() ? 1 : 2);
-
-        if (id == DATA_ID_CHANNEL_STATUS) {
-            return Value(channelStatus);
-        }
-
-        if (channelStatus == 1) {
-            if (id == DATA_ID_CHANNEL_OUTPUT_STATE) {
-                return Value(channel.isOutputEnabled() ? 1 : 0);
-            }
-
-            ChannelSnapshot &channelSnapshot = g_channelSnapshot[channel.index - 1];
-            uint32_t currentTime = micros();
-            if (!channelSnapshot.lastSnapshotTime || currentTime - channelSnapshot.lastSnapshotTime >= CONF_GUI_REFRESH_EVERY_MS * 1000UL) {
-                char *mode_str = channel.getCvModeStr();
-                channelSnapshot.mode = 0;
-                float uMon = channel_dispatcher::getUMon(channel);
-                float iMon = channel_dispatcher::getIMon(channel);
-                if (strcmp(mode_str, "CC") == 0) {
-                    channelSnapshot.monValue = Value(uMon, VALUE_TYPE_FLOAT_VOLT, channel.index-1);
-                } else if (strcmp(mode_str, "CV") == 0) {
-                    channelSnapshot.monValue = Value(iMon, VALUE_TYPE_FLOAT_AMPER, channel.index-1);
-                } else {
-                    channelSnapshot.mode = 1;
-                    if (uMon < iMon) {
-                        channelSnapshot.monValue = Value(uMon, VALUE_TYPE_FLOAT_VOLT, channel.index-1);
-                    } else {
-                        channelSnapshot.monValue = Value(iMon, VALUE_TYPE_FLOAT_AMPER, channel.index-1);
-                    }
-                }
-
-                channelSnapshot.pMon = util::multiply(uMon, iMon, getPrecision(VALUE_TYPE_FLOAT_WATT));
-
-                channelSnapshot.lastSnapshotTime = currentTime;
-            }
-
-            if (id == DATA_ID_CHANNEL_OUTPUT_MODE) {
-                char *mode_str = channel.getCvModeStr();
-                return Value(channelSnapshot.mode);
-            }
-
-            if (id == DATA_ID_EDIT_ENABLED) {
-                if ((channel_dispatcher::getVoltageTriggerMode(channel) != TRIGGER_MODE_FIXED && !trigger::isIdle()) || isPageActiveOrOnStack(PAGE_ID_CH_SETTINGS_LISTS)) {
-                    return 0;
-                }
-                if (psu::calibration::isEnabled()) {
-                    return 0;
-                }
-                return 1;
-            }
-
-            if (id == DATA_ID_TRIGGER_IS_INITIATED) {
-				bool isInitiated = trigger::isInitiated();
-#if OPTION_SD_CARD
-				if (!isInitiated && dlog::isInitiated()) {
-					isInitiated = true;
-				}
-#endif
-                return Value(isInitiated ? 1 : 0);
-            }
-        
-            if (id == DATA_ID_TRIGGER_IS_MANUAL) {
-				bool isManual = trigger::getSource() == trigger::SOURCE_MANUAL;
-#if OPTION_SD_CARD
-				if (!isManual && dlog::g_triggerSource == trigger::SOURCE_MANUAL) {
-					isManual = true;
-				}
-#endif
-                return Value(isManual ? 1 : 0);
-            }
-
-            if (id == DATA_ID_CHANNEL_MON_VALUE) {
-                return channelSnapshot.monValue;
-            }
-        
-            if (id == DATA_ID_CHANNEL_U_SET) {
-                return Value(channel_dispatcher::getUSet(channel), VALUE_TYPE_FLOAT_VOLT, channel.index-1);
-            }
-        
-            if (id == DATA_ID_CHANNEL_U_EDIT) {
-                if ((g_focusCursor == cursor || channel_dispatcher::isCoupled()) && g_focusDataId == DATA_ID_CHANNEL_U_EDIT && g_focusEditValue.getType() != VALUE_TYPE_NONE) {
-                    return g_focusEditValue;
-                } else {
-                    return Value(channel_dispatcher::getUSet(channel), VALUE_TYPE_FLOAT_VOLT, channel.index-1);
-                }
-            }
-        
-            if (isUMonData(cursor, id)) {
-                return Value(channel_dispatcher::getUMon(channel), VALUE_TYPE_FLOAT_VOLT, channel.index-1);
-            }
-
-            if (id == DATA_ID_CHANNEL_U_MON_DAC) {
-                return Value(channel_dispatcher::getUMonDac(channel), VALUE_TYPE_FLOAT_VOLT, channel.index-1);
-            }
-
-            if (id == DATA_ID_CHANNEL_U_LIMIT) {
-                return Value(channel_dispatcher::getULimit(channel), VALUE_TYPE_FLOAT_VOLT, channel.index-1);
-            }
-
-            if (id == DATA_ID_CHANNEL_I_SET) {
-                return Value(channel_dispatcher::getISet(channel), VALUE_TYPE_FLOAT_AMPER, channel.index-1);
-            }
-        
-            if (id == DATA_ID_CHANNEL_I_EDIT) {
-                if ((g_focusCursor == cursor || channel_dispatcher::isCoupled()) && g_focusDataId == DATA_ID_CHANNEL_I_EDIT && g_focusEditValue.getType() != VALUE_TYPE_NONE) {
-                    return g_focusEditValue;
-                } else {
-                    return Value(channel_dispatcher::getISet(channel), VALUE_TYPE_FLOAT_AMPER, channel.index-1);
-                }
-            }
-
-            if (isIMonData(cursor, id)) {
-                return Value(channel_dispatcher::getIMon(channel), VALUE_TYPE_FLOAT_AMPER, channel.index-1);
-            }
-
-            if (id == DATA_ID_CHANNEL_I_MON_DAC) {
-                return Value(channel_dispatcher::getIMonDac(channel), VALUE_TYPE_FLOAT_AMPER, channel.index-1);
-            }
-
-            if (id == DATA_ID_CHANNEL_I_LIMIT) {
-                return Value(channel_dispatcher::getILimit(channel), VALUE_TYPE_FLOAT_VOLT, channel.index-1);
-            }
-
-            if (isPMonData(cursor, id)) {
-                return Value(channelSnapshot.pMon, VALUE_TYPE_FLOAT_WATT, channel.index-1);
-            }
-
-            if (id == DATA_ID_LRIP) {
-                return Value(channel.flags.lrippleEnabled ? 1 : 0);
-            }
-
-            if (id == DATA_ID_CHANNEL_RPROG_STATUS) {
-                return Value(channel.flags.rprogEnabled ? 1 : 0);
-            }
-
-            if (id == DATA_ID_OVP) {
-                unsigned ovp;
-                if (!channel.prot_conf.flags.u_state) ovp = 0;
-                else if (!channel_dispatcher::isOvpTripped(channel)) ovp = 1;
-                else ovp = 2;
-                return Value(ovp);
-            }
-        
-            if (id == DATA_ID_OCP) {
-                unsigned ocp;
-                if (!channel.prot_conf.flags.i_state) ocp = 0;
-                else if (!channel_dispatcher::isOcpTripped(channel)) ocp = 1;
-                else ocp = 2;
-                return Value(ocp);
-            }
-        
-            if (id == DATA_ID_OPP) {
-                unsigned opp;
-                if (!channel.prot_conf.flags.p_state) opp = 0;
-                else if (!channel_dispatcher::isOppTripped(channel)) opp = 1;
-                else opp = 2;
-                return Value(opp);
-            }
-        
-            if (id == DATA_ID_OTP_CH) {
-#if EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R1B9
-                return 0;
-#elif EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R3B4 || EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R5B12
-                temperature::TempSensorTemperature &tempSensor = temperature::sensors[temp_sensor::CH1 + channel.index - 1];
-                if (!tempSensor.isInstalled() || !tempSensor.isTestOK() || !tempSensor.prot_conf.state) return 0;
-                else if (!channel_dispatcher::isOtpTripped(channel)) return 1;
-                else return 2;
-#endif
-            }
-        
-            if (id == DATA_ID_CHANNEL_LABEL) {
-                return data::Value(channel.index, VALUE_TYPE_CHANNEL_LABEL);
-            }
-        
-            if (id == DATA_ID_CHANNEL_SHORT_LABEL) {
-                return data::Value(channel.index, VALUE_TYPE_CHANNEL_SHORT_LABEL);
-            }
-
-            if (id == DATA_ID_CHANNEL_TEMP_STATUS) {
-#if EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R1B9
-                return 2;
-#elif EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R3B4 || EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R5B12
-                temperature::TempSensorTemperature &tempSensor = temperature::sensors[temp_sensor::CH1 + channel.index - 1];
-                if (tempSensor.isInstalled()) return tempSensor.isTestOK() ? 1 : 0;
-                else return 2;
-#endif
-            }
-
-            if (id == DATA_ID_CHANNEL_TEMP) {
-                float temperature = 0;
-#if EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R3B4 || EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R5B12
-                temperature::TempSensorTemperature &tempSensor = temperature::sensors[temp_sensor::CH1 + channel.index - 1];
-                if (tempSensor.isInstalled() && tempSensor.isTestOK()) {
-                    temperature = tempSensor.temperature;
-                }
-#endif
-                return data::Value(temperature, VALUE_TYPE_FLOAT_CELSIUS);
-            }
-
-            if (id == DATA_ID_CHANNEL_ON_TIME_TOTAL) {
-                return data::Value((uint32_t)channel.onTimeCounter.getTotalTime(), VALUE_TYPE_ON_TIME_COUNTER);
-            }
-
-            if (id == DATA_ID_CHANNEL_ON_TIME_LAST) {
-                return data::Value((uint32_t)channel.onTimeCounter.getLastTime(), VALUE_TYPE_ON_TIME_COUNTER);
-            }
-
-            if (id == DATA_ID_CHANNEL_HAS_SUPPORT_FOR_CURRENT_DUAL_RANGE) {
-                return data::Value(channel.hasSupportForCurrentDualRange() ? 1 : 0);
-            }
-
-            if (id == DATA_ID_CHANNEL_LIST_COUNTDOWN) {
-                int32_t remaining;
-                uint32_t total;
-                if (list::getCurrentDwellTime(channel, remaining, total) && total >= CONF_LIST_COUNDOWN_DISPLAY_THRESHOLD) {
-                    return Value((uint32_t)remaining, VALUE_TYPE_COUNTDOWN);
-                } else {
-                    return Value();
-                }
+    const DataItem *dataItem = findDataItem(id);
+    if (dataItem && dataItem->get) {
+        Channel &channel = getChannel(cursor);
+        if (isDataItemAvailable(dataItem, channel)) {
+            Value value = dataItem->get(cursor, id, channel);
+            if (value.getType() != VALUE_TYPE_NONE) {
+                return value;
             }
         }
     }
 
-    if (id == DATA_ID_CHANNEL_IS_VOLTAGE_BALANCED) {
-        if (channel_dispatcher::isSeries()) {
-            return Channel::get(0).isVoltageBalanced() || Channel::get(1).isVoltageBalanced() ? 1 : 0;
-        } else {
-            return 0;
-        }
-    }
-
-    if (id == DATA_ID_CHANNEL_IS_CURRENT_BALANCED) {
-        if (channel_dispatcher::isParallel()) {
-            return Channel::get(0).isCurrentBalanced() || Channel::get(1).isCurrentBalanced() ? 1 : 0;
-        } else {
-            return 0;
-        }
-    }
-
-    if (id == DATA_ID_OTP_AUX) {
-        temperature::TempSensorTemperature &tempSensor = temperature::sensors[temp_sensor::AUX];
-        if (!tempSensor.prot_conf.state) return 0;
-        else if (!tempSensor.isTripped()) return 1;
-        else return 2;
-    }
-
-    if (id == DATA_ID_SYS_PASSWORD_IS_SET) {
-        return data::Value(strlen(persist_conf::devConf2.systemPassword) > 0 ? 1 : 0);
-    }
-
-    if (id == DATA_ID_SYS_RL_STATE) {
-        return data::Value(g_rlState);
-    }
-
-    if (id == DATA_ID_SYS_TEMP_AUX_STATUS) {
-        temperature::TempSensorTemperature &tempSensor = temperature::sensors[temp_sensor::AUX];
-        if (tempSensor.isInstalled()) return tempSensor.isTestOK() ? 1 : 0;
-        else return 2;
-    }
-
-    if (id == DATA_ID_SYS_TEMP_AUX) {
-        float auxTemperature = 0;
-        temperature::TempSensorTemperature &tempSensor = temperature::sensors[temp_sensor::AUX];
-        if (tempSensor.isInstalled() && tempSensor.isTestOK()) {
-            auxTemperature = tempSensor.temperature;
-        }
-        return data::Value(auxTemperature, VALUE_TYPE_FLOAT_CELSIUS);
-    }
-
-    if (id == DATA_ID_ALERT_MESSAGE) {
-        return g_alertMessage;
-    }
-    
-    if (id == DATA_ID_ALERT_MESSAGE_2) {
-        return g_alertMessage2;
-    }
-
-    if (id == DATA_ID_ALERT_MESSAGE_3) {
-        return g_alertMessage3;
-    }
-
-    if (id == DATA_ID_MODEL_INFO) {
-        return Value(getModelInfo());
-    }
-    
-    if (id == DATA_ID_FIRMWARE_INFO) {
-        return Value(getFirmwareInfo());
-    }
-
-    if (id == DATA_ID_SERIAL_STATUS) {
-        return data::Value(serial::g_testResult);
-    }
-
-    if (id == DATA_ID_ETHERNET_INSTALLED) {
-        return data::Value(OPTION_ETHERNET);
-    }
-
-#if OPTION_ETHERNET
-    if (id == DATA_ID_ETHERNET_STATUS) {
-        return data::Value(ethernet::g_testResult);
-    }
-
-    if (id == DATA_ID_ETHERNET_IS_CONNECTED) {
-        return data::Value(ethernet::isConnected());
-    }
-#endif
-
-    if (id == DATA_ID_SYS_ENCODER_INSTALLED) {
-        return data::Value(OPTION_ENCODER);
-    }
-
-    if (id == DATA_ID_SYS_DISPLAY_STATE) {
-        return data::Value(persist_conf::devConf2.flags.displayState);
-    }
-
-    if (id == DATA_ID_TEXT_MESSAGE) {
-        return data::Value(getTextMessageVersion(), VALUE_TYPE_TEXT_MESSAGE);
-    }
-
-    if (id == DATA_ID_SERIAL_IS_CONNECTED) {
-        return data::Value(serial::isConnected());
-    }
-
-    if (id == DATA_ID_ASYNC_OPERATION_THROBBER) {
-        static char *throbber[] = {"|", "/", "-", "\\", "|", "/", "-", "\\"};
-        return data::Value(throbber[(millis() % 1000) / 125]);
-    }
-
-    if (id == DATA_ID_PROGRESS) {
-        return g_progress;
-    }
-
-    if (id == DATA_ID_IO_PINS_INHIBIT_STATE) {
-        persist_conf::IOPin &inputPin = persist_conf::devConf2.ioPins[0];
-        if (inputPin.function == io_pins::FUNCTION_INHIBIT) {
-            return data::Value(io_pins::isInhibited() ? 1 : 0);
-        } else {
-            return data::Value(2);
-        }
-    }
-
-	if (id == DATA_ID_VIEW_STATUS) {
-#if OPTION_SD_CARD
-		bool listStatusVisible = list::anyCounterVisible(CONF_LIST_COUNDOWN_DISPLAY_THRESHOLD);
-		bool dlogStatusVisible = !dlog::isIdle();
-		if (listStatusVisible && dlogStatusVisible) {
-			return data::Value(micros() % (2 * 1000000UL) < 1000000UL ? 1 : 2);
-		}
-		else if (listStatusVisible) {
-			return data::Value(1);
-		}
-		else if (dlogStatusVisible) {
-			return data::Value(2);
-		}
-#else
-		if (list::anyCounterVisible(CONF_LIST_COUNDOWN_DISPLAY_THRESHOLD)) {
-			return data::Value(1);
-		}
-#endif
-		return data::Value(0);
-	}
-
-#if OPTION_SD_CARD
-	if (id == DATA_ID_DLOG_STATUS) {
-		if (dlog::isInitiated()) {
-			return data::Value(PSTR("Dlog trigger waiting"));
-		} else if (!dlog::isIdle()) {
-			return data::Value((uint32_t)floor(dlog::g_currentTime), VALUE_TYPE_DLOG_STATUS);
-		}
-	}
-#endif
-
     Page *page = getActivePage();
     if (page) {
         Value value = page->getData(cursor, id);
@@ -1295,58 +1563,9 @@ Value get(const Cursor &cursor, uint8_t id) {
 }
 
 bool set(const Cursor &cursor, uint8_t id, Value value, int16_t *error) {
-    int iChannel = cursor.i >= 0 ? cursor.i : (g_channel ? (g_channel->index - 1) : 0);
-
-    if (id == DATA_ID_CHANNEL_U_SET || id == DATA_ID_CHANNEL_U_EDIT) {
-        if (!util::between(value.getFloat(), channel_dispatcher::getUMin(Channel::get(iChannel)), channel_dispatcher::getUMax(Channel::get(iChannel)), VALUE_TYPE_FLOAT_VOLT, iChannel)) {
-            if (error) *error = SCPI_ERROR_DATA_OUT_OF_RANGE;
-            return false;
-        }
-        
-        if (util::greater(value.getFloat(), channel_dispatcher::getULimit(Channel::get(iChannel)), VALUE_TYPE_FLOAT_VOLT, iChannel)) {
-            if (error) *error = SCPI_ERROR_VOLTAGE_LIMIT_EXCEEDED;
-            return false;
-        }
-        
-        if (util::greater(value.getFloat() * channel_dispatcher::getISetUnbalanced(Channel::get(iChannel)), channel_dispatcher::getPowerLimit(Channel::get(iChannel)), VALUE_TYPE_FLOAT_WATT, iChannel)) {
-            if (error) *error = SCPI_ERROR_POWER_LIMIT_EXCEEDED;
-            return false;
-        }
-        
-        channel_dispatcher::setVoltage(Channel::get(iChannel), value.getFloat());
-
-        return true;
-    } else if (id == DATA_ID_CHANNEL_I_SET || id == DATA_ID_CHANNEL_I_EDIT) {
-        if (!util::between(value.getFloat(), channel_dispatcher::getIMin(Channel::get(iChannel)), channel_dispatcher::getIMax(Channel::get(iChannel)), VALUE_TYPE_FLOAT_AMPER, iChannel)) {
-            if (error) *error = SCPI_ERROR_DATA_OUT_OF_RANGE;
-            return false;
-        }
-        
-        if (util::greater(value.getFloat(), channel_dispatcher::getILimit(Channel::get(iChannel)), VALUE_TYPE_FLOAT_AMPER, iChannel)) {
-            if (error) *error = SCPI_ERROR_CURRENT_LIMIT_EXCEEDED;
-            return false;
-        }
-        
-        if (util::greater(value.getFloat() * channel_dispatcher::getUSetUnbalanced(Channel::get(iChannel)), channel_dispatcher::getPowerLimit(Channel::get(iChannel)), VALUE_TYPE_FLOAT_VOLT, iChannel)) {
-            if (error) *error = SCPI_ERROR_POWER_LIMIT_EXCEEDED;
-            return false;
-        }
-        
-        channel_dispatcher::setCurrent(Channel::get(iChannel), value.getFloat());
-
-        return true;
-    } else if (id == DATA_ID_ALERT_MESSAGE) {
-        g_alertMessage = value;
-        return true;
-    } else if (id == DATA_ID_ALERT_MESSAGE_2) {
-        g_alertMessage2 = value;
-        return true;
-    } else if (id == DATA_ID_ALERT_MESSAGE_3) {
-        g_alertMessage3 = value;
-        return true;
-    } else if (id == DATA_ID_EDIT_STEPS) {
-        edit_mode_step::setStepIndex(value.getInt());
-        return true;
+    const DataItem *dataItem = findDataItem(id);
+    if (dataItem && dataItem->set) {
+        return dataItem->set(cursor, id, getChannel(cursor), value, error);
     }
 
     Page *activePage = getActivePage();
@@ -1367,16 +1586,17 @@ int getCurrentHistoryValuePosition(const Cursor &cursor, uint8_t id) {
     return Channel::get(iChannel).getCurrentHistoryValuePosition();
 }
 
-Value getHistoryValue(const Cursor &cursor, uint8_t id, int position) {
+Value getHistoryValue(const Cursor &cursor, uint8_t id, int position, history::ValueKind kind) {
     int iChannel = cursor.i >= 0 ? cursor.i : (g_channel ? (g_channel->index - 1) : 0);
     if (isUMonData(cursor, id)) {
-        return Value(channel_dispatcher::getUMonHistory(Channel::get(iChannel), position), VALUE_TYPE_FLOAT_VOLT, iChannel);
+        return Value(channel_dispatcher::getUMonHistory(Channel::get(iChannel), position, kind), VALUE_TYPE_FLOAT_VOLT, iChannel);
     } else if (isIMonData(cursor, id)) {
-        return Value(channel_dispatcher::getIMonHistory(Channel::get(iChannel), position), VALUE_TYPE_FLOAT_AMPER, iChannel);
+        return Value(channel_dispatcher::getIMonHistory(Channel::get(iChannel), position, kind), VALUE_TYPE_FLOAT_AMPER, iChannel);
     } else if (isPMonData(cursor, id)) {
+        // U and I are never negative, so product of U and I min (max) is lower (upper) bound of the power
         float pMon = util::multiply(
-            channel_dispatcher::getUMonHistory(Channel::get(iChannel), position),
-            channel_dispatcher::getIMonHistory(Channel::get(iChannel), position),
+            channel_dispatcher::getUMonHistory(Channel::get(iChannel), position, kind),
+            channel_dispatcher::getIMonHistory(Channel::get(iChannel), position, kind),
             getPrecision(VALUE_TYPE_FLOAT_WATT));
         return Value(pMon, VALUE_TYPE_FLOAT_WATT, iChannel);
     }
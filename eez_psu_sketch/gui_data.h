@@ -20,6 +20,7 @@
 
 #include "event_queue.h"
 #include "value.h"
+#include "history.h"
 
 namespace eez {
 namespace psu {
@@ -219,7 +220,7 @@ bool set(const Cursor &cursor, uint8_t id, Value value, int16_t *error);
 
 int getNumHistoryValues(uint8_t id);
 int getCurrentHistoryValuePosition(const Cursor &cursor, uint8_t id);
-Value getHistoryValue(const Cursor &cursor, uint8_t id, int position);
+Value getHistoryValue(const Cursor &cursor, uint8_t id, int position, history::ValueKind kind = history::VALUE_KIND_LAST);
 
 bool isBlinking(const Cursor &cursor, uint8_t id);
 Value getEditValue(const Cursor &cursor, uint8_t id);
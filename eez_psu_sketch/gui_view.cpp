@@ -43,6 +43,8 @@ namespace gui {
 ////////////////////////////////////////////////////////////////////////////////
 
 static bool g_widgetRefresh;
+static bool g_widgetRefreshedSinceLastDraw;
+static bool g_drawTextChanges;
 static WidgetCursor g_selectedWidget;
 static bool g_isBlinkTime;
 static bool g_wasBlinkTime;
@@ -90,7 +92,73 @@ bool styleIsBlink(const Style *style) {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void drawText(int pageId, const char *text, int textLength, int x, int y, int w, int h, const Style *style, bool inverse, bool blink, bool ignoreLuminocity, uint16_t *overrideBackgroundColor) {
+/// Redraws only the glyphs of the text which are different from the previous text drawn
+/// with the same style at the same position, returns false if the whole text must be redrawn.
+static bool drawTextChange(int pageId, const char *text, int textLength, const char *previousText,
+    int x1, int y1, int x2, int y2, int x_offset, int y_offset, font::Font &font,
+    const Style *style, uint16_t backgroundColor, bool inverse, bool blink, bool ignoreLuminocity)
+{
+    int previousWidth = lcd::lcd.measureStr(previousText, -1, font, x2 - x1 + 1);
+
+    int previous_x_offset;
+    if (styleIsHorzAlignLeft(style)) previous_x_offset = x1 + style->padding_horizontal;
+    else if (styleIsHorzAlignRight(style)) previous_x_offset = x2 - style->padding_horizontal - previousWidth;
+    else previous_x_offset = x1 + ((x2 - x1) - previousWidth) / 2;
+    if (previous_x_offset < 0) previous_x_offset = x1;
+
+    if (previous_x_offset != x_offset) {
+        return false;
+    }
+
+    if (textLength == -1) {
+        textLength = strlen(text);
+    }
+    int previousTextLength = strlen(previousText);
+
+    // glyphs in the common prefix are at the same position
+    int prefix = 0;
+    while (prefix < textLength && prefix < previousTextLength && text[prefix] == previousText[prefix]) {
+        ++prefix;
+    }
+
+    // glyphs in the common suffix are at the same position only if both texts have the same width
+    int fullWidth = lcd::lcd.measureStr(text, textLength, font);
+    int previousFullWidth = lcd::lcd.measureStr(previousText, previousTextLength, font);
+    int suffix = 0;
+    if (fullWidth == previousFullWidth) {
+        while (suffix < textLength - prefix && suffix < previousTextLength - prefix &&
+            text[textLength - 1 - suffix] == previousText[previousTextLength - 1 - suffix]) {
+            ++suffix;
+        }
+    }
+
+    // erase the end of the previous text if the new text is shorter
+    int right = MIN(x_offset + previousFullWidth - 1, x2);
+    if (x_offset + fullWidth <= right) {
+        if (inverse || blink) {
+            lcd::lcd.setColor(style->color, ignoreLuminocity);
+        } else {
+            lcd::lcd.setColor(backgroundColor, ignoreLuminocity);
+        }
+        lcd::lcd.fillRect(x_offset + fullWidth, y1, right, y2);
+    }
+
+    if (prefix + suffix < textLength) {
+        if (inverse || blink) {
+            lcd::lcd.setBackColor(style->color, ignoreLuminocity);
+            lcd::lcd.setColor(backgroundColor, ignoreLuminocity);
+        } else {
+            lcd::lcd.setBackColor(backgroundColor, ignoreLuminocity);
+            lcd::lcd.setColor(style->color, ignoreLuminocity);
+        }
+        int x = x_offset + lcd::lcd.measureStr(text, prefix, font);
+        lcd::lcd.drawStr(pageId, text + prefix, textLength - prefix - suffix, x, y_offset, x1, y1, x2, y2, font, true);
+    }
+
+    return true;
+}
+
+void drawText(int pageId, const char *text, int textLength, int x, int y, int w, int h, const Style *style, bool inverse, bool blink, bool ignoreLuminocity, uint16_t *overrideBackgroundColor, const char *previousText) {
     int x1 = x;
     int y1 = y;
     int x2 = x + w - 1;
@@ -129,6 +197,14 @@ void drawText(int pageId, const char *text, int textLength, int x, int y, int w,
 		backgroundColor = style->background_color;
 	}
 
+    if (previousText && !g_widgetRefresh) {
+        if (drawTextChange(pageId, text, textLength, previousText, x1, y1, x2, y2, x_offset, y_offset, font,
+            style, backgroundColor, inverse, blink, ignoreLuminocity))
+        {
+            return;
+        }
+    }
+
     if (inverse || blink) {
         lcd::lcd.setColor(style->color, ignoreLuminocity);
     } else {
@@ -372,6 +448,25 @@ void drawRectangle(int x, int y, int w, int h, const Style *style, bool inverse,
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/// Returns true if the widget is on the screen exactly as described by the previous state
+/// and only its numeric value is changed, i.e. the previous value can be formatted again
+/// to find out which glyphs are changed.
+bool isOnlyDataChanged(const WidgetCursor &widgetCursor) {
+    if (!g_drawTextChanges || !widgetCursor.previousState) {
+        return false;
+    }
+
+    WidgetState *previousState = widgetCursor.previousState;
+    WidgetState *currentState = widgetCursor.currentState;
+
+    return previousState->flags.focused == currentState->flags.focused &&
+        previousState->flags.pressed == currentState->flags.pressed &&
+        previousState->flags.blinking == currentState->flags.blinking &&
+        previousState->backgroundColor == currentState->backgroundColor &&
+        previousState->data.getType() == currentState->data.getType() &&
+        (currentState->data.isFloat() || currentState->data.getType() == VALUE_TYPE_INT);
+}
+
 void drawDisplayDataWidget(int pageId, const WidgetCursor &widgetCursor) {
     DECL_WIDGET(widget, widgetCursor.widgetOffset);
     DECL_WIDGET_SPECIFIC(DisplayDataWidget, display_data_widget, widget);
@@ -397,11 +492,19 @@ void drawDisplayDataWidget(int pageId, const WidgetCursor &widgetCursor) {
         char text[64];
         widgetCursor.currentState->data.toText(text, sizeof(text));
 
+        // if only the value is changed, redraw only the changed glyphs
+        char previousText[64];
+        bool onlyDataChanged = isOnlyDataChanged(widgetCursor);
+        if (onlyDataChanged) {
+            widgetCursor.previousState->data.toText(previousText, sizeof(previousText));
+        }
+
         drawText(pageId, text, -1, widgetCursor.x, widgetCursor.y, (int)widget->w, (int)widget->h, style,
             widgetCursor.currentState->flags.pressed,
             widgetCursor.currentState->flags.blinking,
 			false,
-			&widgetCursor.currentState->backgroundColor);
+			&widgetCursor.currentState->backgroundColor,
+            onlyDataChanged ? previousText : 0);
 	}
 }
 
@@ -429,8 +532,16 @@ void drawTextWidget(int pageId, const WidgetCursor &widgetCursor) {
             } else {
                 char text[64];
                 widgetCursor.currentState->data.toText(text, sizeof(text));
+
+                char previousText[64];
+                bool onlyDataChanged = isOnlyDataChanged(widgetCursor);
+                if (onlyDataChanged) {
+                    widgetCursor.previousState->data.toText(previousText, sizeof(previousText));
+                }
+
                 drawText(pageId, text, -1, widgetCursor.x, widgetCursor.y, (int)widget->w, (int)widget->h, style,
-                    widgetCursor.currentState->flags.pressed, widgetCursor.currentState->flags.blinking, display_string_widget->flags.ignoreLuminosity);
+                    widgetCursor.currentState->flags.pressed, widgetCursor.currentState->flags.blinking, display_string_widget->flags.ignoreLuminosity,
+                    0, onlyDataChanged ? previousText : 0);
             }
         } else {
             DECL_STRING(text, display_string_widget->text);
@@ -1136,26 +1247,31 @@ void drawBarGraphWidget(int pageId, const WidgetCursor &widgetCursor) {
 int getYValue(
     const WidgetCursor &widgetCursor, const Widget *widget,
     uint8_t data, float min, float max,
-    int position
+    int position, history::ValueKind kind = history::VALUE_KIND_LAST
     ) 
 {
-    float value = data::getHistoryValue(widgetCursor.cursor, data, position).getFloat();
+    float value = data::getHistoryValue(widgetCursor.cursor, data, position, kind).getFloat();
     int y = (int)floor(widget->h * (value - min) / (max - min));
     if (y < 0) y = 0;
     if (y >= widget->h) y = widget->h - 1;
     return widget->h - 1 - y;
 }
 
+/// Draws the columns of the history positions from startPosition to endPosition - 1,
+/// every column is joined to the value of the previous position.
 void drawYTGraph(
     const WidgetCursor &widgetCursor, const Widget *widget,
-    int startPosition, int endPosition, int numPositions,
-    int currentHistoryValuePosition,
+    int startPosition, int endPosition,
     int xGraphOffset, int graphWidth,
     uint8_t data1, float min1, float max1, uint16_t data1Color,
     uint8_t data2, float min2, float max2, uint16_t data2Color,
-    uint16_t color, uint16_t backgroundColor
+    uint16_t color
     ) 
 {
+    int prevPosition = startPosition == 0 ? 0 : startPosition - 1;
+    int y1Prev = getYValue(widgetCursor, widget, data1, min1, max1, prevPosition);
+    int y2Prev = getYValue(widgetCursor, widget, data2, min2, max2, prevPosition);
+
     for (int position = startPosition; position < endPosition; ++position) {
         if (position < graphWidth) {
             int x = widgetCursor.x + xGraphOffset + position;
@@ -1164,10 +1280,7 @@ void drawYTGraph(
             lcd::lcd.drawVLine(x, widgetCursor.y, widget->h - 1);
 
             int y1 = getYValue(widgetCursor, widget, data1, min1, max1, position);
-            int y1Prev = getYValue(widgetCursor, widget, data1, min1, max1, position == 0 ? position : position - 1);
-
             int y2 = getYValue(widgetCursor, widget, data2, min2, max2, position);
-            int y2Prev = getYValue(widgetCursor, widget, data2, min2, max2, position == 0 ? position : position - 1);
 
             if (abs(y1Prev - y1) <= 1 && abs(y2Prev - y2) <= 1) {
                 if (y1 == y2) {
@@ -1203,10 +1316,54 @@ void drawYTGraph(
                     }
                 }
             }
+
+            // min/max envelope of all the values measured during this position interval
+            int y1Top = getYValue(widgetCursor, widget, data1, min1, max1, position, history::VALUE_KIND_MAX);
+            int y1Bottom = getYValue(widgetCursor, widget, data1, min1, max1, position, history::VALUE_KIND_MIN);
+            if (y1Top < y1Bottom) {
+                lcd::lcd.setColor(data1Color);
+                lcd::lcd.drawVLine(x, widgetCursor.y + y1Top, y1Bottom - y1Top);
+            }
+
+            int y2Top = getYValue(widgetCursor, widget, data2, min2, max2, position, history::VALUE_KIND_MAX);
+            int y2Bottom = getYValue(widgetCursor, widget, data2, min2, max2, position, history::VALUE_KIND_MIN);
+            if (y2Top < y2Bottom) {
+                lcd::lcd.setColor(data2Color);
+                lcd::lcd.drawVLine(x, widgetCursor.y + y2Top, y2Bottom - y2Top);
+            }
+
+            y1Prev = y1;
+            y2Prev = y2;
         }
     }
 }
 
+/// Fills, with the current color, the columns of the history positions from position1
+/// to position2, if they are within the graph width.
+void fillYTGraphColumns(const WidgetCursor &widgetCursor, const Widget *widget, int xGraphOffset, int graphWidth, int position1, int position2) {
+    if (position2 >= graphWidth) {
+        position2 = graphWidth - 1;
+    }
+    if (position1 <= position2) {
+        int x = widgetCursor.x + xGraphOffset;
+        lcd::lcd.fillRect(x + position1, widgetCursor.y, x + position2, widgetCursor.y + (int)widget->h - 1);
+    }
+}
+
+/// Returns the width needed for the label of the data in the given style,
+/// i.e. for the max. value of the data.
+int getYTGraphLabelWidth(const WidgetCursor &widgetCursor, uint8_t id, const Style *style) {
+    char text[64];
+    data::getMax(widgetCursor.cursor, id).toText(text, sizeof(text));
+
+    font::Font font = styleGetFont(style);
+    int width = lcd::lcd.measureStr(text, -1, font) + 2 * style->padding_horizontal;
+    if (styleHasBorder(style)) {
+        width += 2;
+    }
+    return width;
+}
+
 void drawYTGraphWidget(int pageId, const WidgetCursor &widgetCursor) {
     DECL_WIDGET(widget, widgetCursor.widgetOffset);
     DECL_WIDGET_SPECIFIC(YTGraphWidget, ytGraphWidget, widget);
@@ -1214,9 +1371,13 @@ void drawYTGraphWidget(int pageId, const WidgetCursor &widgetCursor) {
     DECL_STYLE(y1Style, ytGraphWidget->y1Style);
     DECL_STYLE(y2Style, ytGraphWidget->y2Style);
 
+    YTGraphWidgetState *currentState = (YTGraphWidgetState *)widgetCursor.currentState;
+    YTGraphWidgetState *previousState = (YTGraphWidgetState *)widgetCursor.previousState;
+
     widgetCursor.currentState->size = sizeof(YTGraphWidgetState);
     widgetCursor.currentState->data = data::get(widgetCursor.cursor, widget->data);
-    ((YTGraphWidgetState *)widgetCursor.currentState)->y2Data = data::get(widgetCursor.cursor, ytGraphWidget->y2Data);
+    currentState->y2Data = data::get(widgetCursor.cursor, ytGraphWidget->y2Data);
+    currentState->lastPosition = previousState ? previousState->lastPosition : 0;
 
     bool refresh = !widgetCursor.previousState ||
         widgetCursor.previousState->flags.pressed != widgetCursor.currentState->flags.pressed;
@@ -1228,7 +1389,15 @@ void drawYTGraphWidget(int pageId, const WidgetCursor &widgetCursor) {
         lcd::lcd.fillRect(widgetCursor.x, widgetCursor.y, widgetCursor.x + (int)widget->w - 1, widgetCursor.y + (int)widget->h - 1);
     }
 
-    int textWidth = 62; // TODO this is hardcoded value
+    // graph has one column per history value and it is aligned to the right side,
+    // labels are on the left side and take all the remaining width, but at least
+    // the width needed for the max. value
+    int numHistoryValues = data::getNumHistoryValues(widget->data);
+    int minTextWidth = MAX(
+        getYTGraphLabelWidth(widgetCursor, widget->data, y1Style),
+        getYTGraphLabelWidth(widgetCursor, ytGraphWidget->y2Data, y2Style));
+    int graphWidth = MIN(numHistoryValues, MAX((int)widget->w - minTextWidth, 0));
+    int textWidth = widget->w - graphWidth;
     int textHeight = widget->h / 2;
 
     // draw first value text
@@ -1246,11 +1415,11 @@ void drawYTGraphWidget(int pageId, const WidgetCursor &widgetCursor) {
     }
 
     // draw second value text
-    refreshText = !widgetCursor.previousState || ((YTGraphWidgetState *)widgetCursor.previousState)->y2Data != ((YTGraphWidgetState *)widgetCursor.currentState)->y2Data;
+    refreshText = !previousState || previousState->y2Data != currentState->y2Data;
 
     if (refresh || refreshText) {
         char text[64];
-        ((YTGraphWidgetState *)widgetCursor.currentState)->y2Data.toText(text, sizeof(text));
+        currentState->y2Data.toText(text, sizeof(text));
 
         drawText(pageId, text, -1, widgetCursor.x, widgetCursor.y + textHeight, textWidth, textHeight, y2Style,
             widgetCursor.currentState->flags.pressed);
@@ -1260,28 +1429,25 @@ void drawYTGraphWidget(int pageId, const WidgetCursor &widgetCursor) {
     }
 
     // draw graph
-    int graphWidth = widget->w - textWidth;
-
-    int numHistoryValues = data::getNumHistoryValues(widget->data);
     int currentHistoryValuePosition = data::getCurrentHistoryValuePosition(widgetCursor.cursor, widget->data);
 
-    static int lastPosition[CH_MAX];
-
     float min1 = data::getMin(widgetCursor.cursor, widget->data).getFloat();
     float max1 = data::getLimit(widgetCursor.cursor, widget->data).getFloat();
 
     float min2 = data::getMin(widgetCursor.cursor, ytGraphWidget->y2Data).getFloat();
     float max2 = data::getLimit(widgetCursor.cursor, ytGraphWidget->y2Data).getFloat();
 
-    int iChannel = widgetCursor.cursor.i >= 0 ? widgetCursor.cursor.i : 0;
+    uint16_t graphBackgroundColor = widgetCursor.currentState->flags.pressed ? style->color : style->background_color;
 
+    // only the columns of the history values added since the previous draw are drawn
     int startPosition;
     int endPosition;
     if (refresh) {
         startPosition = 0;
         endPosition = numHistoryValues;
     } else {
-        startPosition = lastPosition[iChannel];
+        // position of the cursor in the previous draw, graph is drawn up to it
+        startPosition = currentState->lastPosition;
         if (startPosition == currentHistoryValuePosition) {
             return;
         }
@@ -1291,51 +1457,52 @@ void drawYTGraphWidget(int pageId, const WidgetCursor &widgetCursor) {
     if (startPosition < endPosition) {
         drawYTGraph(widgetCursor, widget,
             startPosition, endPosition,
-            currentHistoryValuePosition, numHistoryValues,
             textWidth, graphWidth,
             widget->data, min1, max1, y1Style->color, 
             ytGraphWidget->y2Data, min2, max2, y2Style->color,
-            widgetCursor.currentState->flags.pressed ? style->color: style->background_color,
-            widgetCursor.currentState->flags.pressed ? style->background_color : style->color);
+            graphBackgroundColor);
     } else {
         drawYTGraph(widgetCursor, widget, 
             startPosition, numHistoryValues,
-            currentHistoryValuePosition, numHistoryValues,
             textWidth, graphWidth,
             widget->data, min1, max1, y1Style->color,
             ytGraphWidget->y2Data, min2, max2, y2Style->color,
-            widgetCursor.currentState->flags.pressed ? style->color: style->background_color,
-            widgetCursor.currentState->flags.pressed ? style->background_color : style->color);
+            graphBackgroundColor);
 
         drawYTGraph(widgetCursor, widget,
             0, endPosition,
-            currentHistoryValuePosition, numHistoryValues,
             textWidth, graphWidth,
             widget->data, min1, max1, y1Style->color,
             ytGraphWidget->y2Data, min2, max2, y2Style->color,
-            widgetCursor.currentState->flags.pressed ? style->color: style->background_color,
-            widgetCursor.currentState->flags.pressed ? style->background_color : style->color);
+            graphBackgroundColor);
     }
 
-    int x = widgetCursor.x + textWidth;
-
     // draw cursor
     lcd::lcd.setColor(style->color);
-    lcd::lcd.drawVLine(x + currentHistoryValuePosition, widgetCursor.y, (int)widget->h - 1);
+    fillYTGraphColumns(widgetCursor, widget, textWidth, graphWidth, currentHistoryValuePosition, currentHistoryValuePosition);
+
+    // draw blank lines, only those the cursor moved into,
+    // the rest of them were already blanked when the cursor was there
+    int numBlankLines = CONF_GUI_YT_GRAPH_BLANK_PIXELS_AFTER_CURSOR;
+    if (!refresh) {
+        int numNewPositions = (currentHistoryValuePosition - startPosition + numHistoryValues) % numHistoryValues;
+        if (numNewPositions < numBlankLines) {
+            numBlankLines = numNewPositions;
+        }
+    }
 
-    // draw blank lines
-    int x1 = x + (currentHistoryValuePosition + 1) % numHistoryValues;
-    int x2 = x + (currentHistoryValuePosition + CONF_GUI_YT_GRAPH_BLANK_PIXELS_AFTER_CURSOR) % numHistoryValues;
+    int position1 = (currentHistoryValuePosition + CONF_GUI_YT_GRAPH_BLANK_PIXELS_AFTER_CURSOR - numBlankLines + 1) % numHistoryValues;
+    int position2 = (currentHistoryValuePosition + CONF_GUI_YT_GRAPH_BLANK_PIXELS_AFTER_CURSOR) % numHistoryValues;
 
     lcd::lcd.setColor(style->background_color);
-    if (x1 < x2) {
-        lcd::lcd.fillRect(x1, widgetCursor.y, x2, widgetCursor.y + (int)widget->h - 1);
+    if (position1 <= position2) {
+        fillYTGraphColumns(widgetCursor, widget, textWidth, graphWidth, position1, position2);
     } else {
-        lcd::lcd.fillRect(x1, widgetCursor.y, x + graphWidth - 1, widgetCursor.y + (int)widget->h - 1);
-        lcd::lcd.fillRect(x, widgetCursor.y, x2, widgetCursor.y + (int)widget->h - 1);
+        fillYTGraphColumns(widgetCursor, widget, textWidth, graphWidth, position1, numHistoryValues - 1);
+        fillYTGraphColumns(widgetCursor, widget, textWidth, graphWidth, 0, position2);
     }
 
-    lastPosition[iChannel] = currentHistoryValuePosition;
+    currentState->lastPosition = currentHistoryValuePosition;
 }
 
 void drawUpDownWidget(int pageId, const WidgetCursor &widgetCursor) {
@@ -1668,6 +1835,9 @@ void refreshWidget(WidgetCursor widgetCursor) {
         g_widgetRefresh = true;
         drawWidget(getActivePageId(), widgetCursor);
         g_widgetRefresh = false;
+
+        // widget is redrawn outside of the state buffer
+        g_widgetRefreshedSinceLastDraw = true;
     }
 }
 
@@ -1860,6 +2030,9 @@ void drawActivePage(bool refresh) {
     g_wasBlinkTime = g_isBlinkTime;
     g_isBlinkTime = (micros() % (2 * CONF_GUI_BLINK_TIME)) > CONF_GUI_BLINK_TIME && touch::event_type == touch::TOUCH_NONE;
 
+    g_drawTextChanges = !refresh && !g_widgetRefreshedSinceLastDraw;
+    g_widgetRefreshedSinceLastDraw = false;
+
     if (refresh) {
         g_previousState = 0;
         g_currentState = (WidgetState *)(&g_stateBuffer[0][0]);
@@ -211,6 +211,8 @@ struct YTGraphWidget {
 struct YTGraphWidgetState {
     WidgetState genericState;
     data::Value y2Data;
+    /// History value position up to which the graph was drawn.
+    int lastPosition;
 };
 
 enum UpDownWidgetSegment {
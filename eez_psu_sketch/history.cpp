@@ -0,0 +1,172 @@
+/*
+ * EEZ PSU Firmware
+ * Copyright (C) 2018-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "psu.h"
+#include "history.h"
+
+namespace eez {
+namespace psu {
+namespace history {
+
+static const int g_levelSize[NUM_LEVELS] = {
+    CHANNEL_HISTORY_NUM_SECONDS,
+    CHANNEL_HISTORY_NUM_MINUTES,
+    CHANNEL_HISTORY_NUM_HOURS
+};
+
+static const int g_levelOffset[NUM_LEVELS] = {
+    0,
+    CHANNEL_HISTORY_NUM_SECONDS,
+    CHANNEL_HISTORY_NUM_SECONDS + CHANNEL_HISTORY_NUM_MINUTES
+};
+
+/// Number of buckets of the level merged into one bucket of the next level.
+static const int g_levelRatio[NUM_LEVELS] = { 60, 60, 0 };
+
+#define BUCKET_DURATION_USEC 1000000UL
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Accumulator::add(const Accumulator &other) {
+    if (other.count == 0) {
+        return;
+    }
+
+    if (count == 0) {
+        min = other.min;
+        max = other.max;
+    } else {
+        if (other.min < min) {
+            min = other.min;
+        }
+        if (other.max > max) {
+            max = other.max;
+        }
+    }
+    sum += other.sum;
+    count += other.count;
+}
+
+void Accumulator::getBucket(Bucket &bucket) const {
+    if (count == 0) {
+        bucket.min = INT32_MAX;
+        bucket.max = INT32_MIN;
+        bucket.avg = 0;
+    } else {
+        bucket.min = min;
+        bucket.max = max;
+        bucket.avg = (int32_t)(sum / count);
+    }
+}
+
+static void getBucketValues(const Bucket &bucket, float *values) {
+    if (bucket.min > bucket.max) {
+        values[0] = NAN;
+        values[1] = NAN;
+        values[2] = NAN;
+    } else {
+        values[0] = bucket.min * 1E-6f;
+        values[1] = bucket.max * 1E-6f;
+        values[2] = bucket.avg * 1E-6f;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Store::reset() {
+    for (int level = 0; level < NUM_LEVELS; ++level) {
+        uAccumulator[level].reset();
+        iAccumulator[level].reset();
+        position[level] = 0;
+        count[level] = 0;
+        numMerged[level] = 0;
+    }
+    started = false;
+}
+
+void Store::tick(uint32_t tick_usec) {
+    if (!started) {
+        started = true;
+        lastTick = tick_usec;
+        return;
+    }
+
+    while (tick_usec - lastTick >= BUCKET_DURATION_USEC) {
+        closeBucket(LEVEL_SECONDS);
+        lastTick += BUCKET_DURATION_USEC;
+    }
+}
+
+void Store::closeBucket(int level) {
+    int i = g_levelOffset[level] + position[level];
+    uAccumulator[level].getBucket(uBuckets[i]);
+    iAccumulator[level].getBucket(iBuckets[i]);
+
+    if (++position[level] == g_levelSize[level]) {
+        position[level] = 0;
+    }
+    if (count[level] < g_levelSize[level]) {
+        ++count[level];
+    }
+
+    if (level + 1 < NUM_LEVELS) {
+        uAccumulator[level + 1].add(uAccumulator[level]);
+        iAccumulator[level + 1].add(iAccumulator[level]);
+        if (++numMerged[level] == g_levelRatio[level]) {
+            numMerged[level] = 0;
+            closeBucket(level + 1);
+        }
+    }
+
+    uAccumulator[level].reset();
+    iAccumulator[level].reset();
+}
+
+int Store::getMaxCount(Level level) {
+    return g_levelSize[level];
+}
+
+int Store::getValues(Level level, int first, float *values, int count) const {
+    if (first >= this->count[level]) {
+        return 0;
+    }
+    if (count > this->count[level] - first) {
+        count = this->count[level] - first;
+    }
+
+    int i = position[level] - this->count[level] + first;
+    if (i < 0) {
+        i += g_levelSize[level];
+    }
+
+    for (int j = 0; j < count; ++j) {
+        getBucketValues(uBuckets[g_levelOffset[level] + i], values);
+        getBucketValues(iBuckets[g_levelOffset[level] + i], values + 3);
+        values += NUM_VALUES_PER_BUCKET;
+
+        if (++i == g_levelSize[level]) {
+            i = 0;
+        }
+    }
+
+    return count;
+}
+
+}
+}
+} // namespace eez::psu::history
@@ -0,0 +1,127 @@
+/*
+ * EEZ PSU Firmware
+ * Copyright (C) 2018-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+namespace eez {
+namespace psu {
+/// Min/max/avg history of the measured values at several resolutions.
+namespace history {
+
+/// Which of the values measured during one YT view history interval.
+enum ValueKind {
+    VALUE_KIND_LAST, // measured at the end of the interval
+    VALUE_KIND_MIN,
+    VALUE_KIND_MAX
+};
+
+enum Level {
+    LEVEL_SECONDS,
+    LEVEL_MINUTES,
+    LEVEL_HOURS,
+
+    NUM_LEVELS
+};
+
+/// Min, max and average of all the samples in one time interval, in micro units.
+/// Empty interval (no samples, e.g. output was off) has min greater than max.
+struct Bucket {
+    int32_t min;
+    int32_t max;
+    int32_t avg;
+};
+
+/// Collects the samples of one time interval.
+struct Accumulator {
+    int32_t min;
+    int32_t max;
+    int64_t sum;
+    uint32_t count;
+
+    void reset() {
+        count = 0;
+        sum = 0;
+    }
+
+    void add(int32_t value) {
+        if (count == 0) {
+            min = value;
+            max = value;
+        } else if (value < min) {
+            min = value;
+        } else if (value > max) {
+            max = value;
+        }
+        sum += value;
+        ++count;
+    }
+
+    /// Add all the samples collected by other accumulator.
+    void add(const Accumulator &other);
+
+    void getBucket(Bucket &bucket) const;
+};
+
+/// U_MON/I_MON history of one channel, with CHANNEL_HISTORY_NUM_SECONDS 1 second buckets,
+/// CHANNEL_HISTORY_NUM_MINUTES 1 minute buckets and CHANNEL_HISTORY_NUM_HOURS 1 hour buckets.
+/// Samples are collected into the 1 second bucket, every closed bucket is merged into the
+/// bucket of the next level, so every sample is added only once.
+class Store {
+public:
+    /// Number of float values per bucket returned by getValues.
+    static const int NUM_VALUES_PER_BUCKET = 6;
+    void reset();
+
+    void addSample(int32_t uMon, int32_t iMon) {
+        uAccumulator[LEVEL_SECONDS].add(uMon);
+        iAccumulator[LEVEL_SECONDS].add(iMon);
+    }
+
+    /// Close all the buckets which time interval has elapsed.
+    void tick(uint32_t tick_usec);
+
+    static int getMaxCount(Level level);
+    int getCount(Level level) const { return count[level]; }
+
+    /// Copy count buckets of the level, oldest first, starting with the bucket first
+    /// (0 is the oldest of getCount(level) buckets), as U min, U max, U avg, I min, I max, I avg.
+    /// Values of the empty bucket are NaN.
+    /// @returns Number of copied buckets.
+    int getValues(Level level, int first, float *values, int count) const;
+
+private:
+    Accumulator uAccumulator[NUM_LEVELS];
+    Accumulator iAccumulator[NUM_LEVELS];
+
+    Bucket uBuckets[CHANNEL_HISTORY_NUM_SECONDS + CHANNEL_HISTORY_NUM_MINUTES + CHANNEL_HISTORY_NUM_HOURS];
+    Bucket iBuckets[CHANNEL_HISTORY_NUM_SECONDS + CHANNEL_HISTORY_NUM_MINUTES + CHANNEL_HISTORY_NUM_HOURS];
+
+    int position[NUM_LEVELS];
+    int count[NUM_LEVELS];
+    /// Number of closed buckets already merged into the bucket of the next level.
+    int numMerged[NUM_LEVELS];
+
+    bool started;
+    uint32_t lastTick;
+
+    void closeBucket(int level);
+};
+
+}
+}
+} // namespace eez::psu::history
@@ -43,6 +43,9 @@
 #define DISPLAY_MODEL_SSD1289    0
 #define DISPLAY_MODEL_ILI9341_16 1
 
+// draw unclipped glyphs from the runs in the glyph cache, see font::getGlyphRuns
+#define DRAW_GLYPH_RUNS (CONF_GUI_GLYPH_CACHE_SIZE > 0 && DISPLAY_TYPE == TFT_320QVT_9341)
+
 #define RGB_TO_HIGH_BYTE(R, G, B) (((R) & 248) | (G) >> 5)
 #define RGB_TO_LOW_BYTE(R, G, B) (((G) & 28) << 3 | (B) >> 3)
 
@@ -133,6 +136,7 @@ LCD::LCD(uint8_t model, uint8_t RS, uint8_t WR, uint8_t CS, uint8_t RST) {
 
 #ifdef EEZ_PSU_SIMULATOR
     buffer = new uint16_t[displayWidth * displayHeight];
+    clearDirtyRect();
 #else
     display_model = model;
 
@@ -242,6 +246,10 @@ void LCD::fastFill16(int ch, int cl, long numPixels) {
 void LCD::init(uint8_t orientation) {
     this->orientation = orientation;
 
+#ifdef EEZ_PSU_SIMULATOR
+    markDirty(0, 0, getDisplayWidth() - 1, getDisplayHeight() - 1);
+#endif
+
 #if !defined(EEZ_PSU_SIMULATOR)
     pinMode(RS, OUTPUT);
     pinMode(WR, OUTPUT);
@@ -434,6 +442,11 @@ void LCD::setXY(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2) {
         x = x2;
         y = y1;
     }
+
+    int dx1 = x1, dy1 = y1, dx2 = x2, dy2 = y2;
+    if (clipRect(dx1, dy1, dx2, dy2)) {
+        markDirty(dx1, dy1, dx2, dy2);
+    }
 #else
     if (orientation == DISPLAY_ORIENTATION_LANDSCAPE) {
         swap(uint16_t, x1, y1);
@@ -616,6 +629,94 @@ void LCD::setPixel(uint16_t color) {
 #endif
 }
 
+#ifdef EEZ_PSU_SIMULATOR
+bool LCD::clipRect(int &x1, int &y1, int &x2, int &y2) {
+    if (x1 < 0) x1 = 0;
+    if (y1 < 0) y1 = 0;
+    if (x2 > getDisplayWidth() - 1) x2 = getDisplayWidth() - 1;
+    if (y2 > getDisplayHeight() - 1) y2 = getDisplayHeight() - 1;
+    return x1 <= x2 && y1 <= y2;
+}
+
+void LCD::markDirty(int x1, int y1, int x2, int y2) {
+    if (dirtyX1 > dirtyX2) {
+        dirtyX1 = x1;
+        dirtyY1 = y1;
+        dirtyX2 = x2;
+        dirtyY2 = y2;
+    } else {
+        if (x1 < dirtyX1) dirtyX1 = x1;
+        if (y1 < dirtyY1) dirtyY1 = y1;
+        if (x2 > dirtyX2) dirtyX2 = x2;
+        if (y2 > dirtyY2) dirtyY2 = y2;
+    }
+}
+
+bool LCD::getDirtyRect(int &x1, int &y1, int &x2, int &y2) {
+    if (dirtyX1 > dirtyX2) {
+        return false;
+    }
+    x1 = dirtyX1;
+    y1 = dirtyY1;
+    x2 = dirtyX2;
+    y2 = dirtyY2;
+    return true;
+}
+
+void LCD::clearDirtyRect() {
+    dirtyX1 = 0;
+    dirtyX2 = -1;
+}
+
+void LCD::fillGlyphRuns(int x, int y, int width, int height, const uint8_t *runs) {
+    int x1 = x, y1 = y, x2 = x + width - 1, y2 = y + height - 1;
+    if (!clipRect(x1, y1, x2, y2)) {
+        return;
+    }
+    markDirty(x1, y1, x2, y2);
+
+    uint16_t fc = (fch << 8) | fcl;
+    uint16_t bc = (bch << 8) | bcl;
+    int displayWidth = getDisplayWidth();
+
+    for (int iy = y; iy < y + height; ++iy) {
+        uint8_t numRuns = *runs++;
+        if (iy >= y1 && iy <= y2) {
+            uint16_t *row = buffer + iy * displayWidth;
+            int ix = x;
+            for (int iRun = 0; iRun < numRuns; ++iRun) {
+                uint16_t color = (iRun & 1) ? fc : bc;
+                int runEnd = ix + runs[iRun];
+                for (int i = ix < x1 ? x1 : ix; i < runEnd && i <= x2; ++i) {
+                    row[i] = color;
+                }
+                ix = runEnd;
+            }
+        }
+        runs += numRuns;
+    }
+}
+
+void LCD::fillSpans(int x1, int y1, int x2, int y2) {
+    if (!clipRect(x1, y1, x2, y2)) {
+        return;
+    }
+    markDirty(x1, y1, x2, y2);
+
+    uint16_t color = (fch << 8) | fcl;
+    int width = getDisplayWidth();
+    int spanLength = x2 - x1 + 1;
+
+    uint16_t *first = buffer + y1 * width + x1;
+    for (int i = 0; i < spanLength; ++i) {
+        first[i] = color;
+    }
+    for (int iy = y1 + 1; iy <= y2; ++iy) {
+        memcpy(buffer + iy * width + x1, first, spanLength * sizeof(uint16_t));
+    }
+}
+#endif
+
 void LCD::drawPixel(int x, int y) {
     cbi(P_CS, B_CS);
     setXY(x, y, x, y);
@@ -639,19 +740,13 @@ void LCD::drawRect(int x1, int y1, int x2, int y2) {
 
 void LCD::fillRect(int x1, int y1, int x2, int y2) {
 #ifdef EEZ_PSU_SIMULATOR
-    if (orientation == DISPLAY_ORIENTATION_PORTRAIT) {
-        setXY(x1, y1, x2, y2);
-        for (int i = 0; i < (x2 - x1 + 1) * (y2 - y1 + 1); ++i) {
-            setPixel((fch << 8) | fcl);
-        }
-    } else {
-        for (int iy = y1; iy <= y2; ++iy) {
-            setXY(x1, iy, x2, iy);
-            for (int ix = x2; ix >= x1; --ix) {
-                setPixel((fch << 8) | fcl);
-            }
-        }
+    if (x1 > x2) {
+        swap(int, x1, x2);
+    }
+    if (y1 > y2) {
+        swap(int, y1, y2);
     }
+    fillSpans(x1, y1, x2, y2);
 #else
     if (x1 > x2) {
         swap(int, x1, x2);
@@ -669,10 +764,11 @@ void LCD::fillRect(int x1, int y1, int x2, int y2) {
 
 void LCD::drawHLine(int x, int y, int l) {
 #ifdef EEZ_PSU_SIMULATOR
-    setXY(x, y, x + l, y);
-    for (int i = 0; i < l + 1; ++i) {
-        setPixel((fch << 8) | fcl);
+    if (l < 0) {
+        l = -l;
+        x -= l;
     }
+    fillSpans(x, y, x + l, y);
 #else
     if (l < 0) {
         l = -l;
@@ -688,17 +784,11 @@ void LCD::drawHLine(int x, int y, int l) {
 
 void LCD::drawVLine(int x, int y, int l) {
 #ifdef EEZ_PSU_SIMULATOR
-    if (orientation == DISPLAY_ORIENTATION_PORTRAIT) {
-        setXY(x, y, x, y + l);
-        for (int i = 0; i < l + 1; ++i) {
-            setPixel((fch << 8) | fcl);
-        }
-    } else {
-        for (int i = 0; i < l +1 ; ++i) {
-            setXY(x, y + i, x, y + i);
-            setPixel((fch << 8) | fcl);
-        }
+    if (l < 0) {
+        l = -l;
+        y -= l;
     }
+    fillSpans(x, y, x, y + l);
 #else
     if (l < 0) {
         l = -l;
@@ -714,28 +804,32 @@ void LCD::drawVLine(int x, int y, int l) {
 
 void LCD::drawBitmap(int x, int y, int sx, int sy, uint16_t *data) {
 #ifdef EEZ_PSU_SIMULATOR
-    if (orientation == DISPLAY_ORIENTATION_PORTRAIT) {
-        setXY(x, y, x + sx - 1, y + sy - 1);
-        for (int i = 0; i < sx * sy; ++i) {
-            uint8_t l = *(((uint8_t *)data) + 2 * i + 0);
-            uint8_t h = *(((uint8_t *)data) + 2 * i + 1);
-            if (h == RGB_TO_HIGH_BYTE(DISPLAY_BACKGROUND_COLOR_R, DISPLAY_BACKGROUND_COLOR_G, DISPLAY_BACKGROUND_COLOR_B) &&
-                l == RGB_TO_LOW_BYTE(DISPLAY_BACKGROUND_COLOR_R, DISPLAY_BACKGROUND_COLOR_G, DISPLAY_BACKGROUND_COLOR_B)) {
-                adjustColor(h, l);
-            }
-            setPixel((h << 8) + l);
-        }
-    } else {
-        for (int iy = 0; iy < sy; ++iy) {
-            setXY(x, y + iy, x + sx - 1, y + iy);
-            for (int ix = sx - 1; ix >= 0; --ix) {
-                uint8_t l = *(((uint8_t *)data) + 2 * (iy * sx + ix) + 0);
-                uint8_t h = *(((uint8_t *)data) + 2 * (iy * sx + ix) + 1);
-                if (h == RGB_TO_HIGH_BYTE(DISPLAY_BACKGROUND_COLOR_R, DISPLAY_BACKGROUND_COLOR_G, DISPLAY_BACKGROUND_COLOR_B) &&
-                    l == RGB_TO_LOW_BYTE(DISPLAY_BACKGROUND_COLOR_R, DISPLAY_BACKGROUND_COLOR_G, DISPLAY_BACKGROUND_COLOR_B)) {
-                    adjustColor(h, l);
-                }
-                setPixel((h << 8) + l);
+    int x1 = x;
+    int y1 = y;
+    int x2 = x + sx - 1;
+    int y2 = y + sy - 1;
+    if (!clipRect(x1, y1, x2, y2)) {
+        return;
+    }
+    markDirty(x1, y1, x2, y2);
+
+    // background color is the only one which is adjusted, so do it only once per bitmap
+    uint8_t bh = RGB_TO_HIGH_BYTE(DISPLAY_BACKGROUND_COLOR_R, DISPLAY_BACKGROUND_COLOR_G, DISPLAY_BACKGROUND_COLOR_B);
+    uint8_t bl = RGB_TO_LOW_BYTE(DISPLAY_BACKGROUND_COLOR_R, DISPLAY_BACKGROUND_COLOR_G, DISPLAY_BACKGROUND_COLOR_B);
+    uint16_t backgroundColor = (bh << 8) | bl;
+    adjustColor(bh, bl);
+    uint16_t adjustedBackgroundColor = (bh << 8) | bl;
+
+    int width = getDisplayWidth();
+    int spanLength = x2 - x1 + 1;
+    for (int iy = y1; iy <= y2; ++iy) {
+        const uint16_t *src = data + (iy - y) * sx + (x1 - x);
+        uint16_t *dst = buffer + iy * width + x1;
+        if (backgroundColor == adjustedBackgroundColor) {
+            memcpy(dst, src, spanLength * sizeof(uint16_t));
+        } else {
+            for (int i = 0; i < spanLength; ++i) {
+                dst[i] = src[i] == backgroundColor ? adjustedBackgroundColor : src[i];
             }
         }
     }
@@ -860,7 +954,21 @@ int8_t LCD::drawGlyph(int pageId, int x1, int y1, int clip_x1, int clip_y1, int
         height = glyph.height;
     }
 
+#if DRAW_GLYPH_RUNS
+    const uint8_t *runs = 0;
+    if (paintEnabled && iStartByte == 0 && iStartCol == 0 && offset == font::GLYPH_HEADER_SIZE && height == glyph.height) {
+        runs = font::getGlyphRuns(glyph);
+    }
+#endif
+
     if (width > 0 && height > 0) {
+#if DRAW_GLYPH_RUNS && defined(EEZ_PSU_SIMULATOR)
+        if (runs) {
+            fillGlyphRuns(x_glyph, y_glyph, width, height, runs);
+            return glyph.dx;
+        }
+#endif
+
 #if !defined(EEZ_PSU_SIMULATOR)
         clear_bit(P_CS, B_CS);
 #endif
@@ -928,6 +1036,31 @@ int8_t LCD::drawGlyph(int pageId, int x1, int y1, int clip_x1, int clip_y1, int
         int x1_glyph = x_glyph;
         int x2_glyph = x_glyph + width - 1;
 
+#if DRAW_GLYPH_RUNS
+        if (runs) {
+            while (height--) {
+                if (!psu::criticalTick(pageId)) {
+                    return 0;
+                }
+
+                setXY(x1_glyph, y_glyph, x2_glyph, y_glyph);
+                ++y_glyph;
+
+                // pixels are sent from right to left, so start with the last run in the row
+                uint8_t numRuns = *runs++;
+                for (int iRun = numRuns - 1; iRun >= 0; --iRun) {
+                    uint8_t length = runs[iRun];
+                    if (length > 0) {
+                        if (iRun & 1) PIXEL_ON else PIXEL_OFF;
+                        while (--length) {
+                            pulse_low(P_WR, B_WR);
+                        }
+                    }
+                }
+                runs += numRuns;
+            }
+        } else
+#endif
         if (paintEnabled) {
             while (height--) {
                 setXY(x1_glyph, y_glyph, x2_glyph, y_glyph);
@@ -38,6 +38,10 @@ public:
 
 #ifdef EEZ_PSU_SIMULATOR
     uint16_t *buffer;
+
+    /// Bounding rectangle of the buffer area changed since the last clearDirtyRect().
+    bool getDirtyRect(int &x1, int &y1, int &x2, int &y2);
+    void clearDirtyRect();
 #endif
 
     void init(uint8_t orientation);
@@ -79,6 +83,15 @@ private:
 
 #ifdef EEZ_PSU_SIMULATOR
     uint16_t x, y, x1, y1, x2, y2;
+
+    int dirtyX1, dirtyY1, dirtyX2, dirtyY2;
+
+    bool clipRect(int &x1, int &y1, int &x2, int &y2);
+    void markDirty(int x1, int y1, int x2, int y2);
+    /// Fills the rectangle with the foreground color, one row span at a time.
+    void fillSpans(int x1, int y1, int x2, int y2);
+    /// Draws glyph from the runs decoded by font::getGlyphRuns.
+    void fillGlyphRuns(int x, int y, int width, int height, const uint8_t *runs);
 #else
     uint8_t display_model;
 
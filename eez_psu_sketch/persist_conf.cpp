@@ -88,7 +88,9 @@ bool save(BlockHeader *block, uint16_t size, uint16_t address, uint16_t version)
 
     block->version = version;
     block->checksum = calc_checksum(block, size);
-    return eeprom::write((const uint8_t *)block, size, address);
+    // configuration is written through, so failure is reported and nothing
+    // acknowledged is lost if power is cut before the write-back delay
+    return eeprom::write((const uint8_t *)block, size, address, true);
 }
 
 uint16_t get_address(PersistConfSection section, Channel *channel = 0) {
@@ -467,7 +469,9 @@ void setChannelsViewMode(unsigned int channelsViewMode) {
 void loadChannelCalibration(Channel &channel) {
     if (eeprom::g_testResult == psu::TEST_OK) {
         eeprom::read((uint8_t *)&channel.cal_conf, sizeof(Channel::CalibrationConfiguration), get_address(PERSIST_CONF_BLOCK_CH_CAL, &channel));
-        if (!check_block((BlockHeader *)&channel.cal_conf, sizeof(Channel::CalibrationConfiguration), CH_CAL_CONF_VERSION)) {
+        if (check_block((BlockHeader *)&channel.cal_conf, sizeof(Channel::CalibrationConfiguration), CH_CAL_CONF_VERSION)) {
+            channel.updateAdcDataConversions();
+        } else {
             channel.clearCalibrationConf();
         }
     }
@@ -537,7 +541,7 @@ bool writeTotalOnTime(int type, uint32_t time) {
 	buffer[5] = time;
 
 	return eeprom::write((uint8_t *)buffer, sizeof(buffer),
-		eeprom::EEPROM_ONTIME_START_ADDRESS + type * eeprom::EEPROM_ONTIME_SIZE);
+		eeprom::EEPROM_ONTIME_START_ADDRESS + type * eeprom::EEPROM_ONTIME_SIZE, true);
 }
 
 bool enableOutputProtectionCouple(bool enable) {
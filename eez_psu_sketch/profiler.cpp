@@ -0,0 +1,167 @@
+/*
+ * EEZ PSU Firmware
+ * Copyright (C) 2018-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "psu.h"
+
+#if CONF_PROFILER
+
+#include "profiler.h"
+
+namespace eez {
+namespace psu {
+namespace profiler {
+
+static const char *g_sectionNames[NUM_SECTIONS] = {
+    "MAIN_LOOP",
+    "DEBUG",
+    "ONTIME",
+    "TEMPERATURE",
+    "FAN",
+    "CHANNELS",
+    "TRIGGER",
+    "LIST",
+    "EVENT_QUEUE",
+    "SOUND",
+    "PROFILE",
+    "EEPROM",
+    "DLOG_FILE",
+    "SERIAL",
+    "DATETIME",
+    "ETHERNET",
+    "NTP",
+    "IDLE",
+    "GUI_TOUCH",
+    "GUI",
+    "WATCHDOG",
+
+    "CRITICAL_TICK",
+    "CRITICAL_TICK_INTERVAL",
+    "CRITICAL_LIST",
+    "CRITICAL_DLOG",
+    "CRITICAL_ADC",
+    "CRITICAL_IO_PINS",
+    "CRITICAL_TOUCH"
+};
+
+static Stats g_stats[NUM_SECTIONS];
+static uint32_t g_lastCriticalTick;
+static bool g_lastCriticalTickValid;
+static uint32_t g_criticalTickDeadlineMisses;
+
+static uint32_t getHistogramTotal(const Stats &stats) {
+    uint32_t total = 0;
+    for (int i = 0; i < NUM_BUCKETS; ++i) {
+        total += stats.histogram[i];
+    }
+    return total;
+}
+
+uint32_t Stats::getAvg() const {
+    uint32_t total = getHistogramTotal(*this);
+    return total > 0 ? sum / total : 0;
+}
+
+uint32_t Stats::getP99() const {
+    uint32_t total = getHistogramTotal(*this);
+    if (total == 0) {
+        return 0;
+    }
+
+    uint32_t threshold = total - total / 100;
+    uint32_t sum = 0;
+    for (int i = 0; i < NUM_BUCKETS - 1; ++i) {
+        sum += histogram[i];
+        if (sum >= threshold) {
+            uint32_t upperBound = (1UL << i) - 1;
+            return upperBound < max ? upperBound : max;
+        }
+    }
+
+    return max;
+}
+
+void reset() {
+    memset(g_stats, 0, sizeof(g_stats));
+    g_lastCriticalTickValid = false;
+    g_criticalTickDeadlineMisses = 0;
+}
+
+void record(Section section, uint32_t duration) {
+    Stats &stats = g_stats[section];
+
+    if (stats.count == 0 || duration < stats.min) {
+        stats.min = duration;
+    }
+    if (duration > stats.max) {
+        stats.max = duration;
+    }
+    ++stats.count;
+
+    // number of significant bits
+    int bucket = 0;
+    uint32_t bits = duration;
+    while (bits > 0 && bucket < NUM_BUCKETS - 1) {
+        bits >>= 1;
+        ++bucket;
+    }
+
+    if (stats.histogram[bucket] == 0xFFFF || stats.sum > 0xFFFFFFFFUL - duration) {
+        for (int i = 0; i < NUM_BUCKETS; ++i) {
+            stats.histogram[i] >>= 1;
+        }
+        stats.sum >>= 1;
+    }
+
+    ++stats.histogram[bucket];
+    stats.sum += duration;
+}
+
+void criticalTickStarted(uint32_t tick_usec) {
+    if (g_lastCriticalTickValid) {
+        uint32_t interval = tick_usec - g_lastCriticalTick;
+        record(SECTION_CRITICAL_TICK_INTERVAL, interval);
+        if (interval > CONF_PROFILER_CRITICAL_TICK_DEADLINE_US) {
+            ++g_criticalTickDeadlineMisses;
+        }
+    }
+
+    g_lastCriticalTick = tick_usec;
+    g_lastCriticalTickValid = true;
+}
+
+void criticalTickSuspended() {
+    g_lastCriticalTickValid = false;
+}
+
+const char *getSectionName(Section section) {
+    return g_sectionNames[section];
+}
+
+const Stats &getStats(Section section) {
+    return g_stats[section];
+}
+
+uint32_t getCriticalTickDeadlineMisses() {
+    return g_criticalTickDeadlineMisses;
+}
+
+}
+}
+} // namespace eez::psu::profiler
+
+#endif
@@ -0,0 +1,126 @@
+/*
+ * EEZ PSU Firmware
+ * Copyright (C) 2018-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+namespace eez {
+namespace psu {
+/// Time budget of the main loop and critical tick subsystems.
+namespace profiler {
+
+enum Section {
+    SECTION_MAIN_LOOP,
+    SECTION_DEBUG,
+    SECTION_ONTIME,
+    SECTION_TEMPERATURE,
+    SECTION_FAN,
+    SECTION_CHANNELS,
+    SECTION_TRIGGER,
+    SECTION_LIST,
+    SECTION_EVENT_QUEUE,
+    SECTION_SOUND,
+    SECTION_PROFILE,
+    SECTION_EEPROM,
+    SECTION_DLOG_FILE,
+    SECTION_SERIAL,
+    SECTION_DATETIME,
+    SECTION_ETHERNET,
+    SECTION_NTP,
+    SECTION_IDLE,
+    SECTION_GUI_TOUCH,
+    SECTION_GUI,
+    SECTION_WATCHDOG,
+
+    SECTION_CRITICAL_TICK,
+    SECTION_CRITICAL_TICK_INTERVAL,
+    SECTION_CRITICAL_LIST,
+    SECTION_CRITICAL_DLOG,
+    SECTION_CRITICAL_ADC,
+    SECTION_CRITICAL_IO_PINS,
+    SECTION_CRITICAL_TOUCH,
+
+    NUM_SECTIONS
+};
+
+/// Histogram bucket i counts durations in the range [2^(i-1), 2^i - 1] us,
+/// the last bucket counts also all the longer durations (1 ms or more).
+static const int NUM_BUCKETS = 12;
+
+/// Statistics of one section, 40 bytes.
+/// When a histogram bucket or the sum is about to overflow, histogram and sum are halved,
+/// so avg and p99 weigh the older durations less, while count, min and max are kept.
+struct Stats {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    /// Sum of the durations counted in the histogram.
+    uint32_t sum;
+    uint16_t histogram[NUM_BUCKETS];
+
+    uint32_t getAvg() const;
+    /// Upper bound of the histogram bucket which contains the 99th percentile.
+    uint32_t getP99() const;
+};
+
+void reset();
+
+void record(Section section, uint32_t duration);
+
+/// Called at the beginning of every critical tick, records the interval from the previous one
+/// and counts it as a deadline miss if it is longer than CONF_PROFILER_CRITICAL_TICK_DEADLINE_US.
+void criticalTickStarted(uint32_t tick_usec);
+/// Called when critical tick is not executed (power is down), so this time is not a deadline miss.
+void criticalTickSuspended();
+
+const char *getSectionName(Section section);
+const Stats &getStats(Section section);
+uint32_t getCriticalTickDeadlineMisses();
+
+/// Measures consecutive sections with only one micros() call per section.
+class Stopwatch {
+public:
+    /// Starts measuring from the given micros() value, so caller can pass the one it already has.
+    explicit Stopwatch(uint32_t startTime) : m_lastTime(startTime) {}
+
+    /// Records time elapsed since the previous lap (or start) to the given section.
+    void lap(Section section) {
+        uint32_t now = micros();
+        record(section, now - m_lastTime);
+        m_lastTime = now;
+    }
+
+    /// micros() at the previous lap (or start).
+    uint32_t getLastTime() const {
+        return m_lastTime;
+    }
+
+private:
+    uint32_t m_lastTime;
+};
+
+}
+}
+} // namespace eez::psu::profiler
+
+#if CONF_PROFILER
+#define PROFILER_STOPWATCH(name, startTime) profiler::Stopwatch name(startTime)
+#define PROFILER_LAP(name, section) name.lap(profiler::section)
+#else
+#define PROFILER_STOPWATCH(name, startTime)
+#define PROFILER_LAP(name, section)
+#endif
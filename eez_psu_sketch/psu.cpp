@@ -66,6 +66,7 @@
 #include "list.h"
 #include "io_pins.h"
 #include "idle.h"
+#include "profiler.h"
 
 namespace eez {
 namespace psu {
@@ -318,7 +319,9 @@ static bool psuReset() {
 
 #if OPTION_ETHERNET
     if (ethernet::g_testResult == TEST_OK) {
-        scpi::resetContext(&ethernet::g_scpiContext);
+        for (int i = 0; i < CONF_ETHERNET_MAX_SESSIONS; ++i) {
+            scpi::resetContext(&ethernet::g_scpiContext[i]);
+        }
 	}
 
     ntp::reset();
@@ -566,12 +569,16 @@ void boot() {
 //
 //    using namespace event_queue;
 //
-//    DebugTraceF("%d", sizeof(EventQueueHeader));                                    // 12
+//    DebugTraceF("%d", sizeof(EventQueueHeader));                                    // 8
 //    DebugTraceF("%d", offsetof(EventQueueHeader, magicNumber));                     // 0
 //    DebugTraceF("%d", offsetof(EventQueueHeader, version));                         // 4
-//    DebugTraceF("%d", offsetof(EventQueueHeader, head));                            // 6
-//    DebugTraceF("%d", offsetof(EventQueueHeader, size));                            // 8
-//    DebugTraceF("%d", offsetof(EventQueueHeader, lastErrorEventIndex));             // 10
+//    DebugTraceF("%d", offsetof(EventQueueHeader, capacity));                        // 6
+//
+//    DebugTraceF("%d", sizeof(EventRecord));                                         // 8
+//    DebugTraceF("%d", offsetof(EventRecord, dateTime));                             // 0
+//    DebugTraceF("%d", offsetof(EventRecord, eventId));                              // 4
+//    DebugTraceF("%d", offsetof(EventRecord, sequence));                             // 6
+//    DebugTraceF("%d", offsetof(EventRecord, flags));                                // 7
 //
 //    DebugTraceF("%d", sizeof(Event));                                               // 8
 //    DebugTraceF("%d", offsetof(Event, dateTime));                                   // 0
@@ -679,6 +686,9 @@ void powerDown() {
 
 	event_queue::pushEvent(event_queue::EVENT_INFO_POWER_DOWN);
 
+    // don't keep persistent data in the EEPROM write-back cache while in standby
+    eeprom::flush();
+
 #if EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R3B4 || EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R5B12
     fan::g_testResult = TEST_OK;
 #endif
@@ -812,15 +822,24 @@ void tick() {
 
 	uint32_t tick_usec = criticalTick(-1);
 
+#if CONF_PROFILER
+    uint32_t loopStart = tick_usec;
+#endif
+    PROFILER_STOPWATCH(stopwatch, micros());
+
 #if CONF_DEBUG
     debug::tick(tick_usec);
+    PROFILER_LAP(stopwatch, SECTION_DEBUG);
 #endif
 
 	g_powerOnTimeCounter.tick(tick_usec);
+    PROFILER_LAP(stopwatch, SECTION_ONTIME);
 
 	temperature::tick(tick_usec);
+    PROFILER_LAP(stopwatch, SECTION_TEMPERATURE);
 
 	fan::tick(tick_usec);
+    PROFILER_LAP(stopwatch, SECTION_FAN);
 
     ////dummy eeprom read
     //uint8_t buf[128];
@@ -829,34 +848,53 @@ void tick() {
     for (int i = 0; i < CH_NUM; ++i) {
         Channel::get(i).tick(tick_usec);
     }
+    PROFILER_LAP(stopwatch, SECTION_CHANNELS);
 
     trigger::tick(tick_usec);
+    PROFILER_LAP(stopwatch, SECTION_TRIGGER);
 
     list::tick(tick_usec);
+    PROFILER_LAP(stopwatch, SECTION_LIST);
 
 	event_queue::tick(tick_usec);
+    PROFILER_LAP(stopwatch, SECTION_EVENT_QUEUE);
 
     // if we move this, for example, after ethernet::tick we could get
     // (in certain situations, see #25) PWRGOOD error on channel after
     // the "pow:syst 1" command is executed 
 	sound::tick(tick_usec);
+    PROFILER_LAP(stopwatch, SECTION_SOUND);
 
     profile::tick(tick_usec);
+    PROFILER_LAP(stopwatch, SECTION_PROFILE);
+
+    eeprom::tick(tick_usec);
+    PROFILER_LAP(stopwatch, SECTION_EEPROM);
+
+#if OPTION_SD_CARD
+    dlog::fileTick(tick_usec);
+    PROFILER_LAP(stopwatch, SECTION_DLOG_FILE);
+#endif
 
     serial::tick(tick_usec);
+    PROFILER_LAP(stopwatch, SECTION_SERIAL);
 
     datetime::tick(tick_usec);
+    PROFILER_LAP(stopwatch, SECTION_DATETIME);
 
 #if OPTION_ETHERNET
     if (g_mainLoopCounter % 2 == 0) {
         // tick ethernet every other time
 	    ethernet::tick(tick_usec);
+        PROFILER_LAP(stopwatch, SECTION_ETHERNET);
     } else {
 	    ntp::tick(tick_usec);
+        PROFILER_LAP(stopwatch, SECTION_NTP);
     }
 #endif
 
     idle::tick();
+    PROFILER_LAP(stopwatch, SECTION_IDLE);
     
 #if OPTION_DISPLAY
 #ifdef EEZ_PSU_SIMULATOR
@@ -864,11 +902,23 @@ void tick() {
 #endif
         gui::touch::tick(tick_usec);
         gui::touchHandling(tick_usec);
+        PROFILER_LAP(stopwatch, SECTION_GUI_TOUCH);
 
         if (g_mainLoopCounter % 2 == 1) {
             // tick gui every other time
             tick_usec = micros();
+#ifdef EEZ_PSU_SIMULATOR
+            if (simulator::g_onFrameStart) {
+                simulator::g_onFrameStart();
+            }
+#endif
             gui::tick(tick_usec);
+#ifdef EEZ_PSU_SIMULATOR
+            if (simulator::g_onFrameEnd) {
+                simulator::g_onFrameEnd();
+            }
+#endif
+            PROFILER_LAP(stopwatch, SECTION_GUI);
         }
 #ifdef EEZ_PSU_SIMULATOR
     }
@@ -881,16 +931,35 @@ void tick() {
 
 #if OPTION_WATCHDOG && (EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R3B4 || EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R5B12)
     watchdog::tick(tick_usec);
+    PROFILER_LAP(stopwatch, SECTION_WATCHDOG);
+#endif
+
+#if CONF_PROFILER
+    profiler::record(profiler::SECTION_MAIN_LOOP, stopwatch.getLastTime() - loopStart);
 #endif
 }
 
 uint32_t criticalTick(int pageId) {
     uint32_t tick_usec = micros();
 
+#ifdef EEZ_PSU_SIMULATOR
+    if (simulator::g_onCriticalTick) {
+        simulator::g_onCriticalTick();
+    }
+#endif
+
     if (!g_powerIsUp) {
+#if CONF_PROFILER
+        profiler::criticalTickSuspended();
+#endif
         return tick_usec;
     }
 
+#if CONF_PROFILER
+    profiler::criticalTickStarted(tick_usec);
+#endif
+    PROFILER_STOPWATCH(stopwatch, tick_usec);
+
     static uint32_t lastTickList = 0;
     if (list::isActive()) {
         if (lastTickList == 0) {
@@ -899,6 +968,7 @@ uint32_t criticalTick(int pageId) {
             lastTickList = tick_usec;
             list::tick(tick_usec);
             io_pins::tick(tick_usec);
+            PROFILER_LAP(stopwatch, SECTION_CRITICAL_LIST);
         }
     } else {
         lastTickList = 0;
@@ -906,17 +976,26 @@ uint32_t criticalTick(int pageId) {
 
 #if OPTION_SD_CARD
 	dlog::tick(tick_usec);
+    PROFILER_LAP(stopwatch, SECTION_CRITICAL_DLOG);
 #endif
 
+    uint32_t adcTickPeriod = ADC_READ_TIME_US / 2;
+    for (int i = 0; i < CH_NUM; ++i) {
+        if (Channel::get(i).getAcquisitionMode() == ACQUISITION_MODE_CONTINUOUS) {
+            adcTickPeriod = ADC_CONTINUOUS_READ_TIME_US / 2;
+        }
+    }
+
     static uint32_t lastTickAdc = 0;
     if (lastTickAdc == 0) {
         lastTickAdc = tick_usec;
-    } else if (tick_usec - lastTickAdc >= ADC_READ_TIME_US / 2) {
+    } else if (tick_usec - lastTickAdc >= adcTickPeriod) {
         lastTickAdc = tick_usec;
 
         for (int i = 0; i < CH_NUM; ++i) {
             Channel::get(i).tick(tick_usec);
         }
+        PROFILER_LAP(stopwatch, SECTION_CRITICAL_ADC);
     }
 
     static uint32_t lastTickIoPins = 0;
@@ -925,6 +1004,7 @@ uint32_t criticalTick(int pageId) {
     } else if (tick_usec - lastTickIoPins >= 1000) {
         lastTickIoPins = tick_usec;
         io_pins::tick(tick_usec);
+        PROFILER_LAP(stopwatch, SECTION_CRITICAL_IO_PINS);
     }
 
 #if OPTION_DISPLAY
@@ -938,11 +1018,16 @@ uint32_t criticalTick(int pageId) {
             lastTickTouch = tick_usec;
             gui::touch::tick(tick_usec);
             gui::touchHandling(tick_usec);
+            PROFILER_LAP(stopwatch, SECTION_CRITICAL_TOUCH);
         }
 #ifdef EEZ_PSU_SIMULATOR
     }
 #endif
 
+#endif
+
+#if CONF_PROFILER
+    profiler::record(profiler::SECTION_CRITICAL_TICK, stopwatch.getLastTime() - tick_usec);
 #endif
 
     if (pageId != -1) {
@@ -960,7 +1045,9 @@ void regSet(scpi_reg_name_t name, scpi_reg_val_t val) {
     }
 #if OPTION_ETHERNET
 	if (ethernet::g_testResult == TEST_OK) {
-        SCPI_RegSet(&ethernet::g_scpiContext, name, val);
+        for (int i = 0; i < CONF_ETHERNET_MAX_SESSIONS; ++i) {
+            SCPI_RegSet(&ethernet::g_scpiContext[i], name, val);
+        }
 	}
 #endif
 }
@@ -971,7 +1058,9 @@ void psuRegSet(scpi_psu_reg_name_t name, scpi_reg_val_t val) {
     }
 #if OPTION_ETHERNET
 	if (ethernet::g_testResult == TEST_OK) {
-        reg_set(&ethernet::g_scpiContext, name, val);
+        for (int i = 0; i < CONF_ETHERNET_MAX_SESSIONS; ++i) {
+            reg_set(&ethernet::g_scpiContext[i], name, val);
+        }
 	}
 #endif
 }
@@ -982,7 +1071,9 @@ void setEsrBits(int bit_mask) {
     }
 #if OPTION_ETHERNET
 	if (ethernet::g_testResult == TEST_OK) {
-        SCPI_RegSetBits(&ethernet::g_scpiContext, SCPI_REG_ESR, bit_mask);
+        for (int i = 0; i < CONF_ETHERNET_MAX_SESSIONS; ++i) {
+            SCPI_RegSetBits(&ethernet::g_scpiContext[i], SCPI_REG_ESR, bit_mask);
+        }
 	}
 #endif
 }
@@ -994,7 +1085,9 @@ void setQuesBits(int bit_mask, bool on) {
     }
 #if OPTION_ETHERNET
 	if (ethernet::g_testResult == TEST_OK) {
-        reg_set_ques_bit(&ethernet::g_scpiContext, bit_mask, on);
+        for (int i = 0; i < CONF_ETHERNET_MAX_SESSIONS; ++i) {
+            reg_set_ques_bit(&ethernet::g_scpiContext[i], bit_mask, on);
+        }
 	}
 #endif
 }
@@ -1005,7 +1098,9 @@ void setOperBits(int bit_mask, bool on) {
     }
 #if OPTION_ETHERNET
 	if (ethernet::g_testResult == TEST_OK) {
-        reg_set_oper_bit(&ethernet::g_scpiContext, bit_mask, on);
+        for (int i = 0; i < CONF_ETHERNET_MAX_SESSIONS; ++i) {
+            reg_set_oper_bit(&ethernet::g_scpiContext[i], bit_mask, on);
+        }
 	}
 #endif
 }
@@ -1016,7 +1111,9 @@ void generateError(int16_t error) {
     }
 #if OPTION_ETHERNET
 	if (ethernet::g_testResult == TEST_OK) {
-        SCPI_ErrorPush(&ethernet::g_scpiContext, error);
+        for (int i = 0; i < CONF_ETHERNET_MAX_SESSIONS; ++i) {
+            SCPI_ErrorPush(&ethernet::g_scpiContext[i], error);
+        }
     }
 #endif
 	event_queue::pushEvent(error);
@@ -1107,7 +1204,7 @@ void limitMaxCurrent(MaxCurrentLimitCause cause) {
 
 		if (isMaxCurrentLimited()) {
 			for (int i = 0; i < CH_NUM; ++i) {
-				if (Channel::get(i).isOutputEnabled() && Channel::get(i).i.mon_last > ERR_MAX_CURRENT) {
+				if (Channel::get(i).isOutputEnabled() && Channel::get(i).i.getMonLast() > ERR_MAX_CURRENT) {
 					Channel::get(i).setCurrent(Channel::get(i).i.min);
 				}
 
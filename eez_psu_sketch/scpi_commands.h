@@ -66,6 +66,13 @@
     SCPI_COMMAND("DISPlay[:WINdow]:TEXT?", scpi_cmd_displayWindowTextQ) \
     SCPI_COMMAND("DISPlay[:WINdow][:STATe]", scpi_cmd_displayWindowState) \
     SCPI_COMMAND("DISPlay[:WINdow][:STATe]?", scpi_cmd_displayWindowStateQ) \
+    SCPI_COMMAND("FETCh:ARRay:CURRent[:DC]?", scpi_cmd_fetchArrayCurrentDcQ) \
+    SCPI_COMMAND("FETCh:ARRay:POWer[:DC]?", scpi_cmd_fetchArrayPowerDcQ) \
+    SCPI_COMMAND("FETCh:ARRay[:VOLTage][:DC]?", scpi_cmd_fetchArrayVoltageDcQ) \
+    SCPI_COMMAND("FORMat:BORDer", scpi_cmd_formatBorder) \
+    SCPI_COMMAND("FORMat:BORDer?", scpi_cmd_formatBorderQ) \
+    SCPI_COMMAND("FORMat[:DATA]", scpi_cmd_formatData) \
+    SCPI_COMMAND("FORMat[:DATA]?", scpi_cmd_formatDataQ) \
     SCPI_COMMAND("INITiate:CONTinuous", scpi_cmd_initiateContinuous) \
     SCPI_COMMAND("INITiate:CONTinuous?", scpi_cmd_initiateContinuousQ) \
     SCPI_COMMAND("INITiate[:IMMediate]", scpi_cmd_initiateImmediate) \
@@ -103,6 +110,7 @@
     SCPI_COMMAND("MMEMory:COPY", scpi_cmd_mmemoryCopy) \
     SCPI_COMMAND("MMEMory:DATE?", scpi_cmd_mmemoryDateQ) \
     SCPI_COMMAND("MMEMory:DELete", scpi_cmd_mmemoryDelete) \
+    SCPI_COMMAND("MMEMory:DLOG:PREView?", scpi_cmd_mmemoryDlogPreviewQ) \
     SCPI_COMMAND("MMEMory:DOWNload:DATA", scpi_cmd_mmemoryDownloadData) \
     SCPI_COMMAND("MMEMory:DOWNload:FNAMe", scpi_cmd_mmemoryDownloadFname) \
     SCPI_COMMAND("MMEMory:DOWNload:SIZE", scpi_cmd_mmemoryDownloadSize) \
@@ -130,6 +138,10 @@
     SCPI_COMMAND("OUTPut:PROTection:COUPle?", scpi_cmd_outputProtectionCoupleQ) \
     SCPI_COMMAND("OUTPut:TRACk[:STATe]", scpi_cmd_outputTrackState) \
     SCPI_COMMAND("OUTPut:TRACk[:STATe]?", scpi_cmd_outputTrackStateQ) \
+    SCPI_COMMAND("SENSe:ACQuisition:MODE", scpi_cmd_senseAcquisitionMode) \
+    SCPI_COMMAND("SENSe:ACQuisition:MODE?", scpi_cmd_senseAcquisitionModeQ) \
+    SCPI_COMMAND("SENSe:ACQuisition:RATE", scpi_cmd_senseAcquisitionRate) \
+    SCPI_COMMAND("SENSe:ACQuisition:RATE?", scpi_cmd_senseAcquisitionRateQ) \
     SCPI_COMMAND("SENSe:CURRent[:DC]:RANGe:AUTO", scpi_cmd_senseCurrentDcRangeAuto) \
     SCPI_COMMAND("SENSe:CURRent[:DC]:RANGe:AUTO?", scpi_cmd_senseCurrentDcRangeAutoQ) \
     SCPI_COMMAND("SENSe:CURRent[:DC]:RANGe[:UPPer]", scpi_cmd_senseCurrentDcRangeUpper) \
@@ -142,8 +154,11 @@
     SCPI_COMMAND("SENSe:DLOG:FUNCtion:POWer?", scpi_cmd_senseDlogFunctionPowerQ) \
     SCPI_COMMAND("SENSe:DLOG:PERiod", scpi_cmd_senseDlogPeriod) \
     SCPI_COMMAND("SENSe:DLOG:PERiod?", scpi_cmd_senseDlogPeriodQ) \
+    SCPI_COMMAND("SENSe:DLOG:SOURce", scpi_cmd_senseDlogSource) \
+    SCPI_COMMAND("SENSe:DLOG:SOURce?", scpi_cmd_senseDlogSourceQ) \
     SCPI_COMMAND("SENSe:DLOG:TIME", scpi_cmd_senseDlogTime) \
     SCPI_COMMAND("SENSe:DLOG:TIME?", scpi_cmd_senseDlogTimeQ) \
+    SCPI_COMMAND("SENSe:HISTory?", scpi_cmd_senseHistoryQ) \
     SCPI_COMMAND("[SOURce#]:CURRent:LIMit[:POSitive][:IMMediate][:AMPLitude]", scpi_cmd_sourceCurrentLimitPositiveImmediateAmplitude) \
     SCPI_COMMAND("[SOURce#]:CURRent:LIMit[:POSitive][:IMMediate][:AMPLitude]?", scpi_cmd_sourceCurrentLimitPositiveImmediateAmplitudeQ) \
     SCPI_COMMAND("[SOURce#]:CURRent:MODE", scpi_cmd_sourceCurrentMode) \
@@ -256,6 +271,8 @@
     SCPI_COMMAND("SYSTem:COMMunicate:ETHernet:PORT?", scpi_cmd_systemCommunicateEthernetPortQ) \
     SCPI_COMMAND("SYSTem:COMMunicate:ETHernet:SMASk", scpi_cmd_systemCommunicateEthernetSmask) \
     SCPI_COMMAND("SYSTem:COMMunicate:ETHernet:SMASk?", scpi_cmd_systemCommunicateEthernetSmaskQ) \
+    SCPI_COMMAND("SYSTem:COMMunicate:NOTify[:STATe]", scpi_cmd_systemCommunicateNotify) \
+    SCPI_COMMAND("SYSTem:COMMunicate:NOTify[:STATe]?", scpi_cmd_systemCommunicateNotifyQ) \
     SCPI_COMMAND("SYSTem:COMMunicate:NTP", scpi_cmd_systemCommunicateNtp) \
     SCPI_COMMAND("SYSTem:COMMunicate:NTP?", scpi_cmd_systemCommunicateNtpQ) \
     SCPI_COMMAND("SYSTem:COMMunicate:RLSTate", scpi_cmd_systemCommunicateRlstate) \
@@ -272,6 +289,8 @@
     SCPI_COMMAND("SYSTem:CPU:OPTion?", scpi_cmd_systemCpuOptionQ) \
     SCPI_COMMAND("SYSTem:DATE", scpi_cmd_systemDate) \
     SCPI_COMMAND("SYSTem:DATE?", scpi_cmd_systemDateQ) \
+    SCPI_COMMAND("SYSTem:DEBug:PROFile?", scpi_cmd_systemDebugProfileQ) \
+    SCPI_COMMAND("SYSTem:DEBug:PROFile:RESet", scpi_cmd_systemDebugProfileReset) \
     SCPI_COMMAND("SYSTem:DIGital:INPut:DATA?", scpi_cmd_systemDigitalInputDataQ) \
     SCPI_COMMAND("SYSTem:DIGital:OUTPut:DATA", scpi_cmd_systemDigitalOutputData) \
     SCPI_COMMAND("SYSTem:DIGital:OUTPut:DATA?", scpi_cmd_systemDigitalOutputDataQ) \
@@ -284,6 +303,9 @@
     SCPI_COMMAND("SYSTem:INHibit?", scpi_cmd_systemInhibitQ) \
     SCPI_COMMAND("SYSTem:KLOCk", scpi_cmd_systemKlock) \
     SCPI_COMMAND("SYSTem:LOCal", scpi_cmd_systemLocal) \
+    SCPI_COMMAND("SYSTem:LOCK:OWNer?", scpi_cmd_systemLockOwnerQ) \
+    SCPI_COMMAND("SYSTem:LOCK:RELease", scpi_cmd_systemLockRelease) \
+    SCPI_COMMAND("SYSTem:LOCK:REQuest?", scpi_cmd_systemLockRequestQ) \
     SCPI_COMMAND("SYSTem:PASSword:CALibration:RESet", scpi_cmd_systemPasswordCalibrationReset) \
     SCPI_COMMAND("SYSTem:PASSword:FPANel:RESet", scpi_cmd_systemPasswordFpanelReset) \
     SCPI_COMMAND("SYSTem:PASSword:NEW", scpi_cmd_systemPasswordNew) \
@@ -338,6 +360,9 @@
     SCPI_COMMAND("SIMUlator:RPOL?", scpi_cmd_simulatorRpolQ) \
     SCPI_COMMAND("SIMUlator:TEMPerature", scpi_cmd_simulatorTemperature) \
     SCPI_COMMAND("SIMUlator:TEMPerature?", scpi_cmd_simulatorTemperatureQ) \
+    SCPI_COMMAND("SIMUlator:TIME?", scpi_cmd_simulatorTimeQ) \
+    SCPI_COMMAND("SIMUlator:TIME:MODE", scpi_cmd_simulatorTimeMode) \
+    SCPI_COMMAND("SIMUlator:TIME:MODE?", scpi_cmd_simulatorTimeModeQ) \
     SCPI_COMMAND("SIMUlator:VOLTage:PROGram:EXTernal", scpi_cmd_simulatorVoltageProgramExternal) \
     SCPI_COMMAND("SIMUlator:VOLTage:PROGram:EXTernal?", scpi_cmd_simulatorVoltageProgramExternalQ) \
     SCPI_COMMAND("DEBUg", scpi_cmd_debug) \
@@ -192,12 +192,15 @@ scpi_result_t scpi_cmd_debugMeasureVoltage(scpi_t *context) {
 
         channel->adc.start(AnalogDigitalConverter::ADC_REG0_READ_U_MON);
         delayMicroseconds(2000);
-        int16_t adc_data = channel->adc.read();
-        channel->eventAdcData(adc_data, false);
+        AdcSample sample;
+        sample.reg0 = AnalogDigitalConverter::ADC_REG0_READ_U_MON;
+        sample.data = channel->adc.read();
+        sample.tick_usec = micros();
+        channel->eventAdcData(sample);
 
         SERIAL_PORT.print((int)debug::g_uMon[channel->index - 1].get());
         SERIAL_PORT.print(" ");
-        SERIAL_PORT.print(channel->u.mon_last, 5);
+        SERIAL_PORT.print(channel->u.getMonLast(), 5);
         SERIAL_PORT.println("V");
 
         int32_t diff = micros() - tickCount;
@@ -235,12 +238,15 @@ scpi_result_t scpi_cmd_debugMeasureCurrent(scpi_t *context) {
 
         channel->adc.start(AnalogDigitalConverter::ADC_REG0_READ_I_MON);
         delayMicroseconds(2000);
-        int16_t adc_data = channel->adc.read();
-        channel->eventAdcData(adc_data, false);
+        AdcSample sample;
+        sample.reg0 = AnalogDigitalConverter::ADC_REG0_READ_I_MON;
+        sample.data = channel->adc.read();
+        sample.tick_usec = micros();
+        channel->eventAdcData(sample);
 
         SERIAL_PORT.print((int)debug::g_iMon[channel->index - 1].get());
         SERIAL_PORT.print(" ");
-        SERIAL_PORT.print(channel->i.mon_last, 5);
+        SERIAL_PORT.print(channel->i.getMonLast(), 5);
         SERIAL_PORT.println("A");
 
         int32_t diff = micros() - tickCount;
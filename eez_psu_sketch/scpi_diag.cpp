@@ -113,19 +113,19 @@ scpi_result_t scpi_cmd_diagnosticInformationAdcQ(scpi_t * context) {
     char buffer[64] = { 0 };
 
     strcpy_P(buffer, PSTR("U_SET="));
-    util::strcatVoltage(buffer, channel->u.mon_dac);
+    util::strcatVoltage(buffer, channel->u.getMonDac());
     SCPI_ResultText(context, buffer);
 
     strcpy_P(buffer, PSTR("U_MON="));
-    util::strcatVoltage(buffer, channel->u.mon_last);
+    util::strcatVoltage(buffer, channel->u.getMonLast());
     SCPI_ResultText(context, buffer);
 
     strcpy_P(buffer, PSTR("I_SET="));
-    util::strcatCurrent(buffer, channel->i.mon_dac, getNumSignificantDecimalDigits(VALUE_TYPE_FLOAT_AMPER), channel->index-1);
+    util::strcatCurrent(buffer, channel->i.getMonDac(), getNumSignificantDecimalDigits(VALUE_TYPE_FLOAT_AMPER), channel->index-1);
     SCPI_ResultText(context, buffer);
 
     strcpy_P(buffer, PSTR("I_MON="));
-    util::strcatCurrent(buffer, channel->i.mon_last, getNumSignificantDecimalDigits(VALUE_TYPE_FLOAT_AMPER), channel->index-1);
+    util::strcatCurrent(buffer, channel->i.getMonLast(), getNumSignificantDecimalDigits(VALUE_TYPE_FLOAT_AMPER), channel->index-1);
     SCPI_ResultText(context, buffer);
 
     return SCPI_RES_OK;
@@ -180,6 +180,12 @@ scpi_result_t scpi_cmd_diagnosticInformationProtectionQ(scpi_t * context) {
         util::strcatVoltage(buffer, channel->prot_conf.u_level);
         SCPI_ResultText(context, buffer);
 
+#if CONF_FAST_TRIP_PROTECTION
+        sprintf_P(buffer, PSTR("CH%d u_fast_trip=%d"), channel->index, (int)channel->ovp.fast_trip_enabled); SCPI_ResultText(context, buffer);
+#endif
+        sprintf_P(buffer, PSTR("CH%d u_trip_latency=%lu us"), channel->index, (unsigned long)channel->ovp.trip_latency); SCPI_ResultText(context, buffer);
+        sprintf_P(buffer, PSTR("CH%d u_fast_tripped=%d"), channel->index, (int)channel->ovp.flags.fast_tripped); SCPI_ResultText(context, buffer);
+
         // current
         sprintf_P(buffer, PSTR("CH%d i_tripped=%d" ), channel->index, (int)channel->ocp.flags.tripped         ); SCPI_ResultText(context, buffer);
         sprintf_P(buffer, PSTR("CH%d i_state=%d"   ), channel->index, (int)channel->prot_conf.flags.i_state   ); SCPI_ResultText(context, buffer);
@@ -187,6 +193,12 @@ scpi_result_t scpi_cmd_diagnosticInformationProtectionQ(scpi_t * context) {
         util::strcatDuration(buffer, channel->prot_conf.i_delay);
         SCPI_ResultText(context, buffer);
 
+#if CONF_FAST_TRIP_PROTECTION
+        sprintf_P(buffer, PSTR("CH%d i_fast_trip=%d"), channel->index, (int)channel->ocp.fast_trip_enabled); SCPI_ResultText(context, buffer);
+#endif
+        sprintf_P(buffer, PSTR("CH%d i_trip_latency=%lu us"), channel->index, (unsigned long)channel->ocp.trip_latency); SCPI_ResultText(context, buffer);
+        sprintf_P(buffer, PSTR("CH%d i_fast_tripped=%d"), channel->index, (int)channel->ocp.flags.fast_tripped); SCPI_ResultText(context, buffer);
+
         // power
         sprintf_P(buffer, PSTR("CH%d p_tripped=%d"), channel->index, (int)channel->opp.flags.tripped         ); SCPI_ResultText(context, buffer);
         sprintf_P(buffer, PSTR("CH%d p_state=%d"  ), channel->index, (int)channel->prot_conf.flags.p_state   ); SCPI_ResultText(context, buffer);
@@ -197,6 +209,8 @@ scpi_result_t scpi_cmd_diagnosticInformationProtectionQ(scpi_t * context) {
         sprintf_P(buffer, PSTR("CH%d p_level="), channel->index);
         util::strcatPower(buffer, channel->prot_conf.p_level);
         SCPI_ResultText(context, buffer);
+
+        sprintf_P(buffer, PSTR("CH%d p_trip_latency=%lu us"), channel->index, (unsigned long)channel->opp.trip_latency); SCPI_ResultText(context, buffer);
     }
 
 	for (int i = 0; i < temp_sensor::NUM_TEMP_SENSORS; ++i) {
@@ -199,7 +199,7 @@ scpi_result_t scpi_cmd_senseDlogPeriod(scpi_t * context) {
 
 	if (param.special) {
 		if (param.tag == SCPI_NUM_MIN) {
-			period = dlog::PERIOD_MIN;
+			period = dlog::g_dataSource == dlog::DATA_SOURCE_ADC ? dlog::PERIOD_MIN_ADC : dlog::PERIOD_MIN;
 		}
 		else if (param.tag == SCPI_NUM_MAX) {
 			period = dlog::PERIOD_MAX;
@@ -245,6 +245,49 @@ scpi_result_t scpi_cmd_senseDlogPeriodQ(scpi_t * context) {
 #endif
 }
 
+#if OPTION_SD_CARD
+static scpi_choice_def_t dataSourceChoice[] = {
+	{ "TIMer", dlog::DATA_SOURCE_TIMER },
+	{ "ADC", dlog::DATA_SOURCE_ADC },
+	SCPI_CHOICE_LIST_END /* termination of option list */
+};
+#endif
+
+scpi_result_t scpi_cmd_senseDlogSource(scpi_t * context) {
+#if OPTION_SD_CARD
+	int32_t dataSource;
+	if (!SCPI_ParamChoice(context, dataSourceChoice, &dataSource, true)) {
+		return SCPI_RES_ERR;
+	}
+
+	if (!dlog::isIdle()) {
+		SCPI_ErrorPush(context, SCPI_ERROR_CANNOT_CHANGE_TRANSIENT_TRIGGER);
+		return SCPI_RES_ERR;
+	}
+
+	dlog::g_dataSource = (dlog::DataSource)dataSource;
+
+	if (dlog::g_dataSource == dlog::DATA_SOURCE_TIMER && dlog::g_period < dlog::PERIOD_MIN) {
+		dlog::g_period = dlog::PERIOD_MIN;
+	}
+
+	return SCPI_RES_OK;
+#else
+	SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+	return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_senseDlogSourceQ(scpi_t * context) {
+#if OPTION_SD_CARD
+	resultChoiceName(context, dataSourceChoice, dlog::g_dataSource);
+	return SCPI_RES_OK;
+#else
+	SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+	return SCPI_RES_ERR;
+#endif
+}
+
 scpi_result_t scpi_cmd_senseDlogTime(scpi_t * context) {
 #if OPTION_SD_CARD
 	scpi_number_t param;
@@ -302,6 +345,104 @@ scpi_result_t scpi_cmd_senseDlogTimeQ(scpi_t * context) {
 #endif
 }
 
+#if OPTION_SD_CARD
+void previewCallback(void *param, const float *values, int count) {
+	scpi_t *context = (scpi_t *)param;
+	scpi_psu_t *psuContext = (scpi_psu_t *)context->user_context;
+
+	if (values == NULL) {
+		if (count != -1 && psuContext->dataFormatReal) {
+			SCPI_ResultArbitraryBlockHeader(context, count * sizeof(float));
+		}
+		return;
+	}
+
+	if (psuContext->dataFormatReal) {
+		uint8_t buffer[4];
+		for (int i = 0; i < count; ++i) {
+			uint32_t value;
+			memcpy(&value, &values[i], 4);
+			if (psuContext->dataFormatSwapped) {
+				buffer[0] = value & 0xFF;
+				buffer[1] = (value >> 8) & 0xFF;
+				buffer[2] = (value >> 16) & 0xFF;
+				buffer[3] = value >> 24;
+			} else {
+				buffer[0] = value >> 24;
+				buffer[1] = (value >> 16) & 0xFF;
+				buffer[2] = (value >> 8) & 0xFF;
+				buffer[3] = value & 0xFF;
+			}
+			SCPI_ResultArbitraryBlockData(context, buffer, 4);
+		}
+	} else {
+		for (int i = 0; i < count; ++i) {
+			SCPI_ResultFloat(context, values[i]);
+		}
+	}
+}
+#endif
+
+scpi_result_t scpi_cmd_mmemoryDlogPreviewQ(scpi_t * context) {
+#if OPTION_SD_CARD
+	char filePath[MAX_PATH_LENGTH + 1];
+	if (!getFilePath(context, filePath, true)) {
+		return SCPI_RES_ERR;
+	}
+
+	uint32_t numPixels;
+	if (!SCPI_ParamUInt32(context, &numPixels, true)) {
+		return SCPI_RES_ERR;
+	}
+	if (numPixels < 1 || numPixels > dlog::PREVIEW_PIXELS_MAX) {
+		SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+		return SCPI_RES_ERR;
+	}
+
+	float from = 0;
+	float to = dlog::TIME_MAX;
+
+	scpi_number_t param;
+	if (!SCPI_ParamNumber(context, scpi_special_numbers_def, &param, false)) {
+		if (SCPI_ParamErrorOccurred(context)) {
+			return SCPI_RES_ERR;
+		}
+		// no time window, whole file
+	} else {
+		if (!get_duration_from_param(context, param, from, 0, dlog::TIME_MAX, 0)) {
+			return SCPI_RES_ERR;
+		}
+
+		if (!SCPI_ParamNumber(context, scpi_special_numbers_def, &param, false)) {
+			if (SCPI_ParamErrorOccurred(context)) {
+				return SCPI_RES_ERR;
+			}
+			// time window to the end of the file
+		} else {
+			if (!get_duration_from_param(context, param, to, 0, dlog::TIME_MAX, dlog::TIME_MAX)) {
+				return SCPI_RES_ERR;
+			}
+		}
+
+		if (from >= to) {
+			SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+			return SCPI_RES_ERR;
+		}
+	}
+
+	int err;
+	if (!dlog::getPreview(filePath, from, to, (uint16_t)numPixels, context, previewCallback, &err)) {
+		SCPI_ErrorPush(context, err);
+		return SCPI_RES_ERR;
+	}
+
+	return SCPI_RES_OK;
+#else
+	SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+	return SCPI_RES_ERR;
+#endif
+}
+
 }
 }
 } // namespace eez::psu::scpi
\ No newline at end of file
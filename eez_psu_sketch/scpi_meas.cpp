@@ -79,6 +79,145 @@ scpi_result_t scpi_cmd_measureScalarTemperatureThermistorDcQ(scpi_t * context) {
     return SCPI_RES_OK;
 }
 
+static bool get_fetch_array_params(scpi_t *context, Channel *&channel, int &count) {
+    channel = param_channel(context);
+    if (!channel) {
+        return false;
+    }
+
+    int32_t param;
+    if (SCPI_ParamInt32(context, &param, false)) {
+        if (param < 1 || param > CHANNEL_MEASUREMENT_BUFFER_SIZE) {
+            SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+            return false;
+        }
+        count = param;
+    } else {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return false;
+        }
+        count = CHANNEL_MEASUREMENT_BUFFER_SIZE;
+    }
+
+    return true;
+}
+
+scpi_result_t scpi_cmd_fetchArrayCurrentDcQ(scpi_t * context) {
+    Channel *channel;
+    int count;
+    if (!get_fetch_array_params(context, channel, count)) {
+        return SCPI_RES_ERR;
+    }
+
+    float iMon[CHANNEL_MEASUREMENT_BUFFER_SIZE];
+    count = channel->getMeasurementBufferValues(0, iMon, count);
+
+    resultArrayFloat(context, iMon, count);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_fetchArrayPowerDcQ(scpi_t * context) {
+    Channel *channel;
+    int count;
+    if (!get_fetch_array_params(context, channel, count)) {
+        return SCPI_RES_ERR;
+    }
+
+    float uMon[CHANNEL_MEASUREMENT_BUFFER_SIZE];
+    float iMon[CHANNEL_MEASUREMENT_BUFFER_SIZE];
+    count = channel->getMeasurementBufferValues(uMon, iMon, count);
+
+    for (int i = 0; i < count; ++i) {
+        uMon[i] *= iMon[i];
+    }
+
+    resultArrayFloat(context, uMon, count);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_fetchArrayVoltageDcQ(scpi_t * context) {
+    Channel *channel;
+    int count;
+    if (!get_fetch_array_params(context, channel, count)) {
+        return SCPI_RES_ERR;
+    }
+
+    float uMon[CHANNEL_MEASUREMENT_BUFFER_SIZE];
+    count = channel->getMeasurementBufferValues(uMon, 0, count);
+
+    resultArrayFloat(context, uMon, count);
+
+    return SCPI_RES_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static scpi_choice_def_t dataFormatChoice[] = {
+    { "ASCii", 0 },
+    { "REAL", 1 },
+    SCPI_CHOICE_LIST_END /* termination of option list */
+};
+
+static scpi_choice_def_t byteOrderChoice[] = {
+    { "NORMal", 0 },
+    { "SWAPped", 1 },
+    SCPI_CHOICE_LIST_END /* termination of option list */
+};
+
+scpi_result_t scpi_cmd_formatData(scpi_t * context) {
+    int32_t dataFormat;
+    if (!SCPI_ParamChoice(context, dataFormatChoice, &dataFormat, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    int32_t length;
+    if (SCPI_ParamInt32(context, &length, false)) {
+        // only 32 bit floats are supported
+        if (dataFormat ? length != 32 : length != 0) {
+            SCPI_ErrorPush(context, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+            return SCPI_RES_ERR;
+        }
+    } else if (SCPI_ParamErrorOccurred(context)) {
+        return SCPI_RES_ERR;
+    }
+
+    scpi_psu_t *psuContext = (scpi_psu_t *)context->user_context;
+    psuContext->dataFormatReal = dataFormat ? true : false;
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_formatDataQ(scpi_t * context) {
+    scpi_psu_t *psuContext = (scpi_psu_t *)context->user_context;
+
+    resultChoiceName(context, dataFormatChoice, psuContext->dataFormatReal ? 1 : 0);
+    SCPI_ResultInt(context, psuContext->dataFormatReal ? 32 : 0);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_formatBorder(scpi_t * context) {
+    int32_t byteOrder;
+    if (!SCPI_ParamChoice(context, byteOrderChoice, &byteOrder, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    scpi_psu_t *psuContext = (scpi_psu_t *)context->user_context;
+    psuContext->dataFormatSwapped = byteOrder ? true : false;
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_formatBorderQ(scpi_t * context) {
+    scpi_psu_t *psuContext = (scpi_psu_t *)context->user_context;
+
+    resultChoiceName(context, byteOrderChoice, psuContext->dataFormatSwapped ? 1 : 0);
+
+    return SCPI_RES_OK;
+}
+
 }
 }
-} // namespace eez::psu::scpi
\ No newline at end of file
+} // namespace eez::psu::scpi
@@ -37,6 +37,11 @@ namespace scpi {
 
 bool g_busy;
 
+static char g_outputBuffer[CONF_SCPI_OUTPUT_BUFFER_SIZE];
+static size_t g_outputBufferPosition;
+static scpi_t *g_outputContext;
+static OutputFunction g_outputFunction;
+
 ////////////////////////////////////////////////////////////////////////////////
 
 #define SCPI_COMMAND(P, C) scpi_result_t C(scpi_t * context);
@@ -85,6 +90,9 @@ void init(scpi_t &scpi_context,
 #endif
 	scpi_psu_context.isBufferOverrun = false;
 	scpi_psu_context.bufferOverrunTime =  0;
+    scpi_psu_context.dataFormatReal = false;
+    scpi_psu_context.dataFormatSwapped = false;
+    scpi_psu_context.notify = true;
 
     scpi_context.user_context = &scpi_psu_context;
 }
@@ -123,12 +131,44 @@ void input(scpi_t &context, const char *str, size_t size) {
 		onBufferOverrun(context);
 	}
 
+    flushOutput();
+
     g_busy = false;
 }
 
+size_t bufferedWrite(scpi_t *context, const char *data, size_t len, OutputFunction output) {
+    if (context != g_outputContext) {
+        flushOutput();
+        g_outputContext = context;
+        g_outputFunction = output;
+    }
+
+    if (g_outputBufferPosition + len > CONF_SCPI_OUTPUT_BUFFER_SIZE) {
+        flushOutput();
+        if (len >= CONF_SCPI_OUTPUT_BUFFER_SIZE) {
+            // no point in copying, send it as is
+            return output(context, data, len);
+        }
+    }
+
+    memcpy(g_outputBuffer + g_outputBufferPosition, data, len);
+    g_outputBufferPosition += len;
+
+    return len;
+}
+
+void flushOutput() {
+    if (g_outputBufferPosition > 0) {
+        g_outputFunction(g_outputContext, g_outputBuffer, g_outputBufferPosition);
+        g_outputBufferPosition = 0;
+    }
+}
+
 void printError(int_fast16_t err) {
     sound::playBeep();
 
+    flushOutput();
+
     if (serial::g_testResult == TEST_OK) {
         char errorOutputBuffer[256];
 
@@ -168,11 +208,58 @@ void resultChoiceName(scpi_t *context, scpi_choice_def_t *choice, int tag) {
     }
 }
 
+void resultArrayFloat(scpi_t *context, const float *array, size_t count) {
+    scpi_psu_t *psuContext = (scpi_psu_t *)context->user_context;
+
+    scpi_array_format_t format = SCPI_FORMAT_ASCII;
+    if (psuContext->dataFormatReal) {
+        format = psuContext->dataFormatSwapped ? SCPI_FORMAT_SWAPPED : SCPI_FORMAT_NORMAL;
+    }
+
+    SCPI_ResultArrayFloat(context, array, count, format);
+}
+
+void resultArrayFloatHeader(scpi_t *context, size_t count) {
+    scpi_psu_t *psuContext = (scpi_psu_t *)context->user_context;
+
+    if (psuContext->dataFormatReal) {
+        SCPI_ResultArbitraryBlockHeader(context, count * sizeof(float));
+    }
+}
+
+void resultArrayFloatData(scpi_t *context, const float *array, size_t count) {
+    scpi_psu_t *psuContext = (scpi_psu_t *)context->user_context;
+
+    if (!psuContext->dataFormatReal) {
+        for (size_t i = 0; i < count; ++i) {
+            SCPI_ResultFloat(context, array[i]);
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t bits;
+        memcpy(&bits, array + i, sizeof(bits));
+
+        // NORMal byte order is big endian, SWAPped is little endian
+        uint8_t bytes[sizeof(bits)];
+        for (size_t j = 0; j < sizeof(bits); ++j) {
+            int shift = psuContext->dataFormatSwapped ? 8 * j : 8 * (sizeof(bits) - 1 - j);
+            bytes[j] = (uint8_t)(bits >> shift);
+        }
+
+        SCPI_ResultArbitraryBlockData(context, bytes, sizeof(bytes));
+    }
+}
+
 void resetContext(scpi_t *context) {
     scpi_psu_t *psuContext = (scpi_psu_t *)context->user_context;
 
     psuContext->selected_channel_index = 1;
 
+    psuContext->dataFormatReal = false;
+    psuContext->dataFormatSwapped = false;
+
 #if OPTION_SD_CARD
     psuContext->currentDirectory[0] = 0;
 #endif
@@ -180,6 +267,44 @@ void resetContext(scpi_t *context) {
     SCPI_ErrorClear(context);
 }
 
+bool isStateChangingCommand(scpi_t *context) {
+    const scpi_command_t *cmd = context->param_list.cmd;
+    scpi_command_callback_t callback = cmd->callback;
+
+    // queries don't change the state, except the self test and the queries
+    // which read all the ADC inputs
+    const char *pattern = cmd->pattern;
+    if (pattern[strlen(pattern) - 1] == '?') {
+        return
+            callback == scpi_cmd_coreTstQ ||
+            callback == scpi_cmd_debugQ ||
+            callback == scpi_cmd_diagnosticInformationAdcQ;
+    }
+
+    // commands which change only the state of the SCPI context
+    return !(
+        callback == scpi_cmd_coreCls ||
+        callback == scpi_cmd_coreEse ||
+        callback == scpi_cmd_coreOpc ||
+        callback == scpi_cmd_coreSre ||
+        callback == scpi_cmd_coreWai ||
+        callback == scpi_cmd_formatBorder ||
+        callback == scpi_cmd_formatData ||
+        callback == scpi_cmd_instrumentNselect ||
+        callback == scpi_cmd_instrumentSelect ||
+        callback == scpi_cmd_mmemoryCdirectory ||
+        callback == scpi_cmd_statusOperationEnable ||
+        callback == scpi_cmd_statusOperationInstrumentEnable ||
+        callback == scpi_cmd_statusOperationInstrumentIsummaryEnable ||
+        callback == scpi_cmd_statusPreset ||
+        callback == scpi_cmd_statusQuestionableEnable ||
+        callback == scpi_cmd_statusQuestionableInstrumentEnable ||
+        callback == scpi_cmd_statusQuestionableInstrumentIsummaryEnable ||
+        callback == scpi_cmd_systemCommunicateNotify ||
+        callback == scpi_cmd_systemLockRelease
+    );
+}
+
 }
 }
 } // namespace eez::psu::scpi
\ No newline at end of file
@@ -35,6 +35,12 @@ struct scpi_psu_t {
 #endif
 	bool isBufferOverrun;
 	uint32_t bufferOverrunTime;
+    /// FORMat[:DATA]: REAL,32 if true, otherwise ASCii.
+    bool dataFormatReal;
+    /// FORMat:BORDer: SWAPped if true, otherwise NORMal.
+    bool dataFormatSwapped;
+    /// SYSTem:COMMunicate:NOTify: send unsolicited SRQ notifications to this interface.
+    bool notify;
 };
 
 void init(scpi_t &scpi_context,
@@ -47,17 +53,36 @@ void init(scpi_t &scpi_context,
 
 void input(scpi_t &scpi_context, const char *str, size_t size);
 
+/// Function which sends the data to the interface of the SCPI context.
+typedef size_t (*OutputFunction)(scpi_t *context, const char *data, size_t len);
+
+/// Appends data to the output buffer, output buffer is sent with the given function
+/// when it is full or when some other context starts writing.
+size_t bufferedWrite(scpi_t *context, const char *data, size_t len, OutputFunction output);
+/// Sends buffered output.
+void flushOutput();
+
 void emptyBuffer(scpi_t &context);
 void onBufferOverrun(scpi_t &context);
 
 void printError(int_fast16_t err);
 
 void resultChoiceName(scpi_t *context, scpi_choice_def_t *choice, int tag);
+/// Output array of floats in format selected with FORMat[:DATA] and FORMat:BORDer.
+void resultArrayFloat(scpi_t *context, const float *array, size_t count);
+/// Starts the float array result of count values, which are then written
+/// in parts with resultArrayFloatData, so the whole array is not needed in RAM.
+void resultArrayFloatHeader(scpi_t *context, size_t count);
+void resultArrayFloatData(scpi_t *context, const float *array, size_t count);
 
 extern bool g_busy;
 
 void resetContext(scpi_t *context);
 
+/// Returns false for queries which only read the state and for commands which change
+/// only the state of the given SCPI context. Used to enforce SYSTem:LOCK.
+bool isStateChangingCommand(scpi_t *context);
+
 }
 }
 } // namespace eez::psu::scpi
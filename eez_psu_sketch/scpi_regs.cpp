@@ -100,6 +100,25 @@ static void psu_reg_update_psu_reg(scpi_t * context, scpi_reg_val_t val, scpi_ps
     psu_reg_update(context, psuRegName);
 }
 
+/**
+* Send SRQ notification for the newly raised event if it is enabled up to the STB,
+* but SRQ was already asserted so STB didn't change and SCPI library didn't send it.
+* @param context
+* @param stb STB value before the event was raised
+* @param enabled is event enabled in its event enable register and all the summary enable registers
+* @param stbBit STB bit which summarizes the status register of the event
+*/
+static void psu_reg_notify(scpi_t * context, scpi_reg_val_t stb, bool enabled, scpi_reg_val_t stbBit) {
+    if (enabled &&
+        (stb & STB_SRQ) &&
+        (stbBit & SCPI_RegGet(context, SCPI_REG_SRE)) &&
+        SCPI_RegGet(context, SCPI_REG_STB) == stb &&
+        context->interface && context->interface->control)
+    {
+        context->interface->control(context, SCPI_CTRL_SRQ, stb);
+    }
+}
+
 /**
 * Get PSU specific register value
 * @param name - register name
@@ -197,6 +216,35 @@ void reg_set(scpi_t *context, scpi_psu_reg_name_t name, scpi_reg_val_t val) {
     }
 }
 
+/**
+* Clear all event and enable registers, as *SRE 0, STATus:PRESet and *CLS do.
+* Condition registers are kept, they follow the state of the PSU.
+*/
+void reg_reset(scpi_t *context) {
+    SCPI_RegSet(context, SCPI_REG_SRE, 0);
+    SCPI_RegSet(context, SCPI_REG_ESE, 0);
+    SCPI_RegSet(context, SCPI_REG_QUESE, 0);
+    SCPI_RegSet(context, SCPI_REG_OPERE, 0);
+
+    reg_set(context, SCPI_PSU_REG_QUES_INST_ENABLE, 0);
+    reg_set(context, SCPI_PSU_REG_OPER_INST_ENABLE, 0);
+    reg_set(context, SCPI_PSU_CH_REG_QUES_INST_ISUM_ENABLE1, 0);
+    reg_set(context, SCPI_PSU_CH_REG_OPER_INST_ISUM_ENABLE1, 0);
+    reg_set(context, SCPI_PSU_CH_REG_QUES_INST_ISUM_ENABLE2, 0);
+    reg_set(context, SCPI_PSU_CH_REG_OPER_INST_ISUM_ENABLE2, 0);
+
+    reg_set(context, SCPI_PSU_REG_QUES_INST_EVENT, 0);
+    reg_set(context, SCPI_PSU_REG_OPER_INST_EVENT, 0);
+    reg_set(context, SCPI_PSU_CH_REG_QUES_INST_ISUM_EVENT1, 0);
+    reg_set(context, SCPI_PSU_CH_REG_OPER_INST_ISUM_EVENT1, 0);
+    reg_set(context, SCPI_PSU_CH_REG_QUES_INST_ISUM_EVENT2, 0);
+    reg_set(context, SCPI_PSU_CH_REG_OPER_INST_ISUM_EVENT2, 0);
+
+    SCPI_EventClear(context);
+    SCPI_RegSet(context, SCPI_REG_OPER, 0);
+    SCPI_RegSet(context, SCPI_REG_QUES, 0);
+}
+
 int reg_get_ques_isum_bit_mask_for_channel_protection_value(Channel *channel, Channel::ProtectionValue &cpv) {
     if (IS_OVP_VALUE(channel, cpv))
         return QUES_ISUM_OVP;
@@ -212,8 +260,11 @@ void reg_set_ques_bit(scpi_t *context, int bit_mask, bool on) {
             reg_set(context, SCPI_PSU_REG_QUES_COND, val | bit_mask);
 
             // set event on raising condition
+            scpi_reg_val_t stb = SCPI_RegGet(context, SCPI_REG_STB);
             val = SCPI_RegGet(context, SCPI_REG_QUES);
             SCPI_RegSet(context, SCPI_REG_QUES, val | bit_mask);
+
+            psu_reg_notify(context, stb, (bit_mask & SCPI_RegGet(context, SCPI_REG_QUESE)) != 0, STB_QES);
         }
     }
     else {
@@ -231,9 +282,16 @@ void reg_set_ques_isum_bit(scpi_t *context, Channel *channel, int bit_mask, bool
             reg_set(context, reg_name, val | bit_mask);
 
             // set event on raising condition
+            scpi_reg_val_t stb = SCPI_RegGet(context, SCPI_REG_STB);
             reg_name = channel->index == 1 ? SCPI_PSU_CH_REG_QUES_INST_ISUM_EVENT1 : SCPI_PSU_CH_REG_QUES_INST_ISUM_EVENT2;
             val = reg_get(context, reg_name);
             reg_set(context, reg_name, val | bit_mask);
+
+            psu_reg_notify(context, stb,
+                (bit_mask & reg_get(context, channel->index == 1 ? SCPI_PSU_CH_REG_QUES_INST_ISUM_ENABLE1 : SCPI_PSU_CH_REG_QUES_INST_ISUM_ENABLE2)) &&
+                ((channel->index == 1 ? QUES_ISUM1 : QUES_ISUM2) & reg_get(context, SCPI_PSU_REG_QUES_INST_ENABLE)) &&
+                (QUES_ISUM & SCPI_RegGet(context, SCPI_REG_QUESE)),
+                STB_QES);
         }
     }
     else {
@@ -250,8 +308,11 @@ void reg_set_oper_bit(scpi_t *context, int bit_mask, bool on) {
             reg_set(context, SCPI_PSU_REG_OPER_COND, val | bit_mask);
 
             // set event on raising condition
+            scpi_reg_val_t stb = SCPI_RegGet(context, SCPI_REG_STB);
             val = SCPI_RegGet(context, SCPI_REG_OPER);
             SCPI_RegSet(context, SCPI_REG_OPER, val | bit_mask);
+
+            psu_reg_notify(context, stb, (bit_mask & SCPI_RegGet(context, SCPI_REG_OPERE)) != 0, STB_OPS);
         }
     }
     else {
@@ -269,9 +330,16 @@ void reg_set_oper_isum_bit(scpi_t *context, Channel *channel, int bit_mask, bool
             reg_set(context, reg_name, val | bit_mask);
 
             // set event on raising condition
+            scpi_reg_val_t stb = SCPI_RegGet(context, SCPI_REG_STB);
             reg_name = channel->index == 1 ? SCPI_PSU_CH_REG_OPER_INST_ISUM_EVENT1 : SCPI_PSU_CH_REG_OPER_INST_ISUM_EVENT2;
             val = reg_get(context, reg_name);
             reg_set(context, reg_name, val | bit_mask);
+
+            psu_reg_notify(context, stb,
+                (bit_mask & reg_get(context, channel->index == 1 ? SCPI_PSU_CH_REG_OPER_INST_ISUM_ENABLE1 : SCPI_PSU_CH_REG_OPER_INST_ISUM_ENABLE2)) &&
+                ((channel->index == 1 ? OPER_ISUM1 : OPER_ISUM2) & reg_get(context, SCPI_PSU_REG_OPER_INST_ENABLE)) &&
+                (OPER_ISUM & SCPI_RegGet(context, SCPI_REG_OPERE)),
+                STB_OPS);
         }
     }
     else {
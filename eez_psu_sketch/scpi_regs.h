@@ -111,6 +111,8 @@ enum scpi_psu_reg_name_t {
 
 scpi_reg_val_t reg_get(scpi_t * context, scpi_psu_reg_name_t name);
 void reg_set(scpi_t * context, scpi_psu_reg_name_t name, scpi_reg_val_t val);
+/// Clears all event and enable registers, keeps condition registers.
+void reg_reset(scpi_t *context);
 
 int reg_get_ques_isum_bit_mask_for_channel_protection_value(Channel *channel, Channel::ProtectionValue &cpv);
 
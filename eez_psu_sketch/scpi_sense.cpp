@@ -160,6 +160,152 @@ scpi_result_t scpi_cmd_senseCurrentDcRangeAutoQ(scpi_t * context) {
     return SCPI_RES_OK;
 }
 
+static scpi_choice_def_t acquisitionModeChoice[] = {
+    { "NORMal", ACQUISITION_MODE_NORMAL },
+    { "CONTinuous", ACQUISITION_MODE_CONTINUOUS },
+    SCPI_CHOICE_LIST_END /* termination of option list */
+};
+
+scpi_result_t scpi_cmd_senseAcquisitionMode(scpi_t *context) {
+    int32_t mode;
+    if (!SCPI_ParamChoice(context, acquisitionModeChoice, &mode, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    Channel *channel = param_channel(context);
+    if (!channel) {
+        return SCPI_RES_ERR;
+    }
+
+    channel->setAcquisitionMode((AcquisitionMode)mode);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_senseAcquisitionModeQ(scpi_t *context) {
+    Channel *channel = param_channel(context);
+    if (!channel) {
+        return SCPI_RES_ERR;
+    }
+
+    resultChoiceName(context, acquisitionModeChoice, channel->getAcquisitionMode());
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_senseAcquisitionRate(scpi_t *context) {
+    uint8_t dataRate;
+
+    scpi_number_t param;
+    if (!SCPI_ParamNumber(context, scpi_special_numbers_def, &param, true)) {
+        return SCPI_RES_ERR;
+    }
+    if (param.special) {
+        if (param.tag == SCPI_NUM_MIN) {
+            dataRate = AnalogDigitalConverter::ADC_DATA_RATE_MIN;
+        } else if (param.tag == SCPI_NUM_MAX) {
+            dataRate = AnalogDigitalConverter::ADC_DATA_RATE_MAX;
+        } else if (param.tag == SCPI_NUM_DEF) {
+            dataRate = ADC_SPS;
+        } else {
+            SCPI_ErrorPush(context, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+            return SCPI_RES_ERR;
+        }
+    } else {
+        if (param.unit != SCPI_UNIT_NONE && param.unit != SCPI_UNIT_HERTZ) {
+            SCPI_ErrorPush(context, SCPI_ERROR_INVALID_SUFFIX);
+            return SCPI_RES_ERR;
+        }
+
+        float sps = (float)param.value;
+        if (sps < AnalogDigitalConverter::getDataRateSps(AnalogDigitalConverter::ADC_DATA_RATE_MIN) ||
+            sps > AnalogDigitalConverter::getDataRateSps(AnalogDigitalConverter::ADC_DATA_RATE_MAX)) {
+            SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+            return SCPI_RES_ERR;
+        }
+
+        dataRate = AnalogDigitalConverter::getDataRateFromSps(sps);
+    }
+
+    Channel *channel = param_channel(context);
+    if (!channel) {
+        return SCPI_RES_ERR;
+    }
+
+    channel->setAcquisitionDataRate(dataRate);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_senseAcquisitionRateQ(scpi_t *context) {
+    Channel *channel = param_channel(context);
+    if (!channel) {
+        return SCPI_RES_ERR;
+    }
+
+    SCPI_ResultInt(context, AnalogDigitalConverter::getDataRateSps(channel->getAcquisitionDataRate()));
+
+    return SCPI_RES_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static const int HISTORY_CHUNK_SIZE = 10;
+
+static scpi_choice_def_t historyLevelChoice[] = {
+    { "SECond", history::LEVEL_SECONDS },
+    { "MINute", history::LEVEL_MINUTES },
+    { "HOUR", history::LEVEL_HOURS },
+    SCPI_CHOICE_LIST_END /* termination of option list */
+};
+
+/// SENSe:HISTory? {SECond|MINute|HOUR}[,<count>[,<channel>]]
+/// Returns the last count buckets, oldest first, as U min, U max, U avg, I min, I max, I avg
+/// for every bucket (NaN if there were no samples), in the format set by FORMat[:DATA].
+scpi_result_t scpi_cmd_senseHistoryQ(scpi_t *context) {
+    int32_t level;
+    if (!SCPI_ParamChoice(context, historyLevelChoice, &level, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    int maxCount = history::Store::getMaxCount((history::Level)level);
+
+    int32_t count;
+    if (SCPI_ParamInt32(context, &count, false)) {
+        if (count < 1 || count > maxCount) {
+            SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+            return SCPI_RES_ERR;
+        }
+    } else {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+        count = maxCount;
+    }
+
+    Channel *channel = param_channel(context);
+    if (!channel) {
+        return SCPI_RES_ERR;
+    }
+
+    const history::Store &store = channel->getHistoryStore();
+    if (count > store.getCount((history::Level)level)) {
+        count = store.getCount((history::Level)level);
+    }
+    int first = store.getCount((history::Level)level) - count;
+
+    resultArrayFloatHeader(context, count * history::Store::NUM_VALUES_PER_BUCKET);
+
+    // output in chunks of HISTORY_CHUNK_SIZE buckets to keep the stack usage low
+    float values[history::Store::NUM_VALUES_PER_BUCKET * HISTORY_CHUNK_SIZE];
+    for (int i = 0; i < count; i += HISTORY_CHUNK_SIZE) {
+        int n = store.getValues((history::Level)level, first + i, values, MIN(count - i, HISTORY_CHUNK_SIZE));
+        resultArrayFloatData(context, values, n * history::Store::NUM_VALUES_PER_BUCKET);
+    }
+
+    return SCPI_RES_OK;
+}
+
 }
 }
-} // namespace eez::psu::scpi
\ No newline at end of file
+} // namespace eez::psu::scpi
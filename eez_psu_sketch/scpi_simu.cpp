@@ -331,6 +331,33 @@ scpi_result_t scpi_cmd_simulatorTemperatureQ(scpi_t *context) {
     return result_float(context, 0, value, VALUE_TYPE_FLOAT_CELSIUS);
 }
 
+static scpi_choice_def_t timeModeChoice[] = {
+    { "REAL", TIME_MODE_REAL },
+    { "VIRTual", TIME_MODE_VIRTUAL },
+    SCPI_CHOICE_LIST_END /* termination of option list */
+};
+
+scpi_result_t scpi_cmd_simulatorTimeMode(scpi_t *context) {
+    int32_t timeMode;
+    if (!SCPI_ParamChoice(context, timeModeChoice, &timeMode, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    simulator::setTimeMode((TimeMode)timeMode);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_simulatorTimeModeQ(scpi_t *context) {
+    resultChoiceName(context, timeModeChoice, simulator::getTimeMode());
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_simulatorTimeQ(scpi_t *context) {
+    SCPI_ResultDouble(context, simulator::getTime() / 1000000.0);
+    return SCPI_RES_OK;
+}
+
 scpi_result_t scpi_cmd_simulatorGui(scpi_t *context) {
 #if OPTION_DISPLAY
     if (!simulator::front_panel::open()) {
@@ -441,6 +468,21 @@ scpi_result_t scpi_cmd_simulatorTemperatureQ(scpi_t *context) {
     return SCPI_RES_ERR;
 }
 
+scpi_result_t scpi_cmd_simulatorTimeMode(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
+scpi_result_t scpi_cmd_simulatorTimeModeQ(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
+scpi_result_t scpi_cmd_simulatorTimeQ(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
 scpi_result_t scpi_cmd_simulatorGui(scpi_t *context) {
     SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
     return SCPI_RES_ERR;
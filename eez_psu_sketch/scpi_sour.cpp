@@ -232,7 +232,7 @@ scpi_result_t scpi_cmd_sourceVoltageLevelImmediateAmplitudeQ(scpi_t * context) {
 
 	float u;
 	if (channel->isRemoteProgrammingEnabled()) {
-		u = channel->u.mon_dac;
+		u = channel->u.getMonDac();
 	} else {
 		u = channel_dispatcher::getUSet(*channel);
 	}
@@ -32,6 +32,7 @@
 #include "gui.h"
 #endif
 #include "io_pins.h"
+#include "profiler.h"
 
 namespace eez {
 namespace psu {
@@ -140,6 +141,41 @@ scpi_result_t scpi_cmd_systemDateQ(scpi_t *context) {
     return SCPI_RES_OK;
 }
 
+/// Returns the number of critical tick deadline misses followed by
+/// "<section>", count, min, avg, max and p99 (in microseconds) for every profiler section.
+scpi_result_t scpi_cmd_systemDebugProfileQ(scpi_t *context) {
+#if CONF_PROFILER
+    SCPI_ResultUInt32(context, profiler::getCriticalTickDeadlineMisses());
+
+    for (int i = 0; i < profiler::NUM_SECTIONS; ++i) {
+        profiler::Section section = (profiler::Section)i;
+        const profiler::Stats &stats = profiler::getStats(section);
+
+        SCPI_ResultText(context, profiler::getSectionName(section));
+        SCPI_ResultUInt32(context, stats.count);
+        SCPI_ResultUInt32(context, stats.min);
+        SCPI_ResultUInt32(context, stats.getAvg());
+        SCPI_ResultUInt32(context, stats.max);
+        SCPI_ResultUInt32(context, stats.getP99());
+    }
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_systemDebugProfileReset(scpi_t *context) {
+#if CONF_PROFILER
+    profiler::reset();
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
 scpi_result_t scpi_cmd_systemTime(scpi_t *context) {
     int32_t hour;
     if (!SCPI_ParamInt(context, &hour, TRUE)) {
@@ -775,6 +811,24 @@ scpi_result_t scpi_cmd_systemCommunicateRlstateQ(scpi_t *context) {
 	return SCPI_RES_OK;
 }
 
+scpi_result_t scpi_cmd_systemCommunicateNotify(scpi_t *context) {
+    bool enable;
+    if (!SCPI_ParamBool(context, &enable, TRUE)) {
+        return SCPI_RES_ERR;
+    }
+
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+    psu_context->notify = enable;
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_systemCommunicateNotifyQ(scpi_t *context) {
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+    SCPI_ResultBool(context, psu_context->notify);
+    return SCPI_RES_OK;
+}
+
 scpi_result_t scpi_cmd_systemLocal(scpi_t *context) {
     g_rlState = RL_STATE_LOCAL;
 
@@ -795,6 +849,46 @@ scpi_result_t scpi_cmd_systemRemote(scpi_t *context) {
     return SCPI_RES_OK;
 }
 
+scpi_result_t scpi_cmd_systemLockOwnerQ(scpi_t *context) {
+#if OPTION_ETHERNET
+    SCPI_ResultInt(context, ethernet::getLockOwner());
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_systemLockRelease(scpi_t *context) {
+#if OPTION_ETHERNET
+    if (!ethernet::getSessionNumber(context)) {
+        SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
+        return SCPI_RES_ERR;
+    }
+
+    ethernet::releaseLock(context);
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_systemLockRequestQ(scpi_t *context) {
+#if OPTION_ETHERNET
+    if (!ethernet::getSessionNumber(context)) {
+        SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
+        return SCPI_RES_ERR;
+    }
+
+    SCPI_ResultBool(context, ethernet::requestLock(context));
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
 scpi_result_t scpi_cmd_systemRwlock(scpi_t *context) {
     g_rlState = RL_STATE_RW_LOCK;
 
@@ -18,6 +18,7 @@
  
 #include "psu.h"
 #include "serial_psu.h"
+#include "ethernet.h"
 
 #define CONF_CHUNK_SIZE CONF_SERIAL_BUFFER_SIZE
 
@@ -33,7 +34,7 @@ psu::TestResult g_testResult = psu::TEST_FAILED;
 long g_bauds[] = {4800, 9600, 19200, 38400, 57600, 115200};
 size_t g_baudsSize = sizeof(g_bauds) / sizeof(long);
 
-size_t SCPI_Write(scpi_t *context, const char * data, size_t len) {
+size_t serialWrite(scpi_t *context, const char * data, size_t len) {
 	size_t written = 0;
 
 	if (serial::g_testResult == TEST_OK) {
@@ -47,7 +48,12 @@ size_t SCPI_Write(scpi_t *context, const char * data, size_t len) {
 	return written;
 }
 
+size_t SCPI_Write(scpi_t *context, const char * data, size_t len) {
+    return scpi::bufferedWrite(context, data, len, serialWrite);
+}
+
 scpi_result_t SCPI_Flush(scpi_t *context) {
+    scpi::flushOutput();
     return SCPI_RES_OK;
 }
 
@@ -64,6 +70,12 @@ int SCPI_Error(scpi_t *context, int_fast16_t err) {
 }
 
 scpi_result_t SCPI_Control(scpi_t *context, scpi_ctrl_name_t ctrl, scpi_reg_val_t val) {
+    scpi::flushOutput();
+
+    if (SCPI_CTRL_SRQ == ctrl && !((scpi_psu_t *)context->user_context)->notify) {
+        return SCPI_RES_OK;
+    }
+
     if (serial::g_testResult == TEST_OK) {
         char errorOutputBuffer[256];
         if (SCPI_CTRL_SRQ == ctrl) {
@@ -79,6 +91,8 @@ scpi_result_t SCPI_Control(scpi_t *context, scpi_ctrl_name_t ctrl, scpi_reg_val_
 }
 
 scpi_result_t SCPI_Reset(scpi_t *context) {
+    scpi::flushOutput();
+
     if (serial::g_testResult == TEST_OK) {
         char errorOutputBuffer[256];
         strcpy_P(errorOutputBuffer, PSTR("**Reset\r\n"));
@@ -88,6 +102,18 @@ scpi_result_t SCPI_Reset(scpi_t *context) {
     return psu::reset() ? SCPI_RES_OK : SCPI_RES_ERR;
 }
 
+scpi_bool_t SCPI_Check(scpi_t *context) {
+#if OPTION_ETHERNET
+    // serial port can't hold the lock, so it is protected whenever any Ethernet session holds it
+    if (ethernet::getLockOwner() != 0 && scpi::isStateChangingCommand(context)) {
+        SCPI_ErrorPush(context, SCPI_ERROR_COMMAND_PROTECTED);
+        return FALSE;
+    }
+#endif
+
+    return TRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 static scpi_reg_val_t g_scpiPsuRegs[SCPI_PSU_REG_COUNT];
@@ -99,6 +125,7 @@ static scpi_interface_t g_scpiInterface = {
     SCPI_Control,
     SCPI_Flush,
     SCPI_Reset,
+    SCPI_Check,
 };
 
 static char g_scpiInputBuffer[SCPI_PARSER_INPUT_BUFFER_LENGTH];
@@ -221,6 +221,13 @@ bool greaterOrEqual(float a, float b, ValueType valueType, int channelIndex) {
 	return a > b || equal(a, b, valueType, channelIndex);
 }
 
+int64_t greaterOrEqualThresholdMicro(float b, float prec) {
+    double k = roundf(b * prec);
+    double threshold = (k - 0.5) * 1E6 / prec;
+    // roundf rounds halfway cases away from zero
+    return k > 0 ? (int64_t)ceil(threshold) : (int64_t)floor(threshold) + 1;
+}
+
 bool less(float a, float b, float prec) {
     return a < b && !equal(a, b, prec);
 }
@@ -64,6 +64,9 @@ bool greater(float a, float b, float prec);
 bool greater(float a, float b, ValueType valueType, int channelIndex = -1);
 bool greaterOrEqual(float a, float b, float prec);
 bool greaterOrEqual(float a, float b, ValueType valueType, int channelIndex = -1);
+/// Returns the lowest value x, in micro units, for which greaterOrEqual(x * 1E-6, b, prec) is true,
+/// so the comparison can be done in integers when b is not changed.
+int64_t greaterOrEqualThresholdMicro(float b, float prec);
 bool less(float a, float b, float prec);
 bool less(float a, float b, ValueType valueType, int channelIndex = -1);
 bool lessOrEqual(float a, float b, float prec);
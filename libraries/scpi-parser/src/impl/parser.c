@@ -139,8 +139,14 @@ static scpi_bool_t processCommand(scpi_t * context) {
     context->input_count = 0;
     context->arbitrary_reminding = 0;
 
-    /* if callback exists - call command callback */
-    if (cmd->callback != NULL) {
+    /* if command is not allowed, check callback has to push the error */
+    if (context->interface->check != NULL && !context->interface->check(context)) {
+        if (!context->cmd_error) {
+            SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
+        }
+        result = FALSE;
+    } else if (cmd->callback != NULL) {
+        /* if callback exists - call command callback */
         if ((cmd->callback(context) != SCPI_RES_OK)) {
             if (!context->cmd_error) {
                 SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
@@ -162,6 +168,219 @@ static scpi_bool_t processCommand(scpi_t * context) {
     return result;
 }
 
+#if USE_COMMAND_INDEX
+
+#define INDEX_KEY_LENGTH 3
+#define INDEX_MAX_KEYWORDS 16
+#define INDEX_MAX_PATTERN_BUCKETS 32
+
+/* shared by all contexts with the same command list */
+static scpi_command_index_t command_index;
+
+/**
+ * Hash of the first INDEX_KEY_LENGTH letters of the keyword. Short and long form of the keyword
+ * share the same key (if short form is long enough) and numeric suffix is ignored.
+ */
+static uint16_t keywordKey(const char * keyword, size_t len) {
+    uint16_t key = 0;
+    size_t i;
+    for (i = 0; i < len && i < INDEX_KEY_LENGTH; i++) {
+        int c = toupper((unsigned char) keyword[i]);
+        if (!isalpha(c) && c != '*') {
+            break;
+        }
+        key = key * 31 + c;
+    }
+    return key;
+}
+
+static uint16_t bucketOf(uint16_t key1, uint16_t key2) {
+    return (uint16_t) ((key1 * 37u + key2) % SCPI_COMMAND_INDEX_BUCKETS);
+}
+
+/**
+ * Bucket of the command header: the first two keywords, second is 0 if there is only one.
+ */
+static uint16_t commandBucket(const char * header, int len) {
+    uint16_t keys[2] = {0, 0};
+    int i = 0;
+    int k;
+
+    if (len > 0 && header[0] == ':') {
+        i++;
+    }
+
+    for (k = 0; k < 2 && i < len; k++) {
+        int start = i;
+        while (i < len && header[i] != ':' && header[i] != '?') {
+            i++;
+        }
+        keys[k] = keywordKey(header + start, i - start);
+        if (i >= len || header[i] != ':') {
+            break;
+        }
+        i++;
+    }
+
+    return bucketOf(keys[0], keys[1]);
+}
+
+struct pattern_keyword_t {
+    uint16_t keys[2];
+    uint8_t num_keys;
+    scpi_bool_t optional;
+};
+
+struct pattern_buckets_t {
+    uint16_t buckets[INDEX_MAX_PATTERN_BUCKETS];
+    int count;
+    scpi_bool_t overflow;
+};
+
+static void addPatternBucket(struct pattern_buckets_t * result, uint16_t bucket) {
+    int i;
+    for (i = 0; i < result->count; i++) {
+        if (result->buckets[i] == bucket) {
+            return;
+        }
+    }
+    if (result->count < INDEX_MAX_PATTERN_BUCKETS) {
+        result->buckets[result->count++] = bucket;
+    } else {
+        result->overflow = TRUE;
+    }
+}
+
+/**
+ * Enumerate the first two keywords of all the pattern expansions (optional keyword present or not).
+ */
+static void collectPatternBuckets(const struct pattern_keyword_t * keywords, int num_keywords, int pos,
+        uint16_t key1, int num_collected, struct pattern_buckets_t * result) {
+    int i;
+
+    if (pos == num_keywords) {
+        if (num_collected == 1) {
+            addPatternBucket(result, bucketOf(key1, 0));
+        }
+        return;
+    }
+
+    if (keywords[pos].optional) {
+        collectPatternBuckets(keywords, num_keywords, pos + 1, key1, num_collected, result);
+    }
+
+    for (i = 0; i < keywords[pos].num_keys; i++) {
+        if (num_collected == 0) {
+            collectPatternBuckets(keywords, num_keywords, pos + 1, keywords[pos].keys[i], 1, result);
+        } else {
+            addPatternBucket(result, bucketOf(key1, keywords[pos].keys[i]));
+        }
+    }
+}
+
+/**
+ * Find all the buckets the pattern can be matched from.
+ * @return FALSE if pattern is too complex
+ */
+static scpi_bool_t getPatternBuckets(const char * pattern, struct pattern_buckets_t * result) {
+    struct pattern_keyword_t keywords[INDEX_MAX_KEYWORDS];
+    int num_keywords = 0;
+    int brackets = 0;
+    const char * p = pattern;
+
+    while (*p) {
+        if (*p == '[') {
+            brackets++;
+            p++;
+        } else if (*p == ']') {
+            brackets--;
+            p++;
+        } else if (*p == ':' || *p == '?') {
+            p++;
+        } else {
+            const char * start = p;
+            size_t len;
+            size_t short_len;
+            struct pattern_keyword_t * keyword;
+
+            while (*p && !strchr(":?[]", *p)) {
+                p++;
+            }
+
+            if (num_keywords == INDEX_MAX_KEYWORDS) {
+                return FALSE;
+            }
+
+            len = p - start;
+            short_len = 0;
+            while (short_len < len && !islower((unsigned char) start[short_len])) {
+                short_len++;
+            }
+
+            keyword = &keywords[num_keywords++];
+            keyword->optional = brackets > 0;
+            keyword->keys[0] = keywordKey(start, short_len);
+            keyword->keys[1] = keywordKey(start, len);
+            keyword->num_keys = keyword->keys[0] == keyword->keys[1] ? 1 : 2;
+        }
+    }
+
+    result->count = 0;
+    result->overflow = FALSE;
+    collectPatternBuckets(keywords, num_keywords, 0, 0, 0, result);
+
+    return !result->overflow;
+}
+
+/**
+ * Build command index: commands are sorted by bucket, within the bucket commands
+ * are kept in the command list order, so the first matching command is the same as
+ * with the linear search.
+ * @return FALSE if index can't be built
+ */
+static scpi_bool_t buildCommandIndex(scpi_command_index_t * index, const scpi_command_t * commands) {
+    struct pattern_buckets_t pattern_buckets;
+    uint16_t count[SCPI_COMMAND_INDEX_BUCKETS];
+    uint32_t total = 0;
+    int32_t i;
+    int j;
+
+    index->cmdlist = NULL;
+    memset(count, 0, sizeof(count));
+
+    for (i = 0; commands[i].pattern != NULL; i++) {
+        if (!getPatternBuckets(commands[i].pattern, &pattern_buckets)) {
+            return FALSE;
+        }
+        for (j = 0; j < pattern_buckets.count; j++) {
+            count[pattern_buckets.buckets[j]]++;
+        }
+        total += pattern_buckets.count;
+    }
+
+    if (total > SCPI_COMMAND_INDEX_MAX_ENTRIES || i > 0xFFFF) {
+        return FALSE;
+    }
+
+    index->bucket_start[0] = 0;
+    for (j = 0; j < SCPI_COMMAND_INDEX_BUCKETS; j++) {
+        index->bucket_start[j + 1] = index->bucket_start[j] + count[j];
+        count[j] = index->bucket_start[j];
+    }
+
+    for (i = 0; commands[i].pattern != NULL; i++) {
+        getPatternBuckets(commands[i].pattern, &pattern_buckets);
+        for (j = 0; j < pattern_buckets.count; j++) {
+            index->entries[count[pattern_buckets.buckets[j]]++] = (uint16_t) i;
+        }
+    }
+
+    index->cmdlist = commands;
+    return TRUE;
+}
+
+#endif /* USE_COMMAND_INDEX */
+
 /**
  * Cycle all patterns and search matching pattern. Execute command callback.
  * @param context
@@ -211,6 +430,21 @@ static scpi_bool_t findCommandHeader(scpi_t * context, const char * header, int
 #else
     const scpi_command_t * cmd;
 
+#if USE_COMMAND_INDEX
+    const scpi_command_index_t * index = context->cmd_index;
+    if (index != NULL && index->cmdlist == context->cmdlist) {
+        uint16_t bucket = commandBucket(header, len);
+        for (i = index->bucket_start[bucket]; i < index->bucket_start[bucket + 1]; i++) {
+            cmd = &context->cmdlist[index->entries[i]];
+            if (matchCommand(cmd->pattern, header, len, NULL, 0, 0)) {
+                context->param_list.cmd = cmd;
+                return TRUE;
+            }
+        }
+        return FALSE;
+    }
+#endif
+
     for (i = 0; context->cmdlist[i].pattern != NULL; i++) {
         cmd = &context->cmdlist[i];
         if (matchCommand(cmd->pattern, header, len, NULL, 0, 0)) {
@@ -312,6 +546,13 @@ void SCPI_Init(scpi_t * context,
     context->buffer.position = 0;
     SCPI_ErrorInit(context, error_queue_data, error_queue_size);
 
+#if USE_COMMAND_INDEX
+    if (command_index.cmdlist != commands) {
+        buildCommandIndex(&command_index, commands);
+    }
+    context->cmd_index = command_index.cmdlist == commands ? &command_index : NULL;
+#endif
+
 #if USE_64K_PROGMEM_FOR_CMD_LIST || USE_FULL_PROGMEM_FOR_CMD_LIST 
     context->param_list.cmd_s.pattern = context->param_list.cmd_pattern_s;
     context->param_list.cmd = &context->param_list.cmd_s;
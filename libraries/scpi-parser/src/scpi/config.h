@@ -104,6 +104,29 @@ extern "C" {
 #define USE_FULL_PROGMEM_FOR_CMD_LIST 0
 #endif
 
+/**
+ * Build command lookup index at SCPI_Init
+ * 0 = Search all commands on every command header
+ * 1 = Search only commands with the same first two keywords (hashed)
+ */
+#ifndef USE_COMMAND_INDEX
+#if USE_64K_PROGMEM_FOR_CMD_LIST || USE_FULL_PROGMEM_FOR_CMD_LIST
+#define USE_COMMAND_INDEX 0
+#else
+#define USE_COMMAND_INDEX 1
+#endif
+#endif
+
+/* Number of buckets in the command index */
+#ifndef SCPI_COMMAND_INDEX_BUCKETS
+#define SCPI_COMMAND_INDEX_BUCKETS 256
+#endif
+
+/* Max. number of (bucket, command) entries in the command index, index is not used if exceeded */
+#ifndef SCPI_COMMAND_INDEX_MAX_ENTRIES
+#define SCPI_COMMAND_INDEX_MAX_ENTRIES 1024
+#endif
+
 #ifndef USE_64K_PROGMEM_FOR_ERROR_MESSAGES
 #define USE_64K_PROGMEM_FOR_ERROR_MESSAGES 0
 #endif
@@ -39,6 +39,10 @@ extern "C" {
 
 #define USE_COMMAND_TAGS 0
 
+// Command index takes 2 bytes of RAM per entry, PSU command list needs 470 entries.
+// If the list grows over this limit, parser falls back to the linear search.
+#define SCPI_COMMAND_INDEX_MAX_ENTRIES 512
+
 #if defined(__AVR_ATmega1280__) || defined(__AVR_ATmega2560__)
 #define USE_64K_PROGMEM_FOR_CMD_LIST 1
 #define USE_FULL_PROGMEM_FOR_CMD_LIST 0
@@ -52,6 +56,7 @@ extern "C" {
 #define LIST_OF_USER_ERRORS \
     X(SCPI_ERROR_HEADER_SUFFIX_OUTOFRANGE,                  -114, "Header suffix out of range")                   \
     X(SCPI_ERROR_CHARACTER_DATA_TOO_LONG,                   -144, "Character data too long")                      \
+    X(SCPI_ERROR_COMMAND_PROTECTED,                         -203, "Command protected")                            \
     X(SCPI_ERROR_TRIGGER_IGNORED,                           -211, "Trigger ignored")                              \
     X(SCPI_ERROR_DATA_OUT_OF_RANGE,                         -222, "Data out of range")                            \
     X(SCPI_ERROR_TOO_MUCH_DATA,                             -223, "Too much data")                                \
@@ -204,6 +204,8 @@ extern "C" {
     typedef struct _scpi_parser_state_t scpi_parser_state_t;
 
     typedef scpi_result_t(*scpi_command_callback_t)(scpi_t *);
+    /* called before command callback, command is not executed if it returns FALSE */
+    typedef scpi_bool_t(*scpi_command_check_t)(scpi_t *);
 
     struct _scpi_fifo_t {
         int16_t wr;
@@ -310,6 +312,16 @@ extern "C" {
 #endif /* USE_COMMAND_TAGS */
     };
 
+#if USE_COMMAND_INDEX
+    /* commands of the bucket are entries[bucket_start[bucket]] .. entries[bucket_start[bucket + 1] - 1] */
+    struct _scpi_command_index_t {
+        const scpi_command_t * cmdlist;
+        uint16_t bucket_start[SCPI_COMMAND_INDEX_BUCKETS + 1];
+        uint16_t entries[SCPI_COMMAND_INDEX_MAX_ENTRIES];
+    };
+    typedef struct _scpi_command_index_t scpi_command_index_t;
+#endif /* USE_COMMAND_INDEX */
+
     struct _scpi_param_list_t {
         const scpi_command_t * cmd;
         lex_state_t lex_state;
@@ -347,6 +359,7 @@ extern "C" {
         scpi_write_control_t control;
         scpi_command_callback_t flush;
         scpi_command_callback_t reset;
+        scpi_command_check_t check;
     };
 
     struct _scpi_t {
@@ -355,6 +368,9 @@ extern "C" {
         uint_farptr_t cmdpatterns;
 #else        
         const scpi_command_t * cmdlist;
+#endif
+#if USE_COMMAND_INDEX
+        const scpi_command_index_t * cmd_index;
 #endif
         scpi_buffer_t buffer;
         scpi_param_list_t param_list;
@@ -31,7 +31,7 @@ namespace psu {
 namespace ethernet_platform {
 
 static int listen_socket = -1;
-static int client_socket = -1;
+static int client_sockets[MAX_CLIENTS];
 
 bool enable_non_blocking(int fd) {
     int flags = fcntl(fd, F_GETFL, 0);
@@ -46,6 +46,10 @@ bool enable_non_blocking(int fd) {
 }
 
 bool bind(int port) {
+    for (int i = 0; i < MAX_CLIENTS; ++i) {
+        client_sockets[i] = -1;
+    }
+
     sockaddr_in serv_addr;
     listen_socket = socket(AF_INET, SOCK_STREAM, 0);
     if (listen_socket < 0) {
@@ -81,46 +85,56 @@ bool bind(int port) {
     return true;
 }
 
-bool client_available() {
-    if (connected()) return true;
-
+int accept_client() {
     if (listen_socket == -1) {
-        return 0;
+        return -1;
+    }
+
+    int client = -1;
+    for (int i = 0; i < MAX_CLIENTS; ++i) {
+        if (client_sockets[i] == -1) {
+            client = i;
+            break;
+        }
+    }
+    if (client == -1) {
+        // keep the connection pending until some client disconnects
+        return -1;
     }
 
     sockaddr_in cli_addr;
     socklen_t clilen = sizeof(cli_addr);
-    client_socket = accept(listen_socket, (sockaddr *)&cli_addr, &clilen);
+    int client_socket = accept(listen_socket, (sockaddr *)&cli_addr, &clilen);
     if (client_socket < 0) {
         if (errno == EWOULDBLOCK) {
-            return false;
+            return -1;
         }
 
         DebugTraceF("EHTERNET: accept failed with error %d", errno);
         close(listen_socket);
         listen_socket = -1;
-        return false;
+        return -1;
     }
 
     if (!enable_non_blocking(client_socket)) {
         DebugTraceF("EHTERNET: ioctl on client socket failed with error %d", errno);
         close(client_socket);
-        listen_socket = -1;
-        return false;
+        return -1;
     }
 
-    return true;
+    client_sockets[client] = client_socket;
+    return client;
 }
 
-bool connected() {
-    return client_socket != -1;
+bool connected(int client) {
+    return client_sockets[client] != -1;
 }
 
-int available() {
-    if (client_socket == -1) return 0;
+int available(int client) {
+    if (client_sockets[client] == -1) return 0;
 
     char buffer[SCPI_PARSER_INPUT_BUFFER_LENGTH / 2];
-    int iResult = ::recv(client_socket, buffer, SCPI_PARSER_INPUT_BUFFER_LENGTH / 2, MSG_PEEK);
+    int iResult = ::recv(client_sockets[client], buffer, SCPI_PARSER_INPUT_BUFFER_LENGTH / 2, MSG_PEEK);
     if (iResult > 0) {
         return iResult;
     }
@@ -129,13 +143,15 @@ int available() {
         return 0;
     }
 
-    stop();
+    stop(client);
 
     return 0;
 }
 
-int read(char *buffer, int buffer_size) {
-    int n = ::read(client_socket, buffer, buffer_size);
+int read(int client, char *buffer, int buffer_size) {
+    if (client_sockets[client] == -1) return 0;
+
+    int n = ::read(client_sockets[client], buffer, buffer_size);
     if (n > 0) {
         return n;
     }
@@ -144,17 +160,17 @@ int read(char *buffer, int buffer_size) {
         return 0;
     }
 
-    stop();
+    stop(client);
 
     return 0;
 }
 
-int write(const char *buffer, int buffer_size) {
-    if (client_socket != -1) {
-        int n = ::write(client_socket, buffer, buffer_size);
+int write(int client, const char *buffer, int buffer_size) {
+    if (client_sockets[client] != -1) {
+        int n = ::send(client_sockets[client], buffer, buffer_size, MSG_NOSIGNAL);
         if (n < 0) {
-            close(client_socket);
-            client_socket = -1;
+            close(client_sockets[client]);
+            client_sockets[client] = -1;
             return 0;
         }
         return n;
@@ -163,13 +179,15 @@ int write(const char *buffer, int buffer_size) {
     return 0;
 }
 
-void stop() {    
-    int result = shutdown(client_socket, SHUT_WR);
+void stop(int client) {
+    if (client_sockets[client] == -1) return;
+
+    int result = shutdown(client_sockets[client], SHUT_WR);
     if (result < 0) {
         DebugTraceF("ETHERNET shutdown failed with error %d\n", errno);
     }
-    close(client_socket);
-    client_socket = -1;
+    close(client_sockets[client]);
+    client_sockets[client] = -1;
 }
 
 }
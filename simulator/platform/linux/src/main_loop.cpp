@@ -46,6 +46,8 @@ void *input_thread(void *) {
 
 int main_loop() {
     timespec timeout = { 0, TICK_TIMEOUT * 1000 * 1000 };
+    // in virtual time mode ticks are executed without waiting
+    timespec virtualTimeTimeout = { 0, 0 };
 
     if (thread_queue_init(&queue) != 0) return -1;
 
@@ -56,7 +58,8 @@ int main_loop() {
         threadmsg msg;
         char *p_ch;
         int ret;
-        switch (ret = thread_queue_get(&queue, &timeout, &msg)) {
+        bool isVirtualTime = simulator::getTimeMode() == simulator::TIME_MODE_VIRTUAL;
+        switch (ret = thread_queue_get(&queue, isVirtualTime ? &virtualTimeTimeout : &timeout, &msg)) {
         case 0:
             switch (msg.msgtype) {
             case NEW_INPUT_MESSAGE:
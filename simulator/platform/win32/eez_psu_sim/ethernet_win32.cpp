@@ -38,9 +38,13 @@ namespace psu {
 namespace ethernet_platform {
 
 static SOCKET listen_socket = INVALID_SOCKET;
-static SOCKET client_socket = INVALID_SOCKET;
+static SOCKET client_sockets[MAX_CLIENTS];
 
 bool bind(int port) {
+    for (int i = 0; i < MAX_CLIENTS; ++i) {
+        client_sockets[i] = INVALID_SOCKET;
+    }
+
     WSADATA wsaData;
     int iResult;
 
@@ -110,38 +114,49 @@ bool bind(int port) {
     return true;
 }
 
-bool client_available() {
-    if (connected()) return true;
-
+int accept_client() {
     if (listen_socket == INVALID_SOCKET) {
-        return false;
+        return -1;
+    }
+
+    int client = -1;
+    for (int i = 0; i < MAX_CLIENTS; ++i) {
+        if (client_sockets[i] == INVALID_SOCKET) {
+            client = i;
+            break;
+        }
+    }
+    if (client == -1) {
+        // keep the connection pending until some client disconnects
+        return -1;
     }
 
     // Accept a client socket
-    client_socket = accept(listen_socket, NULL, NULL);
+    SOCKET client_socket = accept(listen_socket, NULL, NULL);
     if (client_socket == INVALID_SOCKET) {
         if (WSAGetLastError() == WSAEWOULDBLOCK) {
-            return false;
+            return -1;
         }
 
         DebugTraceF("EHTERNET accept failed with error %d\n", WSAGetLastError());
         closesocket(listen_socket);
         listen_socket = INVALID_SOCKET;
-        return false;
+        return -1;
     }
 
-    return true;
+    client_sockets[client] = client_socket;
+    return client;
 }
 
-bool connected() {
-    return client_socket != INVALID_SOCKET;
+bool connected(int client) {
+    return client_sockets[client] != INVALID_SOCKET;
 }
 
-int available() {
-    if (client_socket == INVALID_SOCKET) return 0;
+int available(int client) {
+    if (client_sockets[client] == INVALID_SOCKET) return 0;
 
     char buffer[SCPI_PARSER_INPUT_BUFFER_LENGTH / 2];
-    int iResult = ::recv(client_socket, buffer, SCPI_PARSER_INPUT_BUFFER_LENGTH / 2, MSG_PEEK);
+    int iResult = ::recv(client_sockets[client], buffer, SCPI_PARSER_INPUT_BUFFER_LENGTH / 2, MSG_PEEK);
     if (iResult > 0) {
         return iResult;
     }
@@ -150,13 +165,15 @@ int available() {
         return 0;
     }
 
-    stop();
+    stop(client);
 
     return 0;
 }
 
-int read(char *buffer, int buffer_size) {
-    int iResult = ::recv(client_socket, buffer, buffer_size, 0);
+int read(int client, char *buffer, int buffer_size) {
+    if (client_sockets[client] == INVALID_SOCKET) return 0;
+
+    int iResult = ::recv(client_sockets[client], buffer, buffer_size, 0);
     if (iResult > 0) {
         return iResult;
     }
@@ -165,21 +182,20 @@ int read(char *buffer, int buffer_size) {
         return 0;
     }
 
-    stop();
+    stop(client);
 
     return 0;
 }
 
-int write(const char *buffer, int buffer_size) {
+int write(int client, const char *buffer, int buffer_size) {
     int iSendResult;
 
-    if (client_socket != INVALID_SOCKET) {
-        // Echo the buffer back to the sender
-        iSendResult = ::send(client_socket, buffer, buffer_size, 0);
+    if (client_sockets[client] != INVALID_SOCKET) {
+        iSendResult = ::send(client_sockets[client], buffer, buffer_size, 0);
         if (iSendResult == SOCKET_ERROR) {
             DebugTraceF("send failed with error: %d\n", WSAGetLastError());
-            closesocket(client_socket);
-            client_socket = INVALID_SOCKET;
+            closesocket(client_sockets[client]);
+            client_sockets[client] = INVALID_SOCKET;
             return 0;
         }
         return iSendResult;
@@ -188,14 +204,14 @@ int write(const char *buffer, int buffer_size) {
     return 0;
 }
 
-void stop() {
-    if (client_socket != INVALID_SOCKET) {
-        int iResult = shutdown(client_socket, SD_SEND);
+void stop(int client) {
+    if (client_sockets[client] != INVALID_SOCKET) {
+        int iResult = shutdown(client_sockets[client], SD_SEND);
         if (iResult == SOCKET_ERROR) {
             DebugTraceF("EHTERNET shutdown failed with error %d\n", WSAGetLastError());
         }
-        closesocket(client_socket);
-        client_socket = INVALID_SOCKET;
+        closesocket(client_sockets[client]);
+        client_sockets[client] = INVALID_SOCKET;
     }
 }
 
@@ -162,7 +162,14 @@ void FileImpl::init() {
 
 void FileImpl::open() {
     if (m_mode == FILE_WRITE) {
-        m_fp = fopen(getRealPath().c_str(), "ab");
+        // same as SdFat: open for read and write, create if doesn't exist and position at the end
+        m_fp = fopen(getRealPath().c_str(), "r+b");
+        if (!m_fp) {
+            m_fp = fopen(getRealPath().c_str(), "w+b");
+        }
+        if (m_fp) {
+            fseek(m_fp, 0, SEEK_END);
+        }
     } else {
         m_fp = fopen(getRealPath().c_str(), "rb");
     }
@@ -348,11 +355,21 @@ bool FileImpl::seek(uint32_t pos) {
 }
 
 bool FileImpl::truncate(uint32_t length) {
+    fflush(m_fp);
 #ifdef _WIN32
-    return _chsize(_fileno(m_fp), length) == 0;
+    if (_chsize(_fileno(m_fp), length) != 0) {
+        return false;
+    }
 #else
-    return ftruncate(fileno(m_fp), length) == 0;
+    if (ftruncate(fileno(m_fp), length) != 0) {
+        return false;
+    }
 #endif
+    // same as SdFat: if current position is beyond the new end, set it to the new end
+    if ((uint32_t)ftell(m_fp) > length) {
+        fseek(m_fp, length, SEEK_SET);
+    }
+    return true;
 }
 
 bool FileImpl::available() {
@@ -189,53 +189,12 @@ void tone(uint8_t _pin, unsigned int frequency, unsigned long duration) {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-#ifdef _WIN32
-#undef INPUT
-#undef OUTPUT
-#include <Windows.h>
-#else
-#include <sys/time.h>
-#include <time.h>
-#endif
-
 uint32_t millis() {
-#ifdef _WIN32
-    return GetTickCount();
-#else
-    timeval tv;
-    gettimeofday(&tv, NULL);
-    uint64_t micros = tv.tv_sec*(uint64_t)1000000 + tv.tv_usec;
-    return (uint32_t)(micros / 1000);
-#endif
+    return (uint32_t)(getTime() / 1000);
 }
 
 uint32_t micros() {
-#ifdef _WIN32
-    static bool firstTime = true;
-    static unsigned __int64 frequency;
-    static unsigned __int64 startTime;
-
-    if (firstTime) {
-        firstTime = false;
-        QueryPerformanceFrequency((LARGE_INTEGER*)&frequency);
-        QueryPerformanceCounter((LARGE_INTEGER *)&startTime);
-
-        return 0;
-    } else {
-        unsigned __int64 time;
-        QueryPerformanceCounter((LARGE_INTEGER *)&time);
-
-        unsigned __int64 diff = (time - startTime) * 1000000L / frequency;
-
-        return (uint32_t)(diff % 4294967296);
-    }
-
-#else
-    timeval tv;
-    gettimeofday(&tv, NULL);
-    uint64_t micros = tv.tv_sec*(uint64_t)1000000 + tv.tv_usec;
-    return (uint32_t)(micros % 4294967296);
-#endif
+    return (uint32_t)(getTime() % 4294967296);
 }
 
 void delay(uint32_t millis) {
@@ -243,14 +202,7 @@ void delay(uint32_t millis) {
 } 
 
 void delayMicroseconds(uint32_t microseconds) {
-#ifdef _WIN32
-    Sleep(microseconds / 1000);
-#else
-    timespec ts;
-    ts.tv_sec = microseconds / 1000000;
-    ts.tv_nsec = (microseconds % 1000000) * 1000;
-    nanosleep(&ts, 0);
-#endif
+    sleepMicroseconds(microseconds);
 }
 
 }
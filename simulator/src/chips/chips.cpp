@@ -167,6 +167,11 @@ void tick() {
     adc_chip2.tick();
 }
 
+bool useVolatileState(const char *eepromImageFilePath) {
+    rtc_chip.useVolatileState();
+    return eeprom_chip.useVolatileImage(eepromImageFilePath);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 EepromChip::EepromChip()
@@ -183,6 +188,28 @@ EepromChip::~EepromChip() {
     if (fp != NULL) fclose(fp);
 }
 
+bool EepromChip::useVolatileImage(const char *imageFilePath) {
+    if (fp != NULL) fclose(fp);
+
+    fp = tmpfile();
+    if (fp == NULL) return false;
+
+    if (imageFilePath) {
+        FILE *image_fp = fopen(imageFilePath, "rb");
+        if (image_fp == NULL) return false;
+
+        uint8_t buffer[1024];
+        size_t n;
+        while ((n = fread(buffer, 1, sizeof(buffer), image_fp)) > 0) {
+            fwrite(buffer, 1, n, fp);
+        }
+        fclose(image_fp);
+        fflush(fp);
+    }
+
+    return true;
+}
+
 void EepromChip::select() {
     state = IDLE;
 }
@@ -273,6 +300,14 @@ RtcChip::~RtcChip() {
     if (fp != NULL) fclose(fp);
 }
 
+void RtcChip::useVolatileState() {
+    if (fp != NULL) {
+        fclose(fp);
+        fp = NULL;
+    }
+    offset = 0;
+}
+
 void RtcChip::select() {
     state = IDLE;
 }
@@ -373,7 +408,7 @@ uint8_t RtcChip::transfer(uint8_t data) {
 }
 
 uint32_t RtcChip::nowUtc() {
-    time_t now_time_t = time(0);
+    time_t now_time_t = getUtcTime();
     struct tm *now_tm = gmtime(&now_time_t);
     return datetime::makeTime(1900 + now_tm->tm_year, now_tm->tm_mon + 1, now_tm->tm_mday, now_tm->tm_hour, now_tm->tm_min, now_tm->tm_sec);
 }
@@ -612,7 +647,11 @@ AnalogDigitalConverterChip::AnalogDigitalConverterChip(IOExpanderChip &ioexp_chi
     , state(IDLE)
     , tick_counter(0)
     , start(false)
+    , running(false)
+    , conversion_start_time(0)
 {
+    // DRDY is active low
+    arduino::pins[convend_pin] = HIGH;
 }
 
 void AnalogDigitalConverterChip::select() {
@@ -624,12 +663,19 @@ uint8_t AnalogDigitalConverterChip::transfer(uint8_t data) {
 
     if (state == IDLE) {
         if (data == AnalogDigitalConverter::ADC_RESET) {
+            start = false;
+            running = false;
+            arduino::pins[convend_pin] = HIGH;
+        }
+        else if (data == AnalogDigitalConverter::ADC_POWERDOWN) {
+            start = false;
+            running = false;
         }
         else if (data == AnalogDigitalConverter::ADC_RD3S1) {
             register_index = 1;
             state = READ_REG;
         }
-        else if (data == AnalogDigitalConverter::ADC_WR3S1) {
+        else if (data == AnalogDigitalConverter::ADC_WR3S1 || data == AnalogDigitalConverter::ADC_WR1S1) {
             register_index = 1;
             state = WRITE_REG;
         }
@@ -641,6 +687,8 @@ uint8_t AnalogDigitalConverterChip::transfer(uint8_t data) {
         }
         else if (data == AnalogDigitalConverter::ADC_START) {
             start = true;
+            conversion_start_time = micros();
+            running = isContinuousConversionMode();
             tick();
         }
     }
@@ -653,6 +701,11 @@ uint8_t AnalogDigitalConverterChip::transfer(uint8_t data) {
     else if (state == WR1S0) {
         register_values[0] = data;
         state = IDLE;
+        if (running) {
+            // in continuous conversion mode, register write restarts conversion
+            start = true;
+            tick();
+        }
     }
     else if (state == RDATA_MSB) {
         result = getValue() >> 8;
@@ -660,6 +713,8 @@ uint8_t AnalogDigitalConverterChip::transfer(uint8_t data) {
     }
     else if (state == RDATA_LSB) {
         result = getValue() & 0xFF;
+        // data is read, deassert DRDY
+        arduino::pins[convend_pin] = HIGH;
     }
 
     return result;
@@ -669,11 +724,16 @@ void AnalogDigitalConverterChip::tick() {
     if (tick_counter < 4) {
         ++tick_counter;
 
-        if (start) {
+        // in continuous conversion mode, new data is ready as soon as the previous is read
+        if ((start || running && arduino::pins[convend_pin] == HIGH) && isConversionFinished()) {
             start = false;
 
-            //static const int CODE_TO_SPS [] = { 20, 45, 90, 175, 330, 600, 1000 };
-            //psu::delayMicroseconds(1000000 / CODE_TO_SPS[ADC_SPS]);
+            // in continuous conversion mode next conversion starts now
+            conversion_start_time = micros();
+
+            // conversion is finished, assert DRDY, so firmware can either
+            // poll it or get the interrupt, exactly as with the real chip
+            arduino::pins[convend_pin] = LOW;
 
             InterruptCallback callback = interrupt_callbacks[convend_pin];
             if (callback) {
@@ -685,6 +745,22 @@ void AnalogDigitalConverterChip::tick() {
     }
 }
 
+bool AnalogDigitalConverterChip::isConversionFinished() {
+    // in real time mode conversion is finished immediately, because
+    // the main loop tick is usually longer than the conversion time
+    if (getTimeMode() != TIME_MODE_VIRTUAL) {
+        return true;
+    }
+
+    uint8_t data_rate = register_values[1] >> 5;
+    uint32_t conversion_time = 1000000UL / AnalogDigitalConverter::getDataRateSps(data_rate);
+    return micros() - conversion_start_time >= conversion_time;
+}
+
+bool AnalogDigitalConverterChip::isContinuousConversionMode() {
+    return (register_values[1] & 0B00000100) != 0;
+}
+
 uint16_t AnalogDigitalConverterChip::getValue() {
     updateValues();
 
@@ -726,8 +802,8 @@ void AnalogDigitalConverterChip::updateValues() {
         Channel &channel = Channel::get(i);
         if (channel.convend_pin == convend_pin) {
             if (channel.simulator.getLoadEnabled()) {
-                float u_set_v = channel.isRemoteProgrammingEnabled() ? util::remap(channel.simulator.voltProgExt, 0, 0, 2.5, channel.u.max) : channel.remapAdcDataToVoltage(u_set);
-                float i_set_a = channel.remapAdcDataToCurrent(i_set);
+                float u_set_v = channel.isRemoteProgrammingEnabled() ? util::remap(channel.simulator.voltProgExt, 0, 0, 2.5, channel.u.max) : channel.simulatorAdcDataToVoltage(u_set);
+                float i_set_a = channel.simulatorAdcDataToCurrent(i_set);
 
                 float u_mon_v = i_set_a * channel.simulator.load;
                 float i_mon_a = i_set_a;
@@ -49,6 +49,10 @@ uint8_t transfer(uint8_t data);
 /// For the case if some of the chips need to do something in the background.
 void tick();
 
+/// EEPROM and RTC state is kept in memory instead of the state files, see simulator::useVolatileState.
+/// \returns false if EEPROM image file can't be read.
+bool useVolatileState(const char *eepromImageFilePath);
+
 ////////////////////////////////////////////////////////////////////////////////
 
 /// Abstract base class for all the chips.
@@ -80,6 +84,9 @@ public:
     void select();
     uint8_t transfer(uint8_t data);
 
+    /// Replace the state file with the temporary file, initialized from the image file if given.
+    bool useVolatileImage(const char *imageFilePath);
+
 private:
     FILE *fp;
 
@@ -127,6 +134,9 @@ public:
     void select();
     uint8_t transfer(uint8_t data);
 
+    /// Start with zero offset, which is not saved to the state file.
+    void useVolatileState();
+
 private:
     FILE *fp;
 
@@ -257,7 +267,12 @@ private:
     uint16_t i_set;
     int tick_counter;
     bool start;
+    bool running;
+    uint32_t conversion_start_time;
 
+    /// In virtual time mode, conversion takes 1/SPS of the selected data rate.
+    bool isConversionFinished();
+    bool isContinuousConversionMode();
     uint16_t getValue();
     void setDacValue(uint8_t data_buffer, uint16_t value);
     void updateValues();
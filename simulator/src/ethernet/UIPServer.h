@@ -36,7 +36,7 @@ public:
 private:
     bool bind_result;
     int port;
-    EthernetClient client;
+    int next_client;
 };
 
 }
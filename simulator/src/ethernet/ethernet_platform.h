@@ -22,16 +22,20 @@ namespace eez {
 namespace psu {
 namespace ethernet_platform {
 
+/// Max. number of simultaneously connected clients.
+static const int MAX_CLIENTS = 8;
+
 bool bind(int port);
-bool client_available();
+/// Accepts pending connection, returns client index or -1 if there is no pending connection.
+int accept_client();
 
-bool connected();
+bool connected(int client);
 
-int available();
-int read(char *buffer, int buffer_size);
-int write(const char *buffer, int buffer_size);
+int available(int client);
+int read(int client, char *buffer, int buffer_size);
+int write(int client, const char *buffer, int buffer_size);
 
-void stop();
+void stop(int client);
 
 }
 }
@@ -63,51 +63,68 @@ IPAddress SimulatorEthernet::dnsServerIP() {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-EthernetServer::EthernetServer(int port_) : port(port_), client(true) {
+EthernetServer::EthernetServer(int port_) : port(port_), next_client(0) {
 }
 
 void EthernetServer::begin() {
     bind_result = ethernet_platform::bind(port);
 }
 
+/// Returns newly connected client or, as the Arduino library, connected client with available data.
 EthernetClient EthernetServer::available() {
     if (!bind_result) return EthernetClient();
-    return client;
+
+    int client = ethernet_platform::accept_client();
+    if (client != -1) {
+        return EthernetClient(client);
+    }
+
+    for (int i = 0; i < ethernet_platform::MAX_CLIENTS; ++i) {
+        client = (next_client + i) % ethernet_platform::MAX_CLIENTS;
+        if (ethernet_platform::connected(client) && ethernet_platform::available(client) > 0) {
+            next_client = (client + 1) % ethernet_platform::MAX_CLIENTS;
+            return EthernetClient(client);
+        }
+    }
+
+    return EthernetClient();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-EthernetClient::EthernetClient() : valid(false) {
+EthernetClient::EthernetClient() : client(-1) {
 }
 
-EthernetClient::EthernetClient(bool valid_) : valid(valid_) {
+EthernetClient::EthernetClient(int client_) : client(client_) {
 }
 
 bool EthernetClient::connected() {
-    return ethernet_platform::connected();
+    return client != -1 && ethernet_platform::connected(client);
 }
 
 EthernetClient::operator bool() {
-    return valid && ethernet_platform::client_available();
+    return connected();
 }
 
 size_t EthernetClient::available() {
-    return ethernet_platform::available();
+    return client != -1 ? ethernet_platform::available(client) : 0;
 }
 
 size_t EthernetClient::read(uint8_t* buffer, size_t buffer_size) {
-    return ethernet_platform::read((char *)buffer, (int)buffer_size);
+    return client != -1 ? ethernet_platform::read(client, (char *)buffer, (int)buffer_size) : 0;
 }
 
 size_t EthernetClient::write(const char *buffer, size_t buffer_size) {
-    return ethernet_platform::write(buffer, (int)buffer_size);
+    return client != -1 ? ethernet_platform::write(client, buffer, (int)buffer_size) : 0;
 }
 
 void EthernetClient::flush() {
 }
 
 void EthernetClient::stop() {
-    ethernet_platform::stop();
+    if (client != -1) {
+        ethernet_platform::stop(client);
+    }
 }
 
 }
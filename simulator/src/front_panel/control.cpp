@@ -55,6 +55,7 @@ static eez_dll_lib_t g_lib = 0;
 static create_window_ptr_t g_create_window_ptr = 0;
 static get_desktop_resolution_ptr_t g_get_desktop_resolution_ptr = 0;
 static Window* g_window;
+static bool g_headless;
 static Data g_data;
 
 static beep_ptr_t g_beep_ptr = 0;
@@ -80,7 +81,7 @@ void load_lib() {
 #if OPTION_DISPLAY
 
 bool isOpened() {
-    return g_window ? true : false;
+    return g_window || g_headless;
 }
 
 bool open() {
@@ -151,6 +152,10 @@ void tick() {
 #endif
 }
 
+void setHeadless(bool headless) {
+    g_headless = headless;
+}
+
 void beep(double freq, int duration) {
     load_lib();
     if (g_beep_ptr) {
@@ -29,6 +29,9 @@ bool open();
 void close();
 void tick();
 
+/// GUI is rendered into the simulated display buffer, but without the window (used by the benchmark).
+void setHeadless(bool headless);
+
 void beep(double freq, int duration);
 
 }
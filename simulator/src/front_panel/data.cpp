@@ -118,17 +118,33 @@ void fillChannelData(ChannelData *data, int ch) {
 }
 
 void fillLocalControlBuffer(Data *data) {
-    if (!data->local_control_widget.pixels) {
-        data->local_control_widget.pixels_w = gui::lcd::lcd.getDisplayWidth();
-        data->local_control_widget.pixels_h = gui::lcd::lcd.getDisplayHeight();
-        data->local_control_widget.pixels = new unsigned char[data->local_control_widget.pixels_w * data->local_control_widget.pixels_h * 4];
+    imgui::UserWidget &widget = data->local_control_widget;
+
+    if (!widget.pixels) {
+        widget.pixels_w = gui::lcd::lcd.getDisplayWidth();
+        widget.pixels_h = gui::lcd::lcd.getDisplayHeight();
+        widget.pixels = new unsigned char[widget.pixels_w * widget.pixels_h * 4];
+    }
+
+    // convert only the area changed since the previous frame
+    int x1, y1, x2, y2;
+    if (!gui::lcd::lcd.getDirtyRect(x1, y1, x2, y2)) {
+        widget.dirty_w = 0;
+        widget.dirty_h = 0;
+        return;
     }
+    gui::lcd::lcd.clearDirtyRect();
+
+    widget.dirty_x = x1;
+    widget.dirty_y = y1;
+    widget.dirty_w = x2 - x1 + 1;
+    widget.dirty_h = y2 - y1 + 1;
 
-    uint16_t *src = gui::lcd::lcd.buffer;
-    unsigned char *dst = data->local_control_widget.pixels;
+    for (int y = y1; y <= y2; ++y) {
+        uint16_t *src = gui::lcd::lcd.buffer + y * widget.pixels_w + x1;
+        unsigned char *dst = widget.pixels + (y * widget.pixels_w + x1) * 4;
 
-    for (int x = 0; x < data->local_control_widget.pixels_w; ++x) {
-        for (int y = 0; y < data->local_control_widget.pixels_h; ++y) {
+        for (int x = x1; x <= x2; ++x) {
             uint16_t color = *src++; // rrrrrggggggbbbbb
 
             *dst++ = (unsigned char)((color << 3) & 0xFF);        // blue
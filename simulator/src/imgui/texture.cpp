@@ -189,6 +189,33 @@ int Texture::getHeight() {
     return mHeight;
 }
 
+bool Texture::createStreaming(int width, int height, SDL_Renderer *renderer) {
+    //Get rid of preexisting texture
+    free();
+
+    mTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, width, height);
+    if (mTexture == NULL) {
+        printf("Unable to create streaming texture! SDL Error: %s\n", SDL_GetError());
+    }
+    else {
+        mWidth = width;
+        mHeight = height;
+    }
+
+    //Return success
+    return mTexture != NULL;
+}
+
+bool Texture::update(unsigned char *image_buffer, int x, int y, int w, int h) {
+    SDL_Rect rect = { x, y, w, h };
+    int pitch = 4 * mWidth;
+    if (SDL_UpdateTexture(mTexture, &rect, image_buffer + y * pitch + 4 * x, pitch) != 0) {
+        printf("Unable to update texture! SDL Error: %s\n", SDL_GetError());
+        return false;
+    }
+    return true;
+}
+
 bool Texture::lockTexture() {
     bool success = true;
 
@@ -47,6 +47,12 @@ public:
     //Creates image from image buffer
     bool loadFromImageBuffer(unsigned char *image_buffer, int width, int height, SDL_Renderer *renderer);
 
+    //Creates streaming texture for the 32-bit image buffer that is updated often
+    bool createStreaming(int width, int height, SDL_Renderer *renderer);
+
+    //Uploads part of the image buffer to the streaming texture
+    bool update(unsigned char *image_buffer, int x, int y, int w, int h);
+
     //Deallocates texture
     void free();
 
@@ -113,6 +113,10 @@ WindowImpl::~WindowImpl() {
         delete it->second;
     }
 
+    for (UserWidgetTextureMap::iterator it = userWidgetTextures.begin(); it != userWidgetTextures.end(); ++it) {
+        delete it->second;
+    }
+
     if (font) {
         TTF_CloseFont(font);
     }
@@ -346,9 +350,32 @@ void WindowImpl::addUserWidget(UserWidget *user_widget) {
     int y = user_widget->y + window_definition->content_padding;
 
     if (user_widget->pixels) {
-        Texture tex;
-        if (tex.loadFromImageBuffer(user_widget->pixels, user_widget->pixels_w, user_widget->pixels_h, renderer)) {
-            tex.render(renderer, x, y, user_widget->w, user_widget->h);
+        // texture is kept between the frames and only the dirty area is uploaded
+        Texture *texture;
+        UserWidgetTextureMap::iterator it = userWidgetTextures.find(user_widget);
+        if (it != userWidgetTextures.end() && it->second->getWidth() == user_widget->pixels_w && it->second->getHeight() == user_widget->pixels_h) {
+            texture = it->second;
+            if (user_widget->dirty_w > 0 && user_widget->dirty_h > 0) {
+                texture->update(user_widget->pixels, user_widget->dirty_x, user_widget->dirty_y, user_widget->dirty_w, user_widget->dirty_h);
+            }
+        } else {
+            if (it != userWidgetTextures.end()) {
+                delete it->second;
+                userWidgetTextures.erase(it);
+            }
+
+            texture = new Texture();
+            if (!texture->createStreaming(user_widget->pixels_w, user_widget->pixels_h, renderer)) {
+                delete texture;
+                texture = 0;
+            } else {
+                texture->update(user_widget->pixels, 0, 0, user_widget->pixels_w, user_widget->pixels_h);
+                userWidgetTextures.insert(std::make_pair(user_widget, texture));
+            }
+        }
+
+        if (texture) {
+            texture->render(renderer, x, y, user_widget->w, user_widget->h);
         }
     }
 
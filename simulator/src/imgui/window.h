@@ -55,6 +55,12 @@ struct UserWidget {
     int pixels_h;
     unsigned char *pixels;
 
+    /// Area of pixels changed since the previous frame, only this area is uploaded to the texture.
+    int dirty_x;
+    int dirty_y;
+    int dirty_w;
+    int dirty_h;
+
     MouseData mouseData;
 };
 
@@ -63,6 +63,8 @@ private:
     TTF_Font *font;
     typedef std::map<std::string, Texture *> TextureMap;
     TextureMap textures;
+    typedef std::map<UserWidget *, Texture *> UserWidgetTextureMap;
+    UserWidgetTextureMap userWidgetTextures;
 
     MouseData mouseData;
 
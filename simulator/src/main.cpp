@@ -24,8 +24,30 @@
 
 using namespace eez::psu;
 
-int main() {
+int main(int argc, char **argv) {
     simulator::init();
+
+    bool virtualTime = false;
+    const char *eepromImageFilePath = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--virtual-time") == 0) {
+            virtualTime = true;
+        } else if (strcmp(argv[i], "--eeprom") == 0 && i + 1 < argc) {
+            eepromImageFilePath = argv[++i];
+        }
+    }
+
+    // virtual time runs are repeatable, they don't start from the state left by the previous runs
+    if (virtualTime || eepromImageFilePath) {
+        if (!simulator::useVolatileState(eepromImageFilePath)) {
+            fprintf(stderr, "Can't read EEPROM image %s\n", eepromImageFilePath);
+            return 1;
+        }
+    }
+    if (virtualTime) {
+        simulator::setTimeMode(simulator::TIME_MODE_VIRTUAL);
+    }
+
     boot();
     main_loop();
 #if OPTION_DISPLAY
@@ -18,6 +18,7 @@
 
 #include "psu.h"
 #include "chips.h"
+#include "eeprom.h"
 #if OPTION_DISPLAY
 #include "front_panel/control.h"
 #endif
@@ -38,6 +39,7 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/time.h>
 #include <pwd.h>
 #endif
 
@@ -47,6 +49,45 @@ namespace simulator {
 
 float temperature[temp_sensor::NUM_TEMP_SENSORS];
 
+void (*g_onCriticalTick)();
+void (*g_onFrameStart)();
+void (*g_onFrameEnd)();
+
+static TimeMode g_timeMode = TIME_MODE_REAL;
+/// Difference between the simulator clock and the host clock in real time mode.
+static int64_t g_timeOffset;
+static uint64_t g_virtualTime;
+/// Virtual clock when virtual time mode is entered.
+static uint64_t g_virtualTimeStart;
+
+/// UTC time when virtual time mode is entered, fixed so runs are repeatable (2018-01-01 00:00:00).
+static const time_t VIRTUAL_TIME_UTC_START = 1514764800;
+
+static uint64_t getHostTime() {
+#ifdef _WIN32
+    static bool firstTime = true;
+    static unsigned __int64 frequency;
+    static unsigned __int64 startTime;
+
+    if (firstTime) {
+        firstTime = false;
+        QueryPerformanceFrequency((LARGE_INTEGER*)&frequency);
+        QueryPerformanceCounter((LARGE_INTEGER *)&startTime);
+
+        return 0;
+    } else {
+        unsigned __int64 time;
+        QueryPerformanceCounter((LARGE_INTEGER *)&time);
+
+        return (time - startTime) * 1000000L / frequency;
+    }
+#else
+    timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec*(uint64_t)1000000 + tv.tv_usec;
+#endif
+}
+
 void init() {
     for (int i = 0; i < temp_sensor::NUM_TEMP_SENSORS; ++i) {
         temperature[i] = 25.0f;
@@ -54,6 +95,10 @@ void init() {
 }
 
 void tick() {
+    if (g_timeMode == TIME_MODE_VIRTUAL) {
+        g_virtualTime += TICK_TIMEOUT * 1000;
+    }
+
     chips::tick();
     psu::tick();
 #if OPTION_DISPLAY
@@ -109,7 +154,68 @@ char *getConfFilePath(const char *file_name) {
     return file_path;
 }
 
+void setTimeMode(TimeMode mode) {
+    if (mode == g_timeMode) {
+        return;
+    }
+
+    // clock continues from the same value, so firmware doesn't see it going backwards
+    if (mode == TIME_MODE_VIRTUAL) {
+        g_virtualTime = getTime();
+        g_virtualTimeStart = g_virtualTime;
+    } else {
+        g_timeOffset = (int64_t)(g_virtualTime - getHostTime());
+    }
+
+    g_timeMode = mode;
+}
+
+TimeMode getTimeMode() {
+    return g_timeMode;
+}
+
+uint64_t getTime() {
+    if (g_timeMode == TIME_MODE_VIRTUAL) {
+        return g_virtualTime;
+    }
+    return getHostTime() + g_timeOffset;
+}
+
+bool useVolatileState(const char *eepromImageFilePath) {
+    return chips::useVolatileState(eepromImageFilePath);
+}
+
+void sleepMicroseconds(uint32_t microseconds) {
+    if (g_timeMode == TIME_MODE_VIRTUAL) {
+        // chips are running while firmware waits, e.g. for the ADC conversion
+        while (microseconds > 0) {
+            uint32_t step = microseconds < TICK_TIMEOUT * 1000 ? microseconds : TICK_TIMEOUT * 1000;
+            g_virtualTime += step;
+            microseconds -= step;
+            chips::tick();
+        }
+        return;
+    }
+
+#ifdef _WIN32
+    Sleep(microseconds / 1000);
+#else
+    timespec ts;
+    ts.tv_sec = microseconds / 1000000;
+    ts.tv_nsec = (microseconds % 1000000) * 1000;
+    nanosleep(&ts, 0);
+#endif
+}
+
+time_t getUtcTime() {
+    if (g_timeMode == TIME_MODE_VIRTUAL) {
+        return VIRTUAL_TIME_UTC_START + (time_t)((g_virtualTime - g_virtualTimeStart) / 1000000);
+    }
+    return time(0);
+}
+
 void exit() {
+    eeprom::flush();
     main_loop_exit();
 }
 
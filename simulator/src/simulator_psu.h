@@ -32,6 +32,8 @@
 #include <string.h>
 #include <math.h>
 #include <stdarg.h>
+#include <stdint.h>
+#include <time.h>
 
 #define PSTR(U) U
 #define strcpy_P strcpy
@@ -61,6 +63,38 @@ float getTemperature(int sensor);
 
 char *getConfFilePath(const char *file_name);
 
+/// Simulator clock mode.
+enum TimeMode {
+    /// Clock follows the host clock and delays are real sleeps.
+    TIME_MODE_REAL,
+    /// Clock is advanced only by delays and by TICK_TIMEOUT on every main loop tick,
+    /// main loop runs without waiting, so simulation is faster than real time and repeatable.
+    TIME_MODE_VIRTUAL
+};
+
+void setTimeMode(TimeMode mode);
+TimeMode getTimeMode();
+
+/// Start from the fresh EEPROM, or from the copy of the given EEPROM image file,
+/// and from the unset RTC offset, instead of the state saved in the home directory
+/// by the previous runs. Changes are not saved. Call before boot.
+/// \returns false if EEPROM image file can't be read.
+bool useVolatileState(const char *eepromImageFilePath = 0);
+
+/// Returns simulator clock in microseconds, used by micros() and millis().
+uint64_t getTime();
+/// Sleeps in real time mode, advances clock in virtual time mode.
+void sleepMicroseconds(uint32_t microseconds);
+/// Returns UTC time for the RTC chip, in virtual time mode it starts from the fixed
+/// time (2018-01-01 00:00:00) and is advanced with the virtual clock.
+time_t getUtcTime();
+
+/// Called by the firmware at the beginning of every criticalTick, used by the benchmark.
+extern void (*g_onCriticalTick)();
+/// Called by the firmware before and after GUI tick, used by the benchmark.
+extern void (*g_onFrameStart)();
+extern void (*g_onFrameEnd)();
+
 void exit();
 
 }
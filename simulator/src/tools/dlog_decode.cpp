@@ -0,0 +1,461 @@
+/*
+* EEZ PSU Firmware
+* Copyright (C) 2018-present, Envox d.o.o.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Command line decoder for the DLOG files (version 1 and 2).
+//
+// Usage: dlog_decode [-b | -i] [-t <from> <to>] <file.dlog>
+//
+//     (no option) print all rows as CSV
+//     -b          print summary of every data block (version 2 only)
+//     -i          print block index (version 2 only)
+//     -t          print only rows between <from> and <to> seconds
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+
+#include "dlog_file.h"
+
+using namespace eez::psu::dlog;
+
+namespace {
+
+struct Header {
+    uint16_t version;
+    uint16_t flags;
+    uint32_t columns;
+    float period;
+    float time;
+    uint32_t startTime;
+
+    // version 2
+    uint16_t blockSize;
+    uint16_t numColumns;
+    std::vector<float> resolution;
+};
+
+struct Summary {
+    uint32_t firstBlock;
+    uint32_t firstRow;
+    uint32_t numRows;
+    std::vector<float> min;
+    std::vector<float> max;
+    std::vector<float> mean;
+};
+
+FILE *g_fp;
+long g_fileSize;
+Header g_header;
+std::vector<std::string> g_columnNames;
+
+uint16_t getUint16(const uint8_t *p) {
+    return p[0] | (p[1] << 8);
+}
+
+uint32_t getUint32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+float getFloat(const uint8_t *p) {
+    uint32_t value = getUint32(p);
+    float result;
+    memcpy(&result, &value, 4);
+    return result;
+}
+
+bool readAt(long offset, uint8_t *buffer, size_t size) {
+    return fseek(g_fp, offset, SEEK_SET) == 0 && fread(buffer, 1, size, g_fp) == size;
+}
+
+bool readHeader() {
+    uint8_t buffer[HEADER_SIZE_V1 + 4];
+
+    if (!readAt(0, buffer, HEADER_SIZE_V1)) {
+        fprintf(stderr, "File too short\n");
+        return false;
+    }
+
+    if (getUint32(buffer) != MAGIC1 || getUint32(buffer + 4) != MAGIC2) {
+        fprintf(stderr, "Not a DLOG file\n");
+        return false;
+    }
+
+    g_header.version = getUint16(buffer + 8);
+    g_header.flags = getUint16(buffer + 10);
+    g_header.columns = getUint32(buffer + 12);
+    g_header.period = getFloat(buffer + 16);
+    g_header.time = getFloat(buffer + 20);
+    g_header.startTime = getUint32(buffer + 24);
+
+    if (g_header.flags & FLAG_JITTER) {
+        g_columnNames.push_back("Jitter");
+    }
+    for (int iChannel = 0; iChannel < 8; ++iChannel) {
+        static const char *names[] = { "U", "I", "P" };
+        for (int i = 0; i < 3; ++i) {
+            if (g_header.columns & ((1 << i) << (4 * iChannel))) {
+                char name[16];
+                sprintf(name, "%s%d", names[i], iChannel + 1);
+                g_columnNames.push_back(name);
+            }
+        }
+    }
+
+    if (g_header.version == VERSION1) {
+        g_header.numColumns = getNumColumns(g_header.columns, g_header.flags);
+        return true;
+    }
+
+    if (g_header.version != VERSION2) {
+        fprintf(stderr, "Unsupported version %d\n", g_header.version);
+        return false;
+    }
+
+    if (!readAt(HEADER_SIZE_V1, buffer, 4)) {
+        fprintf(stderr, "File too short\n");
+        return false;
+    }
+
+    g_header.blockSize = getUint16(buffer);
+    g_header.numColumns = getUint16(buffer + 2);
+
+    if (g_header.numColumns != getNumColumns(g_header.columns, g_header.flags)) {
+        fprintf(stderr, "Invalid number of columns\n");
+        return false;
+    }
+
+    std::vector<uint8_t> resolution(4 * g_header.numColumns);
+    if (!readAt(HEADER_SIZE_V1 + 4, &resolution[0], resolution.size())) {
+        fprintf(stderr, "File too short\n");
+        return false;
+    }
+    for (int i = 0; i < g_header.numColumns; ++i) {
+        g_header.resolution.push_back(getFloat(&resolution[4 * i]));
+    }
+
+    return true;
+}
+
+void printHeader() {
+    printf("# version %d, period %g s, time %g s, start time %u%s%s\n",
+        g_header.version, g_header.period, g_header.time, g_header.startTime,
+        g_header.flags & FLAG_ADC ? ", ADC" : "",
+        g_header.flags & FLAG_JITTER ? ", jitter" : "");
+}
+
+void printColumnNames(const char *prefix) {
+    printf("%s", prefix);
+    for (size_t i = 0; i < g_columnNames.size(); ++i) {
+        printf(",%s", g_columnNames[i].c_str());
+    }
+    printf("\n");
+}
+
+void printRow(uint32_t row, const float *values, float from, float to) {
+    float time = row * g_header.period;
+    if (time < from || time > to) {
+        return;
+    }
+    printf("%.6f", time);
+    for (int i = 0; i < g_header.numColumns; ++i) {
+        if (isnan(values[i])) {
+            printf(",");
+        } else {
+            printf(",%g", values[i]);
+        }
+    }
+    printf("\n");
+}
+
+void printSummary(const Summary &summary) {
+    printf("%u,%u,%.6f,%u", summary.firstBlock, summary.firstRow, summary.firstRow * g_header.period, summary.numRows);
+    for (int i = 0; i < g_header.numColumns; ++i) {
+        printf(",%g,%g,%g", summary.min[i], summary.max[i], summary.mean[i]);
+    }
+    printf("\n");
+}
+
+void printSummaryColumnNames() {
+    printf("Block,Row,Time,Rows");
+    for (size_t i = 0; i < g_columnNames.size(); ++i) {
+        const char *name = g_columnNames[i].c_str();
+        printf(",%s min,%s max,%s mean", name, name, name);
+    }
+    printf("\n");
+}
+
+const uint8_t *readSummary(const uint8_t *p, Summary &summary) {
+    summary.min.resize(g_header.numColumns);
+    summary.max.resize(g_header.numColumns);
+    summary.mean.resize(g_header.numColumns);
+    for (int i = 0; i < g_header.numColumns; ++i, p += 4) {
+        summary.min[i] = getFloat(p);
+    }
+    for (int i = 0; i < g_header.numColumns; ++i, p += 4) {
+        summary.max[i] = getFloat(p);
+    }
+    for (int i = 0; i < g_header.numColumns; ++i, p += 4) {
+        summary.mean[i] = getFloat(p);
+    }
+    return p;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// version 1
+
+void decodeV1(float from, float to) {
+    std::vector<uint8_t> buffer(4 * g_header.numColumns);
+    std::vector<float> values(g_header.numColumns);
+
+    uint32_t firstRow = from > 0 ? (uint32_t)(from / g_header.period) : 0;
+    fseek(g_fp, HEADER_SIZE_V1 + firstRow * buffer.size(), SEEK_SET);
+
+    for (uint32_t row = firstRow; fread(&buffer[0], 1, buffer.size(), g_fp) == buffer.size(); ++row) {
+        for (int i = 0; i < g_header.numColumns; ++i) {
+            values[i] = getFloat(&buffer[4 * i]);
+        }
+        printRow(row, &values[0], from, to);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// version 2
+
+bool readTrailer(uint8_t *trailer) {
+    return g_fileSize >= (long)INDEX_TRAILER_SIZE &&
+        readAt(g_fileSize - INDEX_TRAILER_SIZE, trailer, INDEX_TRAILER_SIZE) &&
+        getUint32(trailer + 12) == MAGIC_INDEX;
+}
+
+uint32_t getNumBlocks() {
+    uint8_t trailer[INDEX_TRAILER_SIZE];
+    if (readTrailer(trailer)) {
+        // data blocks end where the index starts
+        return getUint32(trailer) / g_header.blockSize - 1;
+    }
+    return (uint32_t)(g_fileSize / g_header.blockSize) - 1;
+}
+
+bool readBlock(uint32_t iBlock, std::vector<uint8_t> &block, Summary &summary) {
+    block.resize(g_header.blockSize);
+    if (!readAt((iBlock + 1) * g_header.blockSize, &block[0], g_header.blockSize)) {
+        return false;
+    }
+
+    summary.firstBlock = iBlock;
+    summary.firstRow = getUint32(&block[0]);
+    summary.numRows = getUint16(&block[4]);
+    readSummary(&block[BLOCK_HEADER_SIZE], summary);
+
+    return summary.numRows > 0;
+}
+
+bool decodeBlock(const std::vector<uint8_t> &block, const Summary &summary, float from, float to) {
+    uint16_t dataLength = getUint16(&block[6]);
+    const uint8_t *p = &block[BLOCK_HEADER_SIZE + g_header.numColumns * BLOCK_COLUMN_SUMMARY_SIZE];
+    const uint8_t *end = p + dataLength;
+    if (end > &block[0] + block.size()) {
+        fprintf(stderr, "Block %u: invalid data length\n", summary.firstBlock);
+        return false;
+    }
+
+    std::vector<int32_t> codes(g_header.numColumns, 0);
+    std::vector<float> values(g_header.numColumns);
+
+    for (uint32_t row = 0; row < summary.numRows; ++row) {
+        for (int i = 0; i < g_header.numColumns; ++i) {
+            p = readValue(p, end, g_header.resolution[i], codes[i], values[i]);
+            if (!p) {
+                fprintf(stderr, "Block %u: unexpected end of data\n", summary.firstBlock);
+                return false;
+            }
+        }
+
+        printRow(summary.firstRow + row, &values[0], from, to);
+    }
+
+    return true;
+}
+
+/// Reads the index from the end of the file, returns false if the file has no index.
+bool readIndex(std::vector<Summary> &index, uint16_t &blocksPerEntry, uint32_t &numRows) {
+    uint8_t trailer[INDEX_TRAILER_SIZE];
+    if (!readTrailer(trailer)) {
+        return false;
+    }
+
+    uint32_t indexOffset = getUint32(trailer);
+    uint16_t numEntries = getUint16(trailer + 4);
+    blocksPerEntry = getUint16(trailer + 6);
+    numRows = getUint32(trailer + 8);
+
+    size_t entrySize = INDEX_ENTRY_HEADER_SIZE + g_header.numColumns * BLOCK_COLUMN_SUMMARY_SIZE;
+    std::vector<uint8_t> buffer(numEntries * entrySize);
+    if (numEntries > 0 && !readAt(indexOffset, &buffer[0], buffer.size())) {
+        return false;
+    }
+
+    index.resize(numEntries);
+    for (uint16_t i = 0; i < numEntries; ++i) {
+        const uint8_t *p = &buffer[i * entrySize];
+        index[i].firstBlock = getUint32(p);
+        index[i].firstRow = getUint32(p + 4);
+        readSummary(p + INDEX_ENTRY_HEADER_SIZE, index[i]);
+    }
+
+    for (uint16_t i = 0; i < numEntries; ++i) {
+        index[i].numRows = (i + 1 < numEntries ? index[i + 1].firstRow : numRows) - index[i].firstRow;
+    }
+
+    return true;
+}
+
+void decodeV2(float from, float to) {
+    uint32_t numBlocks = getNumBlocks();
+    uint32_t firstBlock = 0;
+
+    // use the index to skip the blocks before the requested time range
+    std::vector<Summary> index;
+    uint16_t blocksPerEntry;
+    uint32_t numRows;
+    if (readIndex(index, blocksPerEntry, numRows)) {
+        for (size_t i = 0; i < index.size() && (index[i].firstRow + index[i].numRows) * g_header.period < from; ++i) {
+            firstBlock = index[i].firstBlock + blocksPerEntry;
+        }
+    }
+
+    std::vector<uint8_t> block;
+    Summary summary;
+    for (uint32_t iBlock = firstBlock; iBlock < numBlocks && readBlock(iBlock, block, summary); ++iBlock) {
+        if (summary.firstRow * g_header.period > to) {
+            break;
+        }
+        if ((summary.firstRow + summary.numRows) * g_header.period < from) {
+            continue;
+        }
+        if (!decodeBlock(block, summary, from, to)) {
+            break;
+        }
+    }
+}
+
+void printBlocks() {
+    printSummaryColumnNames();
+
+    uint32_t numBlocks = getNumBlocks();
+    std::vector<uint8_t> block;
+    Summary summary;
+    for (uint32_t iBlock = 0; iBlock < numBlocks && readBlock(iBlock, block, summary); ++iBlock) {
+        printSummary(summary);
+    }
+}
+
+bool printIndex() {
+    std::vector<Summary> index;
+    uint16_t blocksPerEntry;
+    uint32_t numRows;
+    if (!readIndex(index, blocksPerEntry, numRows)) {
+        fprintf(stderr, "File has no index, logging was interrupted?\n");
+        return false;
+    }
+
+    printf("# %u rows, %d blocks per index entry\n", numRows, blocksPerEntry);
+    printSummaryColumnNames();
+    for (size_t i = 0; i < index.size(); ++i) {
+        printSummary(index[i]);
+    }
+
+    return true;
+}
+
+void usage() {
+    fprintf(stderr, "Usage: dlog_decode [-b | -i] [-t <from> <to>] <file.dlog>\n");
+}
+
+}
+
+int main(int argc, char **argv) {
+    bool blocks = false;
+    bool index = false;
+    float from = 0;
+    float to = INFINITY;
+    const char *filePath = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-b") == 0) {
+            blocks = true;
+        } else if (strcmp(argv[i], "-i") == 0) {
+            index = true;
+        } else if (strcmp(argv[i], "-t") == 0 && i + 2 < argc) {
+            from = (float)atof(argv[++i]);
+            to = (float)atof(argv[++i]);
+        } else if (!filePath && argv[i][0] != '-') {
+            filePath = argv[i];
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    if (!filePath) {
+        usage();
+        return 1;
+    }
+
+    g_fp = fopen(filePath, "rb");
+    if (!g_fp) {
+        fprintf(stderr, "Can't open %s\n", filePath);
+        return 1;
+    }
+
+    fseek(g_fp, 0, SEEK_END);
+    g_fileSize = ftell(g_fp);
+
+    if (!readHeader()) {
+        return 1;
+    }
+
+    printHeader();
+
+    if ((blocks || index) && g_header.version != VERSION2) {
+        fprintf(stderr, "Blocks and index are available only in version 2 files\n");
+        return 1;
+    }
+
+    if (blocks) {
+        printBlocks();
+    } else if (index) {
+        if (!printIndex()) {
+            return 1;
+        }
+    } else {
+        printColumnNames("Time");
+        if (g_header.version == VERSION1) {
+            decodeV1(from, to);
+        } else {
+            decodeV2(from, to);
+        }
+    }
+
+    fclose(g_fp);
+
+    return 0;
+}
@@ -0,0 +1,407 @@
+/*
+* EEZ PSU Firmware
+* Copyright (C) 2018-present, Envox d.o.o.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// DLOG file format round trip test.
+//
+// Usage: dlog_roundtrip [<dlog_decode>]
+//
+// Writes version 1 and version 2 DLOG files with known rows, version 2 rows
+// are encoded with dlog_file.h (several data blocks, NAN and negative values,
+// values out of the code range). Files are decoded with dlog_decode (default
+// ./dlog_decode) and every decoded row is compared with the written row,
+// quantized to the column resolution. Index of the version 2 file must
+// count all the rows. Exits with 1 if anything differs.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+
+#include "dlog_file.h"
+
+using namespace eez::psu::dlog;
+
+namespace {
+
+const char *FILE_PATH_V1 = "dlog_roundtrip_v1.dlog";
+const char *FILE_PATH_V2 = "dlog_roundtrip_v2.dlog";
+
+const float PERIOD = 0.01f;
+const float TIME = 60.0f;
+const uint16_t BLOCK_SIZE = 512;
+const int NUM_ROWS = 1000;
+
+// U1, I1 and P2
+const uint32_t COLUMNS = 0x01 | 0x02 | 0x40;
+const int NUM_COLUMNS = 3;
+const float RESOLUTION[NUM_COLUMNS] = { 40.0f / 32767, 5.0f / 32767, 200.0f / 32767 };
+
+std::vector<float> g_rows;
+
+void generateRows() {
+    g_rows.resize(NUM_ROWS * NUM_COLUMNS);
+
+    uint32_t seed = 12345;
+    float values[NUM_COLUMNS] = { 10.0f, 0.5f, 20.0f };
+    for (int row = 0; row < NUM_ROWS; ++row) {
+        for (int i = 0; i < NUM_COLUMNS; ++i) {
+            seed = seed * 1103515245 + 12345;
+            values[i] += (((seed >> 16) % 2001) - 1000.0f) * RESOLUTION[i];
+            g_rows[row * NUM_COLUMNS + i] = values[i];
+        }
+
+        if (row % 37 == 0) {
+            g_rows[row * NUM_COLUMNS + row % NUM_COLUMNS] = NAN;
+        }
+    }
+
+    // out of the code range in both directions, largest possible delta
+    g_rows[500 * NUM_COLUMNS + 1] = -1E7f;
+    g_rows[501 * NUM_COLUMNS + 1] = 1E7f;
+}
+
+/// Value decoded from the version 2 file.
+float getQuantizedValue(float value, float resolution) {
+    if (isnan(value)) {
+        return value;
+    }
+    float code = roundf(value / resolution);
+    if (code > CODE_MAX) {
+        code = CODE_MAX;
+    } else if (code < -CODE_MAX) {
+        code = -CODE_MAX;
+    }
+    return (int32_t)code * resolution;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint8_t *putUint16(uint8_t *p, uint16_t value) {
+    *p++ = value & 0xFF;
+    *p++ = value >> 8;
+    return p;
+}
+
+uint8_t *putUint32(uint8_t *p, uint32_t value) {
+    p = putUint16(p, value & 0xFFFF);
+    return putUint16(p, value >> 16);
+}
+
+uint8_t *putFloat(uint8_t *p, float value) {
+    uint32_t data;
+    memcpy(&data, &value, 4);
+    return putUint32(p, data);
+}
+
+struct Summary {
+    float min[NUM_COLUMNS];
+    float max[NUM_COLUMNS];
+    float mean[NUM_COLUMNS];
+    uint32_t count[NUM_COLUMNS];
+
+    void reset() {
+        for (int i = 0; i < NUM_COLUMNS; ++i) {
+            min[i] = NAN;
+            max[i] = NAN;
+            mean[i] = 0;
+            count[i] = 0;
+        }
+    }
+
+    void add(const float *values) {
+        for (int i = 0; i < NUM_COLUMNS; ++i) {
+            if (isnan(values[i])) {
+                continue;
+            }
+            if (count[i] == 0 || values[i] < min[i]) {
+                min[i] = values[i];
+            }
+            if (count[i] == 0 || values[i] > max[i]) {
+                max[i] = values[i];
+            }
+            mean[i] += values[i];
+            ++count[i];
+        }
+    }
+
+    uint8_t *put(uint8_t *p) const {
+        for (int i = 0; i < NUM_COLUMNS; ++i) {
+            p = putFloat(p, min[i]);
+        }
+        for (int i = 0; i < NUM_COLUMNS; ++i) {
+            p = putFloat(p, max[i]);
+        }
+        for (int i = 0; i < NUM_COLUMNS; ++i) {
+            p = putFloat(p, count[i] > 0 ? mean[i] / count[i] : NAN);
+        }
+        return p;
+    }
+};
+
+uint8_t *putHeader(uint8_t *p, uint16_t version) {
+    p = putUint32(p, MAGIC1);
+    p = putUint32(p, MAGIC2);
+    p = putUint16(p, version);
+    p = putUint16(p, 0);
+    p = putUint32(p, COLUMNS);
+    p = putFloat(p, PERIOD);
+    p = putFloat(p, TIME);
+    return putUint32(p, 0);
+}
+
+bool writeFile(const char *filePath, const std::vector<uint8_t> &data) {
+    FILE *fp = fopen(filePath, "wb");
+    if (!fp) {
+        fprintf(stderr, "Can't create %s\n", filePath);
+        return false;
+    }
+    bool result = fwrite(&data[0], 1, data.size(), fp) == data.size();
+    fclose(fp);
+    return result;
+}
+
+bool writeV1() {
+    std::vector<uint8_t> data(HEADER_SIZE_V1 + NUM_ROWS * NUM_COLUMNS * 4);
+    uint8_t *p = putHeader(&data[0], VERSION1);
+    for (size_t i = 0; i < g_rows.size(); ++i) {
+        p = putFloat(p, g_rows[i]);
+    }
+    return writeFile(FILE_PATH_V1, data);
+}
+
+bool writeV2() {
+    std::vector<uint8_t> data(BLOCK_SIZE);
+
+    uint8_t *p = putHeader(&data[0], VERSION2);
+    p = putUint16(p, BLOCK_SIZE);
+    p = putUint16(p, NUM_COLUMNS);
+    for (int i = 0; i < NUM_COLUMNS; ++i) {
+        p = putFloat(p, RESOLUTION[i]);
+    }
+
+    const uint16_t dataOffset = BLOCK_HEADER_SIZE + NUM_COLUMNS * BLOCK_COLUMN_SUMMARY_SIZE;
+
+    std::vector<Summary> index;
+    std::vector<uint32_t> indexFirstRow;
+
+    uint8_t block[BLOCK_SIZE];
+    uint16_t position = dataOffset;
+    int32_t lastCode[NUM_COLUMNS] = { 0 };
+    uint32_t firstRow = 0;
+    Summary summary;
+    summary.reset();
+
+    for (int row = 0; row <= NUM_ROWS; ++row) {
+        bool lastRow = row == NUM_ROWS;
+        if (lastRow || BLOCK_SIZE - position < NUM_COLUMNS * (int)VARINT_MAX_SIZE) {
+            memset(block + position, 0, BLOCK_SIZE - position);
+            uint8_t *q = putUint32(block, firstRow);
+            q = putUint16(q, (uint16_t)(row - firstRow));
+            q = putUint16(q, position - dataOffset);
+            summary.put(q);
+            data.insert(data.end(), block, block + BLOCK_SIZE);
+
+            index.push_back(summary);
+            indexFirstRow.push_back(firstRow);
+
+            if (lastRow) {
+                break;
+            }
+
+            position = dataOffset;
+            for (int i = 0; i < NUM_COLUMNS; ++i) {
+                lastCode[i] = 0;
+            }
+            firstRow = row;
+            summary.reset();
+        }
+
+        const float *values = &g_rows[row * NUM_COLUMNS];
+        p = block + position;
+        for (int i = 0; i < NUM_COLUMNS; ++i) {
+            p = writeValue(p, values[i], RESOLUTION[i], lastCode[i]);
+        }
+        position = (uint16_t)(p - block);
+        summary.add(values);
+    }
+
+    uint32_t indexOffset = data.size();
+    uint8_t entry[INDEX_ENTRY_HEADER_SIZE + NUM_COLUMNS * BLOCK_COLUMN_SUMMARY_SIZE];
+    for (size_t i = 0; i < index.size(); ++i) {
+        p = putUint32(entry, i);
+        p = putUint32(p, indexFirstRow[i]);
+        index[i].put(p);
+        data.insert(data.end(), entry, entry + sizeof(entry));
+    }
+
+    uint8_t trailer[INDEX_TRAILER_SIZE];
+    p = putUint32(trailer, indexOffset);
+    p = putUint16(p, (uint16_t)index.size());
+    p = putUint16(p, 1);
+    p = putUint32(p, NUM_ROWS);
+    putUint32(p, MAGIC_INDEX);
+    data.insert(data.end(), trailer, trailer + INDEX_TRAILER_SIZE);
+
+    printf("version 2: %d rows in %d blocks\n", NUM_ROWS, (int)index.size());
+
+    return writeFile(FILE_PATH_V2, data);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Parses CSV row printed by dlog_decode, empty field is NAN.
+bool parseRow(const char *line, std::vector<float> &values) {
+    values.clear();
+    const char *p = line;
+    while (true) {
+        if (*p == ',' || *p == '\n' || *p == 0) {
+            values.push_back(NAN);
+        } else {
+            char *end;
+            values.push_back((float)strtod(p, &end));
+            if (end == p) {
+                return false;
+            }
+            p = end;
+        }
+        if (*p != ',') {
+            break;
+        }
+        ++p;
+    }
+    return *p == '\n' || *p == 0;
+}
+
+bool equal(float decoded, float expected) {
+    if (isnan(expected) || isnan(decoded)) {
+        return isnan(expected) && isnan(decoded);
+    }
+    // dlog_decode prints 6 significant digits
+    return fabs(decoded - expected) <= 1E-5 * fabs(expected) + 1E-9;
+}
+
+bool checkRows(const char *decoder, const char *filePath, bool quantized) {
+    std::string command = std::string(decoder) + " " + filePath;
+    FILE *fp = popen(command.c_str(), "r");
+    if (!fp) {
+        fprintf(stderr, "Can't run %s\n", command.c_str());
+        return false;
+    }
+
+    int numRows = 0;
+    int numErrors = 0;
+    bool columnNames = true;
+    char line[256];
+    std::vector<float> values;
+    while (fgets(line, sizeof(line), fp)) {
+        if (line[0] == '#') {
+            continue;
+        }
+        if (columnNames) {
+            columnNames = false;
+            continue;
+        }
+
+        if (!parseRow(line, values) || values.size() != 1 + NUM_COLUMNS || numRows >= NUM_ROWS) {
+            if (numErrors++ < 10) {
+                fprintf(stderr, "%s: invalid row: %s", filePath, line);
+            }
+            continue;
+        }
+
+        bool ok = equal(values[0], numRows * PERIOD);
+        for (int i = 0; i < NUM_COLUMNS; ++i) {
+            float expected = g_rows[numRows * NUM_COLUMNS + i];
+            if (quantized) {
+                expected = getQuantizedValue(expected, RESOLUTION[i]);
+            }
+            ok = equal(values[1 + i], expected) && ok;
+        }
+        if (!ok && numErrors++ < 10) {
+            fprintf(stderr, "%s: row %d differs: %s", filePath, numRows, line);
+        }
+
+        ++numRows;
+    }
+
+    if (pclose(fp) != 0) {
+        fprintf(stderr, "%s failed\n", command.c_str());
+        return false;
+    }
+
+    if (numRows != NUM_ROWS) {
+        fprintf(stderr, "%s: %d rows decoded, expected %d\n", filePath, numRows, NUM_ROWS);
+        ++numErrors;
+    }
+
+    printf("%s: %d rows decoded, errors: %d\n", filePath, numRows, numErrors);
+    return numErrors == 0;
+}
+
+bool checkIndex(const char *decoder, const char *filePath) {
+    std::string command = std::string(decoder) + " -i " + filePath;
+    FILE *fp = popen(command.c_str(), "r");
+    if (!fp) {
+        fprintf(stderr, "Can't run %s\n", command.c_str());
+        return false;
+    }
+
+    unsigned numRows = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), fp)) {
+        sscanf(line, "# %u rows", &numRows);
+    }
+
+    if (pclose(fp) != 0) {
+        fprintf(stderr, "%s failed\n", command.c_str());
+        return false;
+    }
+
+    printf("%s: index has %u rows\n", filePath, numRows);
+    return numRows == NUM_ROWS;
+}
+
+}
+
+int main(int argc, char **argv) {
+    if (argc > 2) {
+        fprintf(stderr, "Usage: dlog_roundtrip [<dlog_decode>]\n");
+        return 1;
+    }
+    const char *decoder = argc == 2 ? argv[1] : "./dlog_decode";
+
+    generateRows();
+
+    if (!writeV1() || !writeV2()) {
+        return 1;
+    }
+
+    bool ok = checkRows(decoder, FILE_PATH_V1, false);
+    ok = checkRows(decoder, FILE_PATH_V2, true) && ok;
+    ok = checkIndex(decoder, FILE_PATH_V2) && ok;
+
+    if (ok) {
+        remove(FILE_PATH_V1);
+        remove(FILE_PATH_V2);
+    }
+
+    printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,361 @@
+/*
+* EEZ PSU Firmware
+* Copyright (C) 2018-present, Envox d.o.o.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Measurement pipeline benchmark.
+//
+// Usage: meas_bench [-n <samples>]
+//
+// Feeds the same noisy ADC samples through the float measurement pipeline
+// (remap to volts, calibration remap, float averaging, util::greaterOrEqual
+// protection check) and through the firmware integer pipeline
+// (AdcDataConversion, Channel::Value averaging in micro units, threshold
+// comparison) and reports cycles per sample for both, together with the
+// largest difference of the averaged values and the number of samples
+// where the protection conditions differ. Float running total accumulates
+// rounding error, so the differences grow with the number of samples.
+// Both pipelines are run with two and three point calibration.
+//
+// Host has an FPU, so the measured ratio is much smaller than on the
+// Cortex-M3 where every float operation is a library call.
+//
+// Before the benchmark, AdcDataConversion is checked against the double
+// precision reference (ADC data remapped to the channel range, then remapped
+// through the calibration points) for every ADC data value, with two and
+// three point calibration. With the same calibrations, the fast trip ADC data
+// found for the protection levels over the whole range is checked to be the
+// lowest ADC data at or above the level, and the number of the OCP samples
+// from the level crossing to the fast trip (trip latency) is checked, together
+// with a single noisy sample above the level not tripping.
+// Exits with 1 if any of the checks fails.
+
+#include "psu.h"
+#include "adc.h"
+
+#if defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+
+#include <vector>
+
+using namespace eez::psu;
+
+namespace {
+
+const float U_MIN = 0;
+const float U_MAX = 40.0f;
+const float OVP_LEVEL = 20.0f;
+
+/// Cycle counter, or nanoseconds if not available on the host.
+uint64_t cycles() {
+#if defined(__i386__) || defined(__x86_64__)
+    return __rdtsc();
+#else
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+/// Largest allowed difference between AdcDataConversion and the reference, in micro units.
+const double MAX_CONVERSION_ERROR = 2.0;
+
+Channel::CalibrationValueConfiguration g_calConf;
+Channel::CalibrationValueConfiguration g_calConf3;
+/// Calibration used by the pipelines.
+const Channel::CalibrationValueConfiguration *g_pipelineCalConf;
+std::vector<int16_t> g_samples;
+
+std::vector<float> g_floatMon;
+std::vector<bool> g_floatCondition;
+std::vector<float> g_intMon;
+std::vector<bool> g_intCondition;
+
+void initCalibration() {
+    memset(&g_calConf, 0, sizeof(g_calConf));
+    // two point calibration, mid point is not used
+    g_calConf.min.adc = 0.15f;
+    g_calConf.min.val = 0.1512f;
+    g_calConf.mid.adc = 0.15f;
+    g_calConf.max.adc = 38.0f;
+    g_calConf.max.val = 38.0712f;
+
+    // three point calibration, different gain below and above mid point
+    memset(&g_calConf3, 0, sizeof(g_calConf3));
+    g_calConf3.min.adc = 0.15f;
+    g_calConf3.min.val = 0.1512f;
+    g_calConf3.mid.adc = 19.8f;
+    g_calConf3.mid.val = 19.7893f;
+    g_calConf3.max.adc = 38.0f;
+    g_calConf3.max.val = 38.0712f;
+}
+
+/// Reference conversion in double precision, as the firmware did before AdcDataConversion.
+double referenceValue(int16_t data, const Channel::CalibrationValueConfiguration &calConf) {
+    double value = U_MIN + ((double)data - AnalogDigitalConverter::ADC_MIN) * (U_MAX - U_MIN) /
+        ((double)AnalogDigitalConverter::ADC_MAX - AnalogDigitalConverter::ADC_MIN);
+
+    const Channel::CalibrationValuePointConfiguration *p1 = &calConf.min;
+    const Channel::CalibrationValuePointConfiguration *p2 = &calConf.max;
+    if (calConf.min.adc < calConf.mid.adc && calConf.mid.adc < calConf.max.adc) {
+        if (value < calConf.mid.adc) {
+            p2 = &calConf.mid;
+        } else {
+            p1 = &calConf.mid;
+        }
+    }
+
+    return p1->val + (value - p1->adc) * ((double)p2->val - p1->val) / ((double)p2->adc - p1->adc);
+}
+
+bool checkConversion(const char *name, const Channel::CalibrationValueConfiguration &calConf) {
+    Channel::AdcDataConversion conversion;
+    conversion.build(U_MIN, U_MAX, 0, &calConf);
+
+    double maxDiff = 0;
+    for (int32_t data = -32768; data <= 32767; ++data) {
+        double diff = fabs(conversion.toMicroUnits((int16_t)data) - referenceValue((int16_t)data, calConf) * 1E6);
+        if (diff > maxDiff) {
+            maxDiff = diff;
+        }
+    }
+
+    bool ok = maxDiff <= MAX_CONVERSION_ERROR;
+    printf("%s calibration conversion max difference: %.3f uV%s\n", name, maxDiff, ok ? "" : " FAILED");
+    return ok;
+}
+
+/// Check the fast trip ADC data and latency, in samples, of the OCP fast trip.
+bool checkFastTrip(const char *name, const Channel::CalibrationValueConfiguration &calConf) {
+    Channel::AdcDataConversion conversion;
+    conversion.build(U_MIN, U_MAX, 0, &calConf);
+    float prec = getPrecision(VALUE_TYPE_FLOAT_VOLT);
+
+    int numLevels = 0;
+    int numDataErrors = 0;
+    int numSpikeTrips = 0;
+    int maxLatency = 0;
+    for (float level = 0.5f; level < U_MAX; level += 0.5f) {
+        ++numLevels;
+
+        int64_t threshold = util::greaterOrEqualThresholdMicro(level, prec);
+        int16_t data;
+        if (!conversion.findAdcData(threshold, data) || conversion.toMicroUnits(data) < threshold ||
+            (data > -32768 && conversion.toMicroUnits(data - 1) >= threshold)) {
+            ++numDataErrors;
+            continue;
+        }
+
+        Channel::ProtectionValue cpv;
+        cpv.fast_trip_data = data;
+        cpv.fast_trip_count = 0;
+
+        // single sample above the level between the samples just below it
+        bool tripped = false;
+        for (int i = 0; i < 100; ++i) {
+            tripped = cpv.fastTripSample(i == 50 ? data + 1000 : data - 1, CONF_FAST_TRIP_OCP_NUM_SAMPLES) || tripped;
+        }
+        if (tripped && CONF_FAST_TRIP_OCP_NUM_SAMPLES > 1) {
+            ++numSpikeTrips;
+        }
+
+        // step to the level
+        int latency = 0;
+        do {
+            ++latency;
+        } while (!cpv.fastTripSample(data, CONF_FAST_TRIP_OCP_NUM_SAMPLES) && latency < 1000);
+        if (latency > maxLatency) {
+            maxLatency = latency;
+        }
+    }
+
+    bool ok = numDataErrors == 0 && numSpikeTrips == 0 && maxLatency == CONF_FAST_TRIP_OCP_NUM_SAMPLES;
+    printf("%s calibration fast trip: %d levels, data errors: %d, spike trips: %d, max latency: %d samples%s\n",
+        name, numLevels, numDataErrors, numSpikeTrips, maxLatency, ok ? "" : " FAILED");
+    return ok;
+}
+
+/// Random walk around 20 V (the OVP level), so both protection outcomes are exercised.
+void generateSamples(int numSamples) {
+    g_samples.resize(numSamples);
+    uint32_t seed = 12345;
+    int32_t center = (int32_t)(AnalogDigitalConverter::ADC_MAX / 2);
+    int32_t data = center;
+    for (int i = 0; i < numSamples; ++i) {
+        seed = seed * 1103515245 + 12345;
+        data += (int32_t)((seed >> 16) % 41) - 20;
+        data += (center - data) / 64;
+        g_samples[i] = (int16_t)data;
+    }
+}
+
+struct FloatValue {
+    float mon;
+    int8_t mon_index;
+    float mon_arr[NUM_ADC_AVERAGING_VALUES];
+    float mon_total;
+
+    void addMonValue(float value) {
+        if (mon_index == -1) {
+            mon_index = 0;
+            for (int i = 0; i < NUM_ADC_AVERAGING_VALUES; ++i) {
+                mon_arr[i] = value;
+            }
+            mon_total = NUM_ADC_AVERAGING_VALUES * value;
+            mon = value;
+        } else {
+            mon_total -= mon_arr[mon_index];
+            mon_total += value;
+            mon_arr[mon_index] = value;
+            mon_index = (mon_index + 1) % NUM_ADC_AVERAGING_VALUES;
+            mon = mon_total / NUM_ADC_AVERAGING_VALUES;
+        }
+    }
+};
+
+uint64_t runFloatPipeline(bool record) {
+    FloatValue value;
+    value.mon_index = -1;
+    float prec = getPrecision(VALUE_TYPE_FLOAT_VOLT);
+
+    uint64_t start = cycles();
+    for (size_t i = 0; i < g_samples.size(); ++i) {
+        float uncalibrated = util::remap((float)g_samples[i], (float)AnalogDigitalConverter::ADC_MIN, U_MIN, (float)AnalogDigitalConverter::ADC_MAX, U_MAX);
+        const Channel::CalibrationValuePointConfiguration *p1 = &g_pipelineCalConf->min;
+        const Channel::CalibrationValuePointConfiguration *p2 = &g_pipelineCalConf->max;
+        if (g_pipelineCalConf->mid.adc > g_pipelineCalConf->min.adc) {
+            if (uncalibrated < g_pipelineCalConf->mid.adc) {
+                p2 = &g_pipelineCalConf->mid;
+            } else {
+                p1 = &g_pipelineCalConf->mid;
+            }
+        }
+        value.addMonValue(util::remap(uncalibrated, p1->adc, p1->val, p2->adc, p2->val));
+        bool condition = util::greaterOrEqual(value.mon, OVP_LEVEL, prec);
+        if (record) {
+            g_floatMon[i] = value.mon;
+            g_floatCondition[i] = condition;
+        }
+    }
+    return cycles() - start;
+}
+
+uint64_t runIntegerPipeline(bool record) {
+    Channel::AdcDataConversion conversion;
+    conversion.build(U_MIN, U_MAX, 0, g_pipelineCalConf);
+    Channel::Value value;
+    value.resetMonValues();
+    int64_t threshold = util::greaterOrEqualThresholdMicro(OVP_LEVEL, getPrecision(VALUE_TYPE_FLOAT_VOLT));
+
+    uint64_t start = cycles();
+    for (size_t i = 0; i < g_samples.size(); ++i) {
+        value.addMonValue(conversion.toMicroUnits(g_samples[i]));
+        bool condition = value.mon_micro >= threshold;
+        if (record) {
+            g_intMon[i] = value.getMon();
+            g_intCondition[i] = condition;
+        }
+    }
+    return cycles() - start;
+}
+
+uint64_t best(uint64_t (*run)(bool), int numRuns) {
+    uint64_t result = run(false);
+    for (int i = 1; i < numRuns; ++i) {
+        uint64_t t = run(false);
+        if (t < result) {
+            result = t;
+        }
+    }
+    return result;
+}
+
+void runPipelines(const char *name, const Channel::CalibrationValueConfiguration &calConf) {
+    g_pipelineCalConf = &calConf;
+
+    int numSamples = (int)g_samples.size();
+    runFloatPipeline(true);
+    runIntegerPipeline(true);
+
+    float maxDiff = 0;
+    int numConditionDiffs = 0;
+    int numConditions = 0;
+    for (int i = 0; i < numSamples; ++i) {
+        float diff = fabs(g_floatMon[i] - g_intMon[i]);
+        if (diff > maxDiff) {
+            maxDiff = diff;
+        }
+        if (g_floatCondition[i] != g_intCondition[i]) {
+            ++numConditionDiffs;
+        }
+        if (g_intCondition[i]) {
+            ++numConditions;
+        }
+    }
+
+    uint64_t floatCycles = best(runFloatPipeline, 5);
+    uint64_t intCycles = best(runIntegerPipeline, 5);
+
+    printf("%s calibration:\n", name);
+    printf("  float pipeline: %.2f cycles/sample\n", (double)floatCycles / numSamples);
+    printf("  integer pipeline: %.2f cycles/sample\n", (double)intCycles / numSamples);
+    printf("  speedup: %.2fx\n", intCycles > 0 ? (double)floatCycles / intCycles : 0.0);
+    printf("  max averaged value difference: %.6f V\n", maxDiff);
+    printf("  protection condition met: %d samples, differs: %d samples\n", numConditions, numConditionDiffs);
+}
+
+}
+
+int main(int argc, char **argv) {
+    int numSamples = 1000000;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            numSamples = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: meas_bench [-n <samples>]\n");
+            return 1;
+        }
+    }
+
+    if (numSamples <= 0) {
+        fprintf(stderr, "Invalid number of samples\n");
+        return 1;
+    }
+
+    initCalibration();
+
+    bool conversionOk = checkConversion("two point", g_calConf);
+    conversionOk = checkConversion("three point", g_calConf3) && conversionOk;
+    conversionOk = checkFastTrip("two point", g_calConf) && conversionOk;
+    conversionOk = checkFastTrip("three point", g_calConf3) && conversionOk;
+
+    generateSamples(numSamples);
+
+    g_floatMon.resize(numSamples);
+    g_floatCondition.resize(numSamples);
+    g_intMon.resize(numSamples);
+    g_intCondition.resize(numSamples);
+
+    printf("samples: %d\n", numSamples);
+    runPipelines("two point", g_calConf);
+    runPipelines("three point", g_calConf3);
+
+    return conversionOk ? 0 : 1;
+}
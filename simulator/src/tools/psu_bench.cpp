@@ -0,0 +1,281 @@
+/*
+* EEZ PSU Firmware
+* Copyright (C) 2018-present, Envox d.o.o.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Headless firmware benchmark.
+//
+// Usage: eez_psu_bench [--real-time] [--eeprom <image>] [-o <result.json>] <scenario.txt>...
+//
+// Boots the firmware with the simulated chips (in virtual time mode by default),
+// replays the scenario files and reports the results as JSON. In virtual time
+// mode firmware starts from the fresh EEPROM, or from the copy of the given
+// EEPROM image (e.g. ~/.eez_psu_sim/EEPROM.state), so results don't depend on
+// the previous runs. Scenario file
+// has one item per line:
+//
+//     # comment
+//     <SCPI command>     executed through the serial port SCPI context,
+//                        e.g. SIMU:LOAD 10 to change the load model
+//     @wait <seconds>    run the main loop for the given simulated time
+//     @gui on|off        render GUI into the simulated display buffer
+//
+// Firmware output (SCPI responses, debug trace) goes to stderr.
+
+#include "psu.h"
+#include "serial_psu.h"
+#include "dlog.h"
+#include "eeprom.h"
+#include "front_panel/control.h"
+
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace eez::psu;
+
+namespace {
+
+typedef std::vector<double> Samples;
+
+/// Host clock in microseconds, independent of the simulator clock.
+double hostTime() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1E6 + ts.tv_nsec / 1E3;
+}
+
+Samples g_tickTimes;
+Samples g_criticalTickIntervals;
+Samples g_frameTimes;
+
+double g_lastCriticalTick;
+double g_frameStart;
+
+size_t g_numCommands;
+double g_commandsTime;
+
+void onCriticalTick() {
+    double now = hostTime();
+    if (g_lastCriticalTick != 0) {
+        g_criticalTickIntervals.push_back(now - g_lastCriticalTick);
+    }
+    g_lastCriticalTick = now;
+}
+
+void onFrameStart() {
+    g_frameStart = hostTime();
+}
+
+void onFrameEnd() {
+    g_frameTimes.push_back(hostTime() - g_frameStart);
+}
+
+void tick() {
+    double start = hostTime();
+    simulator::tick();
+    g_tickTimes.push_back(hostTime() - start);
+}
+
+void run(double seconds) {
+    uint64_t end = simulator::getTime() + (uint64_t)(seconds * 1E6);
+    while (simulator::getTime() < end) {
+        tick();
+    }
+}
+
+bool executeCommand(const std::string &line) {
+    if (line[0] == '@') {
+        char arg[32];
+        double seconds;
+        if (sscanf(line.c_str(), "@wait %lf", &seconds) == 1) {
+            run(seconds);
+        } else if (sscanf(line.c_str(), "@gui %31s", arg) == 1) {
+            simulator::front_panel::setHeadless(strcmp(arg, "on") == 0);
+        } else {
+            fprintf(stderr, "Unknown directive: %s\n", line.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    std::string command = line + "\n";
+    double start = hostTime();
+    scpi::input(serial::g_scpiContext, command.c_str(), command.length());
+    g_commandsTime += hostTime() - start;
+    ++g_numCommands;
+
+    // let the main loop process the command, e.g. ramp up the output
+    tick();
+
+    return true;
+}
+
+bool replay(const char *filePath) {
+    FILE *fp = fopen(filePath, "r");
+    if (!fp) {
+        fprintf(stderr, "Can't open %s\n", filePath);
+        return false;
+    }
+
+    char buffer[1024];
+    bool result = true;
+    while (result && fgets(buffer, sizeof(buffer), fp)) {
+        std::string line(buffer);
+        while (!line.empty() && (line[line.length() - 1] == '\n' || line[line.length() - 1] == '\r')) {
+            line.erase(line.length() - 1);
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        result = executeCommand(line);
+    }
+
+    fclose(fp);
+    return result;
+}
+
+double percentile(const Samples &sorted, double p) {
+    size_t i = (size_t)(p / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[i];
+}
+
+/// Writes count, mean, standard deviation, percentiles and max in microseconds.
+void writeDistribution(FILE *fp, const char *name, Samples &samples, bool last = false) {
+    fprintf(fp, "  \"%s\": {\"count\": %lu", name, (unsigned long)samples.size());
+
+    if (!samples.empty()) {
+        std::sort(samples.begin(), samples.end());
+
+        double sum = 0;
+        for (size_t i = 0; i < samples.size(); ++i) {
+            sum += samples[i];
+        }
+        double mean = sum / samples.size();
+
+        double variance = 0;
+        for (size_t i = 0; i < samples.size(); ++i) {
+            variance += (samples[i] - mean) * (samples[i] - mean);
+        }
+        variance /= samples.size();
+
+        fprintf(fp, ", \"mean_us\": %.2f, \"stddev_us\": %.2f, \"p50_us\": %.2f, \"p90_us\": %.2f, \"p99_us\": %.2f, \"max_us\": %.2f",
+            mean, sqrt(variance),
+            percentile(samples, 50), percentile(samples, 90), percentile(samples, 99),
+            samples[samples.size() - 1]);
+    }
+
+    fprintf(fp, "}%s\n", last ? "" : ",");
+}
+
+void usage() {
+    fprintf(stderr, "Usage: eez_psu_bench [--real-time] [--eeprom <image>] [-o <result.json>] <scenario.txt>...\n");
+}
+
+}
+
+int main(int argc, char **argv) {
+    bool realTime = false;
+    const char *eepromImageFilePath = 0;
+    const char *outputFilePath = 0;
+    std::vector<const char *> scenarios;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--real-time") == 0) {
+            realTime = true;
+        } else if (strcmp(argv[i], "--eeprom") == 0 && i + 1 < argc) {
+            eepromImageFilePath = argv[++i];
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            outputFilePath = argv[++i];
+        } else if (argv[i][0] == '-') {
+            usage();
+            return 1;
+        } else {
+            scenarios.push_back(argv[i]);
+        }
+    }
+
+    if (scenarios.empty()) {
+        usage();
+        return 1;
+    }
+
+    // keep stdout for the JSON result only
+    fflush(stdout);
+    FILE *out = outputFilePath ? fopen(outputFilePath, "w") : fdopen(dup(1), "w");
+    if (!out) {
+        fprintf(stderr, "Can't open %s\n", outputFilePath);
+        return 1;
+    }
+    dup2(2, 1);
+
+    simulator::init();
+    if (!realTime || eepromImageFilePath) {
+        if (!simulator::useVolatileState(eepromImageFilePath)) {
+            fprintf(stderr, "Can't read EEPROM image %s\n", eepromImageFilePath);
+            return 1;
+        }
+    }
+    if (!realTime) {
+        simulator::setTimeMode(simulator::TIME_MODE_VIRTUAL);
+    }
+    boot();
+
+    simulator::g_onCriticalTick = onCriticalTick;
+    simulator::g_onFrameStart = onFrameStart;
+    simulator::g_onFrameEnd = onFrameEnd;
+
+    uint64_t simulatedStart = simulator::getTime();
+    uint32_t dlogRowsStart = dlog::getTotalNumRows();
+    double start = hostTime();
+
+    bool result = true;
+    for (size_t i = 0; result && i < scenarios.size(); ++i) {
+        result = replay(scenarios[i]);
+    }
+
+    double elapsed = (hostTime() - start) / 1E6;
+    double simulated = (simulator::getTime() - simulatedStart) / 1E6;
+    uint32_t dlogRows = dlog::getTotalNumRows() - dlogRowsStart;
+
+    simulator::g_onCriticalTick = 0;
+    simulator::g_onFrameStart = 0;
+    simulator::g_onFrameEnd = 0;
+
+    eeprom::flush();
+
+    if (!result) {
+        return 1;
+    }
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"time_mode\": \"%s\",\n", realTime ? "real" : "virtual");
+    fprintf(out, "  \"host_time_s\": %.3f,\n", elapsed);
+    fprintf(out, "  \"simulated_time_s\": %.3f,\n", simulated);
+    writeDistribution(out, "tick", g_tickTimes);
+    writeDistribution(out, "critical_tick_interval", g_criticalTickIntervals);
+    writeDistribution(out, "frame", g_frameTimes);
+    fprintf(out, "  \"scpi_commands\": %lu,\n", (unsigned long)g_numCommands);
+    fprintf(out, "  \"scpi_commands_per_sec\": %.1f,\n", g_commandsTime > 0 ? g_numCommands / (g_commandsTime / 1E6) : 0.0);
+    fprintf(out, "  \"dlog_samples\": %lu,\n", (unsigned long)dlogRows);
+    fprintf(out, "  \"dlog_samples_per_sec\": %.1f\n", elapsed > 0 ? dlogRows / elapsed : 0.0);
+    fprintf(out, "}\n");
+    fclose(out);
+
+    return 0;
+}
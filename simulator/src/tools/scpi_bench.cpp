@@ -0,0 +1,178 @@
+/*
+* EEZ PSU Firmware
+* Copyright (C) 2018-present, Envox d.o.o.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// SCPI command dispatch benchmark.
+//
+// Usage: scpi_bench [-n <iterations>] <session.txt>
+//
+// Replays recorded SCPI session (one command per line) through SCPI_Input,
+// using the PSU command list with callbacks which only consume the parameters,
+// and reports commands/sec with the linear search and with the command index.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+
+#include <scpi/scpi.h>
+
+#include "scpi_commands.h"
+
+namespace {
+
+std::vector<const scpi_command_t *> g_dispatched;
+bool g_record;
+
+scpi_result_t benchCallback(scpi_t *context) {
+    if (g_record) {
+        g_dispatched.push_back(context->param_list.cmd);
+    }
+
+    scpi_parameter_t param;
+    while (SCPI_Parameter(context, &param, FALSE)) {
+    }
+
+    return SCPI_RES_OK;
+}
+
+#define SCPI_COMMAND(P, C) { P, benchCallback },
+const scpi_command_t g_commands[] = {
+    SCPI_COMMANDS
+    SCPI_CMD_LIST_END
+};
+#undef SCPI_COMMAND
+
+size_t benchWrite(scpi_t *context, const char *data, size_t len) {
+    return len;
+}
+
+int benchError(scpi_t *context, int_fast16_t err) {
+    return 0;
+}
+
+scpi_result_t benchFlush(scpi_t *context) {
+    return SCPI_RES_OK;
+}
+
+scpi_interface_t g_interface = {
+    benchError,
+    benchWrite,
+    NULL,
+    benchFlush,
+    NULL,
+};
+
+const scpi_unit_def_t g_units[] = {
+    SCPI_UNITS_LIST_END
+};
+
+char g_inputBuffer[1024];
+int16_t g_errorQueue[32];
+
+double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+double run(scpi_t &context, const std::vector<std::string> &session, int iterations) {
+    double start = now();
+    for (int i = 0; i < iterations; ++i) {
+        for (size_t j = 0; j < session.size(); ++j) {
+            SCPI_Input(&context, session[j].c_str(), (int)session[j].size());
+        }
+    }
+    return now() - start;
+}
+
+}
+
+int main(int argc, char **argv) {
+    int iterations = 2000;
+    const char *filePath = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+        } else {
+            filePath = argv[i];
+        }
+    }
+
+    if (!filePath || iterations <= 0) {
+        fprintf(stderr, "Usage: scpi_bench [-n <iterations>] <session.txt>\n");
+        return 1;
+    }
+
+    FILE *fp = fopen(filePath, "rt");
+    if (!fp) {
+        fprintf(stderr, "Can't open %s\n", filePath);
+        return 1;
+    }
+
+    std::vector<std::string> session;
+    char line[1024];
+    while (fgets(line, sizeof(line) - 2, fp)) {
+        size_t n = strcspn(line, "\r\n");
+        if (n > 0) {
+            line[n] = 0;
+            session.push_back(std::string(line) + "\r\n");
+        }
+    }
+    fclose(fp);
+
+    scpi_t context;
+    SCPI_Init(&context, g_commands, &g_interface, g_units, "EEZ", "PSU", "0", "bench",
+        g_inputBuffer, sizeof(g_inputBuffer), g_errorQueue, sizeof(g_errorQueue) / sizeof(int16_t));
+
+    // both searches must dispatch every command of the session to the same command
+    std::vector<const scpi_command_t *> indexed;
+    g_record = true;
+    run(context, session, 1);
+    indexed.swap(g_dispatched);
+
+#if USE_COMMAND_INDEX
+    const scpi_command_index_t *index = context.cmd_index;
+    if (!index) {
+        fprintf(stderr, "Command index not built\n");
+    }
+    context.cmd_index = NULL;
+#endif
+
+    run(context, session, 1);
+    g_record = false;
+    if (g_dispatched != indexed) {
+        fprintf(stderr, "Command index dispatch mismatch!\n");
+        return 1;
+    }
+
+    unsigned numCommands = (unsigned)session.size() * iterations;
+
+    double linearTime = run(context, session, iterations);
+    printf("linear search: %u commands in %.3f s, %.0f commands/sec\n", numCommands, linearTime, numCommands / linearTime);
+
+#if USE_COMMAND_INDEX
+    context.cmd_index = index;
+    double indexTime = run(context, session, iterations);
+    printf("command index: %u commands in %.3f s, %.0f commands/sec\n", numCommands, indexTime, numCommands / indexTime);
+#endif
+
+    return 0;
+}
@@ -0,0 +1,207 @@
+/*
+* EEZ PSU Firmware
+* Copyright (C) 2018-present, Envox d.o.o.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// SCPI over Ethernet throughput benchmark.
+//
+// Usage: scpi_throughput [-h <host>] [-p <port>] [-n <iterations>] <query>
+//
+// Sends the query to the simulator (or the real instrument) n times, waits for
+// each response (line terminated or definite length arbitrary block, e.g. from
+// MMEMory:UPLoad?) and reports responses/sec, bytes/sec and the average number
+// of the TCP segments (recv calls) per response.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+namespace {
+
+int g_socket = -1;
+char g_buffer[64 * 1024];
+size_t g_bufferLength;
+unsigned long g_numRecvCalls;
+
+double now() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1E9;
+}
+
+bool connectTo(const char *host, const char *port) {
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo *result;
+    if (getaddrinfo(host, port, &hints, &result) != 0) {
+        return false;
+    }
+
+    g_socket = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+    if (g_socket == -1 || connect(g_socket, result->ai_addr, result->ai_addrlen) != 0) {
+        freeaddrinfo(result);
+        return false;
+    }
+
+    freeaddrinfo(result);
+
+    int flag = 1;
+    setsockopt(g_socket, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+
+    return true;
+}
+
+bool receiveMore() {
+    if (g_bufferLength == sizeof(g_buffer)) {
+        fprintf(stderr, "Response too long\n");
+        return false;
+    }
+
+    ssize_t n = recv(g_socket, g_buffer + g_bufferLength, sizeof(g_buffer) - g_bufferLength, 0);
+    if (n <= 0) {
+        fprintf(stderr, "Connection closed\n");
+        return false;
+    }
+
+    g_bufferLength += n;
+    ++g_numRecvCalls;
+
+    return true;
+}
+
+/// Returns the length of the complete response at the beginning of the buffer or 0.
+size_t responseLength() {
+    size_t headerLength = 0;
+    size_t blockLength = 0;
+
+    if (g_bufferLength >= 2 && g_buffer[0] == '#') {
+        int numDigits = g_buffer[1] - '0';
+        if (numDigits < 1 || numDigits > 9) {
+            return 0;
+        }
+        if (g_bufferLength < 2 + (size_t)numDigits) {
+            return 0;
+        }
+        for (int i = 0; i < numDigits; ++i) {
+            blockLength = blockLength * 10 + (g_buffer[2 + i] - '0');
+        }
+        headerLength = 2 + numDigits;
+    }
+
+    for (size_t i = headerLength + blockLength; i < g_bufferLength; ++i) {
+        if (g_buffer[i] == '\n') {
+            return i + 1;
+        }
+    }
+
+    return 0;
+}
+
+bool query(const char *command, size_t &responseSize) {
+    if (send(g_socket, command, strlen(command), 0) <= 0) {
+        fprintf(stderr, "Send failed\n");
+        return false;
+    }
+
+    size_t length;
+    while ((length = responseLength()) == 0) {
+        if (!receiveMore()) {
+            return false;
+        }
+    }
+
+    if (strncmp(g_buffer, "**ERROR", 7) == 0) {
+        fprintf(stderr, "%.*s", (int)length, g_buffer);
+        return false;
+    }
+
+    responseSize = length;
+
+    memmove(g_buffer, g_buffer + length, g_bufferLength - length);
+    g_bufferLength -= length;
+
+    return true;
+}
+
+void usage() {
+    fprintf(stderr, "Usage: scpi_throughput [-h <host>] [-p <port>] [-n <iterations>] <query>\n");
+}
+
+}
+
+int main(int argc, char **argv) {
+    const char *host = "localhost";
+    const char *port = "5025";
+    int numIterations = 100;
+
+    int i;
+    for (i = 1; i < argc - 1 && argv[i][0] == '-'; i += 2) {
+        if (strcmp(argv[i], "-h") == 0) {
+            host = argv[i + 1];
+        } else if (strcmp(argv[i], "-p") == 0) {
+            port = argv[i + 1];
+        } else if (strcmp(argv[i], "-n") == 0) {
+            numIterations = atoi(argv[i + 1]);
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    if (i != argc - 1 || numIterations <= 0) {
+        usage();
+        return 1;
+    }
+
+    char command[256];
+    snprintf(command, sizeof(command), "%s\n", argv[i]);
+
+    if (!connectTo(host, port)) {
+        fprintf(stderr, "Can't connect to %s:%s\n", host, port);
+        return 1;
+    }
+
+    size_t totalSize = 0;
+    double start = now();
+
+    for (int j = 0; j < numIterations; ++j) {
+        size_t responseSize;
+        if (!query(command, responseSize)) {
+            close(g_socket);
+            return 1;
+        }
+        totalSize += responseSize;
+    }
+
+    double elapsed = now() - start;
+
+    close(g_socket);
+
+    printf("%d responses, %lu bytes in %.3f s\n", numIterations, (unsigned long)totalSize, elapsed);
+    printf("%.1f responses/s, %.0f bytes/s, %.1f segments/response\n",
+        numIterations / elapsed, totalSize / elapsed, (double)g_numRecvCalls / numIterations);
+
+    return 0;
+}